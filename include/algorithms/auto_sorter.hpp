@@ -0,0 +1,128 @@
+//
+// Picks a sorter per call from a cheap sample of the input ("-a auto").
+//
+
+#ifndef AUTO_SORTER_HPP
+#define AUTO_SORTER_HPP
+
+#include <sorter.hpp>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+
+/**
+ * @brief What AutoSorter learned about an input before choosing a sorter.
+ *
+ * Everything but rows comes from samples of at most AutoSorter::SAMPLE_SIZE rows or
+ * pairs, taken with the same comparator the sort will use.
+ */
+struct InputProfile {
+    size_t rows = 0;
+
+    // Presortedness: neighbours (i, i + 1) at evenly spaced positions.
+    size_t sampled_pairs = 0;
+    double ascending_pairs = 0.0;  // fraction with a <= b
+    double descending_pairs = 0.0; // fraction with a >= b
+
+    // Pairs (i < j) at random positions that are out of order: 0 sorted, ~0.5 random, 1 reversed.
+    double inversions = 0.0;
+
+    // Key cardinality: distinct keys among evenly spaced rows.
+    size_t sampled_rows = 0;
+    size_t distinct_keys = 0;
+
+    // Shape of the key, from the request rather than the data.
+    bool radix_key = false;     // RadixSorter sorts it on integer keys (no comparison fallback)
+    bool single_string = false; // name or country alone (MultikeySorter's case)
+    bool opaque = false;        // a plain Comparator: nothing is known about the key
+};
+
+/**
+ * @brief The sorter chosen for one call, and why.
+ */
+struct AutoDecision {
+    std::string algorithm;   // SorterFactory name of the delegate that runs
+    unsigned int threads = 1;
+    std::string reason;
+    InputProfile profile;
+
+    // One line for logs: "radix (integer key); rows=... ascending=... ...".
+    [[nodiscard]] std::string describe() const;
+};
+
+/**
+ * @brief Sorter that samples its input and hands it to the registered sorter that is
+ *        fastest for that kind of input.
+ *
+ * Each call profiles the input (see InputProfile) with about 3 * SAMPLE_SIZE
+ * comparisons, then applies these rules in order. They were read off the perf-mode
+ * timings of every sorter on the 44k-row dataset:
+ *
+ * 1. At most SMALL_INPUT rows: insertion.
+ * 2. Nearly sorted or nearly reversed (PRESORTED_FRACTION of the neighbours in order,
+ *    and the inversions agreeing): tim in index mode, which finds the runs in about n
+ *    comparisons. For Cities, quick (pdqsort on the rows themselves): it detects the
+ *    runs without moving a row, where the sorters that pack keys first still pay for
+ *    packing and for applying the permutation.
+ * 3. A key radix sorts exactly (numeric columns, and lists whose string fields are
+ *    interned countries): radix. With few distinct values (at most 1 in
+ *    LOW_CARDINALITY_DIVISOR of the sample) quick instead: its partitions gather every
+ *    run of equal keys in one pass, where radix still makes a pass per varying byte.
+ * 4. Several threads and at least SampleSorter::SEQUENTIAL_THRESHOLD rows: samplesort.
+ * 5. A lone name/country column with few distinct values: multikey, which settles
+ *    long runs of equal strings one byte at a time.
+ * 6. Otherwise blockquick, or quick for a plain comparator.
+ *
+ * The last choice is kept for logging (lastDecision()).
+ */
+class AutoSorter : public Sorter {
+public:
+    static constexpr size_t SAMPLE_SIZE = 1024;
+    static constexpr size_t SMALL_INPUT = 32;
+    static constexpr double PRESORTED_FRACTION = 0.98;
+    static constexpr size_t LOW_CARDINALITY_DIVISOR = 16;
+
+    // Default: one thread per hardware thread, like the parallel sorters.
+    AutoSorter();
+
+    void sort(std::vector<City>& cities, Comparator compare) override;
+    Permutation sortIndices(const std::vector<City>& cities, Comparator compare) override;
+    void sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) override;
+    Permutation sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) override;
+    void sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override;
+    Permutation sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override;
+    [[nodiscard]] std::string getName() const override;
+    void setThreadCount(unsigned int thread_count) override;
+
+    /**
+     * @brief The decision made by the most recent sort call (empty algorithm before the first).
+     */
+    [[nodiscard]] const AutoDecision& lastDecision() const;
+
+    /**
+     * @brief Samples `cities` under a composite key.
+     */
+    static InputProfile profileInput(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order);
+
+    /**
+     * @brief Samples `cities` under an arbitrary comparator (opaque key).
+     */
+    static InputProfile profileInput(const std::vector<City>& cities, const Comparator& compare);
+
+    /**
+     * @brief Applies the selection rules to a profile.
+     * @param index_mode The call sorts row indices rather than Cities.
+     * @param thread_count Threads the delegate may use.
+     */
+    static AutoDecision decide(const InputProfile& profile, bool index_mode, unsigned int thread_count);
+
+private:
+    // Records the decision and returns its delegate, configured with the decided thread count.
+    std::unique_ptr<Sorter> choose(const InputProfile& profile, bool index_mode);
+
+    unsigned int thread_count_;
+    AutoDecision last_decision_;
+};
+
+#endif // AUTO_SORTER_HPP
@@ -0,0 +1,32 @@
+//
+// QuickSorter with the branch-free block partition forced on for every key.
+//
+
+#ifndef BLOCK_QUICK_SORTER_HPP
+#define BLOCK_QUICK_SORTER_HPP
+
+#include <key_dispatch_sorter.hpp>
+#include <algorithms/quick_sorter.hpp>
+#include <vector>
+#include <string>
+
+/**
+ * @brief QuickSorter that always partitions with BlockQuicksort.
+ *
+ * QuickSorter already picks the block partition for numeric keys; this sorter
+ * uses it for string keys and plain comparators too, so both partition kernels
+ * can be benchmarked against each other on any key.
+ */
+class BlockQuickSorter : public KeyDispatchSorter<BlockQuickSorter> {
+public:
+    static constexpr bool packed_numeric_keys = QuickSorter::packed_numeric_keys;
+
+    [[nodiscard]] std::string getName() const override;
+
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare) {
+        QuickSorter::sortRangeWith<true>(items, compare);
+    }
+};
+
+#endif // BLOCK_QUICK_SORTER_HPP
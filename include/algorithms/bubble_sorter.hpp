@@ -5,15 +5,41 @@
 #ifndef BUBBLE_SORTER_HPP
 #define BUBBLE_SORTER_HPP
 
-#include <sorter.hpp> // Include the base class Sorter interface
+#include <key_dispatch_sorter.hpp> // Include the base class Sorter interface
 #include <vector>
 #include <string>
+#include <utility>
 
-class BubbleSorter : public Sorter {
+class BubbleSorter : public KeyDispatchSorter<BubbleSorter> {
 public:
-    void sort(std::vector<City>& cities, Comparator compare) override;
-
     [[nodiscard]] std::string getName() const override;
+    [[nodiscard]] bool isStable() const override;
+
+    // Generic bubble sort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare);
 };
 
+template <typename T, typename Compare>
+void BubbleSorter::sortRange(std::vector<T>& items, Compare& compare) {
+    if (items.size() < 2) {
+        return; // Already sorted
+    }
+
+    size_t n = items.size();
+    bool swapped;
+    for (size_t i = 0; i < n - 1; ++i) {
+        swapped = false;
+        for (size_t j = 0; j < n - 1 - i; ++j) {
+            if (compare(items[j + 1], items[j])) {
+                std::swap(items[j], items[j + 1]);
+                swapped = true;
+            }
+        }
+        if (!swapped) {
+            break;
+        }
+    }
+}
+
 #endif // BUBBLE_SORTER_HPP
@@ -5,19 +5,75 @@
 #ifndef HEAP_SORTER_HPP
 #define HEAP_SORTER_HPP
 
-#include <sorter.hpp>
+#include <key_dispatch_sorter.hpp>
 #include <vector>
 #include <string>
+#include <utility> // For std::swap
 
-class HeapSorter : public Sorter {
+class HeapSorter : public KeyDispatchSorter<HeapSorter> {
 public:
-    void sort(std::vector<City>& cities, Comparator compare) override;
     [[nodiscard]] std::string getName() const override;
 
+    // Generic heapsort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare);
+
 private:
-    // To heapify a subtree rooted with node i which is an index in cities[].
+    // To heapify a subtree rooted with node i which is an index in items[].
     // n is size of heap. compare defines the heap property (max-heap if compare(a,b) means a<b).
-    void heapify(std::vector<City>& cities, size_t n, size_t i, Comparator& compare);
+    template <typename T, typename Compare>
+    static void heapify(std::vector<T>& items, size_t n, size_t i, Compare& compare);
 };
 
+// To heapify a subtree rooted with node i.
+// Assumes compare(a, b) means a < b for standard max-heap behavior.
+template <typename T, typename Compare>
+void HeapSorter::heapify(std::vector<T>& items, size_t n, size_t i, Compare& compare) {
+    size_t largest = i; // Initialize largest as root
+    size_t left = 2 * i + 1; // left child
+    size_t right = 2 * i + 2; // right child
+
+    // If left child is larger than root (using inverted compare for max-heap)
+    // compare(items[largest], items[left]) means largest < left
+    if (left < n && compare(items[largest], items[left])) {
+        largest = left;
+    }
+
+    // If right child is larger than largest so far
+    // compare(items[largest], items[right]) means largest < right
+    if (right < n && compare(items[largest], items[right])) {
+        largest = right;
+    }
+
+    // If largest is not root
+    if (largest != i) {
+        std::swap(items[i], items[largest]);
+
+        // Recursively heapify the affected sub-tree
+        heapify(items, n, largest, compare);
+    }
+}
+
+template <typename T, typename Compare>
+void HeapSorter::sortRange(std::vector<T>& items, Compare& compare) {
+    size_t n = items.size();
+    if (n < 2) {
+        return;
+    }
+
+    // Build heap (rearrange array) - starting from the last non-leaf node
+    for (long long i = static_cast<long long>(n / 2) - 1; i >= 0; --i) {
+        heapify(items, n, static_cast<size_t>(i), compare);
+    }
+
+    // One by one extract an element from heap
+    for (long long i = static_cast<long long>(n) - 1; i > 0; --i) {
+        // Move current root to end
+        std::swap(items[0], items[static_cast<size_t>(i)]);
+
+        // call max heapify on the reduced heap
+        heapify(items, static_cast<size_t>(i), 0, compare);
+    }
+}
+
 #endif // HEAP_SORTER_HPP
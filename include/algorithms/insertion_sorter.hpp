@@ -5,14 +5,36 @@
 #ifndef INSERTION_SORTER_HPP
 #define INSERTION_SORTER_HPP
 
-#include <sorter.hpp>
+#include <key_dispatch_sorter.hpp>
 #include <vector>
 #include <string>
+#include <utility> // For std::move
 
-class InsertionSorter : public Sorter {
+class InsertionSorter : public KeyDispatchSorter<InsertionSorter> {
 public:
-    void sort(std::vector<City>& cities, Comparator compare) override;
     [[nodiscard]] std::string getName() const override;
+    [[nodiscard]] bool isStable() const override;
+
+    // Generic insertion sort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare);
 };
 
+template <typename T, typename Compare>
+void InsertionSorter::sortRange(std::vector<T>& items, Compare& compare) {
+    if (items.size() < 2) {
+        return;
+    }
+
+    for (size_t i = 1; i < items.size(); ++i) {
+        T key = std::move(items[i]); // Use move for potential efficiency
+        long long j = static_cast<long long>(i) - 1; // Use signed type for comparison with -1
+        while (j >= 0 && compare(key, items[j])) {
+            items[j + 1] = std::move(items[j]); // Use move
+            j = j - 1;
+        }
+        items[j + 1] = std::move(key); // Use move
+    }
+}
+
 #endif // INSERTION_SORTER_HPP
@@ -5,21 +5,104 @@
 #ifndef MERGE_SORTER_HPP
 #define MERGE_SORTER_HPP
 
-#include <sorter.hpp>
+#include <key_dispatch_sorter.hpp>
+#include <sorting_network.hpp>
 #include <vector>
 #include <string>
+#include <utility> // For std::move
 
-class MergeSorter : public Sorter {
+/**
+ * @brief Stable top-down merge sort.
+ *
+ * On packed records (see uses_sorting_network_v) ranges of up to SORTING_NETWORK_SIZE
+ * are sorted by a sorting network instead of being split further. The network orders
+ * ties by row index, which is the records' input position, so the sort stays stable;
+ * numeric keys are packed into such records for this, like string keys.
+ */
+class MergeSorter : public KeyDispatchSorter<MergeSorter> {
 public:
-    void sort(std::vector<City>& cities, Comparator compare) override;
+    // Sort population/lat/lng through packed records (see packs_numeric_keys).
+    static constexpr bool packed_numeric_keys = true;
+
     [[nodiscard]] std::string getName() const override;
+    [[nodiscard]] bool isStable() const override;
+
+    // Generic merge sort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare);
 
 private:
     // Helper recursive function
-    void mergeSortRecursive(std::vector<City>& cities, std::vector<City>& temp, size_t left, size_t right, Comparator& compare);
+    template <typename T, typename Compare>
+    static void mergeSortRecursive(std::vector<T>& items, std::vector<T>& temp, size_t left, size_t right, Compare& compare);
 
     // Helper merge function
-    static void merge(std::vector<City>& cities, std::vector<City>& temp, size_t left, size_t mid, size_t right, Comparator& compare);
+    template <typename T, typename Compare>
+    static void merge(std::vector<T>& items, std::vector<T>& temp, size_t left, size_t mid, size_t right, Compare& compare);
 };
 
+template <typename T, typename Compare>
+void MergeSorter::sortRange(std::vector<T>& items, Compare& compare) {
+    if (items.size() < 2) {
+        return;
+    }
+    std::vector<T> temp(items.size()); // Allocate temporary space once
+    mergeSortRecursive(items, temp, 0, items.size() - 1, compare);
+}
+
+template <typename T, typename Compare>
+void MergeSorter::mergeSortRecursive(std::vector<T>& items, std::vector<T>& temp, size_t left, size_t right, Compare& compare) {
+    if (left >= right) {
+        return; // Base case: 0 or 1 element
+    }
+    if constexpr (uses_sorting_network_v<T, Compare>) {
+        if (right - left < SORTING_NETWORK_SIZE) {
+            sortSmallPackedRows(items.data() + left, right - left + 1);
+            return;
+        }
+    }
+
+    size_t mid = left + (right - left) / 2; // Avoid potential overflow
+    mergeSortRecursive(items, temp, left, mid, compare);
+    mergeSortRecursive(items, temp, mid + 1, right, compare);
+    merge(items, temp, left, mid, right, compare);
+}
+
+template <typename T, typename Compare>
+void MergeSorter::merge(std::vector<T>& items, std::vector<T>& temp, size_t left, size_t mid, size_t right, Compare& compare) {
+    size_t i = left;     // Pointer for the first part (left to mid) of original array
+    size_t j = mid + 1;  // Pointer for the second part (mid+1 to right) of original array
+    size_t k = left;     // Pointer for the temp array
+
+    // While there are elements in both subarrays
+    while (i <= mid && j <= right) {
+        // To maintain stability:
+        // If element from left subarray is less than OR EQUAL to element from right subarray,
+        // pick from the left.
+        // 'compare(a, b)' means 'a < b'.
+        // So, 'items[i] <= items[j]' is equivalent to '!compare(items[j], items[i])'
+        // (It's NOT the case that items[j] is strictly less than items[i]).
+        if (!compare(items[j], items[i])) { // If items[i] <= items[j]
+            temp[k++] = std::move(items[i++]);
+        } else { // items[j] < items[i]
+            temp[k++] = std::move(items[j++]);
+        }
+    }
+
+    // Copy any remaining elements from the left subarray
+    while (i <= mid) {
+        temp[k++] = std::move(items[i++]);
+    }
+
+    // Copy any remaining elements from the right subarray
+    while (j <= right) {
+        temp[k++] = std::move(items[j++]);
+    }
+
+    // Copy the sorted subarray from temp back to items
+    for (size_t p = left; p <= right; ++p) {
+        items[p] = std::move(temp[p]);
+    }
+}
+
 #endif // MERGE_SORTER_HPP
@@ -0,0 +1,51 @@
+//
+// Multikey (three-way radix) quicksort for the string City keys (name, country).
+//
+
+#ifndef MULTIKEY_SORTER_HPP
+#define MULTIKEY_SORTER_HPP
+
+#include <sorter.hpp>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+/**
+ * @brief Bentley-Sedgewick multikey quicksort keyed directly on name or country.
+ *
+ * Partitions on one byte position at a time into <, = and > the pivot byte; only
+ * the "=" part advances to the next byte, so a shared prefix is examined once per
+ * partitioning level instead of once per comparison. Buckets smaller than
+ * INSERTION_CUTOFF are finished with an insertion sort that compares from the
+ * current depth. The sort is not stable.
+ *
+ * Numeric keys, composite keys and plain comparator calls (sort/sortIndices) fall
+ * back to std::sort.
+ */
+class MultikeySorter : public Sorter {
+public:
+    static constexpr size_t INSERTION_CUTOFF = 16;
+
+    void sort(std::vector<City>& cities, Comparator compare) override;
+    Permutation sortIndices(const std::vector<City>& cities, Comparator compare) override;
+    void sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) override;
+    Permutation sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) override;
+    void sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override;
+    Permutation sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override;
+    [[nodiscard]] std::string getName() const override;
+
+private:
+    struct StringRef {
+        std::string_view text;
+        std::uint32_t index;
+    };
+
+    // Sorts the string column of `cities` and returns the row order.
+    static Permutation sortStrings(const std::vector<City>& cities, SortKey key, bool reverse_order);
+
+    static void multikeySort(StringRef* items, size_t count, size_t depth);
+    static void insertionSort(StringRef* items, size_t count, size_t depth);
+};
+
+#endif // MULTIKEY_SORTER_HPP
@@ -0,0 +1,188 @@
+//
+// Stable parallel merge sort on a work-stealing thread pool.
+//
+
+#ifndef PARALLEL_MERGE_SORTER_HPP
+#define PARALLEL_MERGE_SORTER_HPP
+
+#include <key_dispatch_sorter.hpp>
+#include <thread_pool.hpp>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief Stable merge sort that forks both recursion and merging onto a ThreadPool.
+ *
+ * - Recursion: halves larger than the leaf size are forked as tasks; leaves are
+ *   sorted with std::stable_sort. Levels alternate between the input and one
+ *   scratch buffer, so no level copies its result back.
+ * - Merging: a merge larger than PARALLEL_MERGE_CUTOFF is cut into one piece per
+ *   thread along the merge path. A co-rank binary search finds, for an output
+ *   position, how many elements come from each input, and each piece is merged
+ *   independently. Even the top-level merge therefore runs on every thread.
+ * - Stability: on ties the left input wins, both in merges and in co-ranks.
+ *
+ * With one thread it degrades to std::stable_sort.
+ * The pool is created on the first parallel sort and reused by later ones (an
+ * ExternalSorter sorts one chunk per call); setThreadCount() discards it.
+ */
+class ParallelMergeSorter : public KeyDispatchSorter<ParallelMergeSorter> {
+public:
+    static constexpr size_t MIN_LEAF_SIZE = 4096;
+    static constexpr size_t PARALLEL_MERGE_CUTOFF = 16384;
+
+    // Default: one thread per hardware thread.
+    ParallelMergeSorter();
+
+    [[nodiscard]] std::string getName() const override;
+    [[nodiscard]] bool isStable() const override;
+    void setThreadCount(unsigned int thread_count) override;
+    [[nodiscard]] unsigned int getThreadCount() const;
+
+    // Generic parallel merge sort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    void sortRange(std::vector<T>& items, Compare& compare) const;
+
+    /**
+     * @brief Co-rank: the number of elements taken from `left` among the first `k`
+     *        outputs of the stable merge of left[0, left_size) and right[0, right_size).
+     */
+    template <typename T, typename Compare>
+    static size_t coRank(size_t k, const T* left, size_t left_size, const T* right, size_t right_size, Compare& compare);
+
+private:
+    unsigned int thread_count_;
+    mutable std::mutex pool_mutex_;
+    mutable std::unique_ptr<ThreadPool> pool_;
+
+    // The shared pool, started with thread_count_ threads on first use.
+    ThreadPool& pool() const;
+
+    // Sorts source[begin, end); the result ends up in `target` if into_target, else in `source`.
+    template <typename T, typename Compare>
+    static void sortTask(ThreadPool& pool, T* source, T* target, size_t begin, size_t end, bool into_target,
+                         size_t leaf_size, Compare& compare);
+
+    // Stable merge of from[begin, mid) and from[mid, end) into to[begin, end).
+    template <typename T, typename Compare>
+    static void parallelMerge(ThreadPool& pool, T* from, T* to, size_t begin, size_t mid, size_t end, Compare& compare);
+
+    template <typename T, typename Compare>
+    static void sequentialMerge(T* left, T* left_end, T* right, T* right_end, T* out, Compare& compare);
+};
+
+template <typename T, typename Compare>
+void ParallelMergeSorter::sortRange(std::vector<T>& items, Compare& compare) const {
+    const size_t n = items.size();
+    auto less = [&compare](const T& a, const T& b) { return compare(a, b); };
+    if (this->thread_count_ <= 1 || n <= MIN_LEAF_SIZE) {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    // Leaves: a few per thread so that stealing can even out uneven progress.
+    const size_t leaf_size = std::max(MIN_LEAF_SIZE, n / (static_cast<size_t>(this->thread_count_) * 4));
+    std::vector<T> scratch(n);
+    ThreadPool& pool = this->pool();
+    sortTask(pool, items.data(), scratch.data(), 0, n, false, leaf_size, compare);
+}
+
+template <typename T, typename Compare>
+void ParallelMergeSorter::sortTask(ThreadPool& pool, T* source, T* target, size_t begin, size_t end, bool into_target,
+                                   size_t leaf_size, Compare& compare) {
+    if (end - begin <= leaf_size) {
+        std::stable_sort(source + begin, source + end, [&compare](const T& a, const T& b) { return compare(a, b); });
+        if (into_target) {
+            std::move(source + begin, source + end, target + begin);
+        }
+        return;
+    }
+
+    // The halves land in the other buffer, and the merge brings them back here.
+    const size_t mid = begin + (end - begin) / 2;
+    {
+        TaskGroup group(pool);
+        group.run([&] { sortTask(pool, source, target, begin, mid, !into_target, leaf_size, compare); });
+        sortTask(pool, source, target, mid, end, !into_target, leaf_size, compare);
+        group.wait();
+    }
+    if (into_target) {
+        parallelMerge(pool, source, target, begin, mid, end, compare);
+    } else {
+        parallelMerge(pool, target, source, begin, mid, end, compare);
+    }
+}
+
+template <typename T, typename Compare>
+void ParallelMergeSorter::parallelMerge(ThreadPool& pool, T* from, T* to, size_t begin, size_t mid, size_t end, Compare& compare) {
+    const size_t total = end - begin;
+    const size_t pieces = std::min<size_t>(pool.threadCount(), total / (PARALLEL_MERGE_CUTOFF / 2) + 1);
+    if (pieces <= 1) {
+        sequentialMerge(from + begin, from + mid, from + mid, from + end, to + begin, compare);
+        return;
+    }
+
+    const T* left = from + begin;
+    const T* right = from + mid;
+    const size_t left_size = mid - begin;
+    const size_t right_size = end - mid;
+
+    // Split points are found before any piece starts: merging moves elements out of `from`,
+    // and a co-rank search running next to it could otherwise read a moved-from element.
+    std::vector<size_t> left_splits(pieces + 1);
+    for (size_t piece = 0; piece <= pieces; ++piece) {
+        left_splits[piece] = coRank(total * piece / pieces, left, left_size, right, right_size, compare);
+    }
+
+    TaskGroup group(pool);
+    for (size_t piece = 0; piece < pieces; ++piece) {
+        // Output slice [k0, k1) of the merged range, and where it starts in each input.
+        const size_t k0 = total * piece / pieces;
+        const size_t k1 = total * (piece + 1) / pieces;
+        const size_t i0 = left_splits[piece];
+        const size_t i1 = left_splits[piece + 1];
+        group.run([=, &compare] {
+            sequentialMerge(from + begin + i0, from + begin + i1, from + mid + (k0 - i0), from + mid + (k1 - i1),
+                            to + begin + k0, compare);
+        });
+    }
+    group.wait();
+}
+
+template <typename T, typename Compare>
+size_t ParallelMergeSorter::coRank(size_t k, const T* left, size_t left_size, const T* right, size_t right_size, Compare& compare) {
+    // Smallest i (elements from left) such that right[k - i - 1] < left[i] holds strictly, i.e.
+    // every right element placed before the split is strictly smaller than the next left one.
+    size_t low = k > right_size ? k - right_size : 0;
+    size_t high = std::min(k, left_size);
+    while (low < high) {
+        const size_t i = low + (high - low) / 2;
+        const size_t j = k - i;
+        if (j > 0 && !compare(right[j - 1], left[i])) {
+            low = i + 1; // left[i] <= right[j - 1]: left[i] is among the first k outputs
+        } else {
+            high = i;
+        }
+    }
+    return low;
+}
+
+template <typename T, typename Compare>
+void ParallelMergeSorter::sequentialMerge(T* left, T* left_end, T* right, T* right_end, T* out, Compare& compare) {
+    while (left != left_end && right != right_end) {
+        // Take from the right only if strictly smaller: equal elements keep left-first order.
+        if (compare(*right, *left)) {
+            *out++ = std::move(*right++);
+        } else {
+            *out++ = std::move(*left++);
+        }
+    }
+    out = std::move(left, left_end, out);
+    std::move(right, right_end, out);
+}
+
+#endif // PARALLEL_MERGE_SORTER_HPP
@@ -5,21 +5,436 @@
 #ifndef QUICK_SORTER_HPP
 #define QUICK_SORTER_HPP
 
-#include <sorter.hpp>
+#include <key_dispatch_sorter.hpp>
+#include <sorting_network.hpp>
 #include <vector>
 #include <string>
+#include <utility> // For std::swap, std::move, std::pair
+#include <algorithm> // For std::make_heap, std::sort_heap
 
-class QuickSorter : public Sorter {
+/**
+ * @brief Pattern-defeating quicksort (pdqsort-style introsort).
+ *
+ * - Pivot: median of 3, or Tukey's ninther above NINTHER_THRESHOLD elements.
+ * - Duplicates: when the pivot equals the element left of the range (an earlier
+ *   pivot), all pivot-equal elements are gathered in one pass and skipped, so runs
+ *   of equal keys (e.g. population) cost O(n) instead of degrading the recursion.
+ * - Ranges below INSERTION_CUTOFF finish with insertion sort, or with a sorting
+ *   network on packed records (see uses_sorting_network_v). Numeric keys are packed
+ *   into such records for this, like string keys.
+ * - A partition that needed no swaps triggers a bounded insertion sort, which makes
+ *   already-sorted input O(n).
+ * - Too many highly unbalanced partitions fall back to heapsort: O(n log n) worst case.
+ * - Only the smaller side is recursed into; the larger side loops: O(log n) stack.
+ * - For numeric keys (see is_numeric_key_compare) the partition runs BlockQuicksort
+ *   style: comparison results are written as offsets into two BLOCK_SIZE buffers and
+ *   the misplaced elements swapped afterwards, so the compare feeds an index instead
+ *   of a hard-to-predict branch.
+ *
+ * Not stable.
+ */
+class QuickSorter : public KeyDispatchSorter<QuickSorter> {
 public:
-    void sort(std::vector<City>& cities, Comparator compare) override;
+    static constexpr size_t INSERTION_CUTOFF = 24;
+    static constexpr size_t NINTHER_THRESHOLD = 128;
+    static constexpr size_t PARTIAL_INSERTION_LIMIT = 8;
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    // Sort population/lat/lng through packed records (see packs_numeric_keys).
+    static constexpr bool packed_numeric_keys = true;
+
     [[nodiscard]] std::string getName() const override;
 
+    // Generic quicksort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare);
+
+    // sortRange() with the partition kernel chosen explicitly (BlockQuickSorter, benchmarks).
+    template <bool BlockPartition, typename T, typename Compare>
+    static void sortRangeWith(std::vector<T>& items, Compare& compare);
+
 private:
-    // Helper recursive function
-    void quickSortRecursive(std::vector<City>& cities, long long low, long long high, Comparator& compare);
+    // Sorts [begin, end). bad_allowed counts the unbalanced partitions left before
+    // switching to heapsort; leftmost means there is no earlier pivot at begin - 1.
+    template <bool BlockPartition, typename T, typename Compare>
+    static void quickSortLoop(std::vector<T>& items, size_t begin, size_t end, int bad_allowed, bool leftmost, Compare& compare);
+
+    // Partitions [begin, end) around items[begin]: elements < pivot go left. Returns the
+    // pivot's final position and whether the range was already partitioned (no swaps).
+    template <typename T, typename Compare>
+    static std::pair<size_t, bool> partitionRight(std::vector<T>& items, size_t begin, size_t end, Compare& compare);
+
+    // Same contract as partitionRight(), but misplaced elements are found a block at a
+    // time with branch-free comparisons, recording their offsets, and then swapped in
+    // bulk (BlockQuicksort); used when comparisons are cheap (numeric keys).
+    template <typename T, typename Compare>
+    static std::pair<size_t, bool> partitionRightBlock(std::vector<T>& items, size_t begin, size_t end, Compare& compare);
+
+    // Exchanges `count` left/right element pairs found by partitionRightBlock(). A cyclic
+    // permutation costs fewer moves; plain swaps are needed when both buffers end together.
+    template <typename T>
+    static void swapOffsets(std::vector<T>& items, size_t first, size_t last, const unsigned char* offsets_left,
+                            const unsigned char* offsets_right, size_t count, bool use_swaps);
+
+    // Partitions [begin, end) around items[begin]: elements <= pivot go left. Returns the
+    // pivot's final position; everything in [begin, position] is equal to the pivot.
+    template <typename T, typename Compare>
+    static size_t partitionLeft(std::vector<T>& items, size_t begin, size_t end, Compare& compare);
+
+    // Orders items[a], items[b], items[c] so that the median ends up at b.
+    template <typename T, typename Compare>
+    static void sort3(std::vector<T>& items, size_t a, size_t b, size_t c, Compare& compare);
+
+    template <typename T, typename Compare>
+    static void insertionSort(std::vector<T>& items, size_t begin, size_t end, Compare& compare);
+
+    // Insertion sort that gives up (returns false) after PARTIAL_INSERTION_LIMIT moves.
+    template <typename T, typename Compare>
+    static bool partialInsertionSort(std::vector<T>& items, size_t begin, size_t end, Compare& compare);
 
-    // Helper partition function (using Lomuto partition scheme as an example)
-    static long long partition(std::vector<City>& cities, long long low, long long high, Comparator& compare);
+    template <typename T, typename Compare>
+    static void heapSort(std::vector<T>& items, size_t begin, size_t end, Compare& compare);
 };
 
+template <typename T, typename Compare>
+void QuickSorter::sortRange(std::vector<T>& items, Compare& compare) {
+    sortRangeWith<is_numeric_key_compare<Compare>::value>(items, compare);
+}
+
+template <bool BlockPartition, typename T, typename Compare>
+void QuickSorter::sortRangeWith(std::vector<T>& items, Compare& compare) {
+    if (items.size() < 2) {
+        return;
+    }
+    int log2_size = 0;
+    for (size_t n = items.size(); n > 1; n >>= 1) {
+        ++log2_size;
+    }
+    quickSortLoop<BlockPartition>(items, 0, items.size(), log2_size, true, compare);
+}
+
+template <bool BlockPartition, typename T, typename Compare>
+void QuickSorter::quickSortLoop(std::vector<T>& items, size_t begin, size_t end, int bad_allowed, bool leftmost, Compare& compare) {
+    while (true) {
+        const size_t size = end - begin;
+        if (size < INSERTION_CUTOFF) {
+            if constexpr (uses_sorting_network_v<T, Compare>) {
+                sortSmallPackedRows(items.data() + begin, size);
+            } else {
+                insertionSort(items, begin, end, compare);
+            }
+            return;
+        }
+
+        // Move the chosen pivot to items[begin].
+        const size_t half = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(items, begin, begin + half, end - 1, compare);
+            sort3(items, begin + 1, begin + half - 1, end - 2, compare);
+            sort3(items, begin + 2, begin + half + 1, end - 3, compare);
+            sort3(items, begin + half - 1, begin + half, begin + half + 1, compare);
+            std::swap(items[begin], items[begin + half]);
+        } else {
+            sort3(items, begin + half, begin, end - 1, compare);
+        }
+
+        // The earlier pivot at begin - 1 is <= everything in this range. If it is also
+        // >= our pivot, the pivot is a duplicate: skip every element equal to it at once.
+        if (!leftmost && !compare(items[begin - 1], items[begin])) {
+            begin = partitionLeft(items, begin, end, compare) + 1;
+            continue;
+        }
+
+        auto [pivot_pos, already_partitioned] = BlockPartition ? partitionRightBlock(items, begin, end, compare)
+                                                               : partitionRight(items, begin, end, compare);
+        const size_t left_size = pivot_pos - begin;
+        const size_t right_size = end - (pivot_pos + 1);
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed == 0) {
+                heapSort(items, begin, end, compare);
+                return;
+            }
+            // Swap a few elements around to break up the pattern that caused the bad split.
+            if (left_size >= INSERTION_CUTOFF) {
+                std::swap(items[begin], items[begin + left_size / 4]);
+                std::swap(items[pivot_pos - 1], items[pivot_pos - left_size / 4]);
+            }
+            if (right_size >= INSERTION_CUTOFF) {
+                std::swap(items[pivot_pos + 1], items[pivot_pos + 1 + right_size / 4]);
+                std::swap(items[end - 1], items[end - right_size / 4]);
+            }
+        } else if (already_partitioned
+                   && partialInsertionSort(items, begin, pivot_pos, compare)
+                   && partialInsertionSort(items, pivot_pos + 1, end, compare)) {
+            return; // Both sides were (nearly) sorted already.
+        }
+
+        // Recurse into the smaller side and loop on the larger one.
+        if (left_size < right_size) {
+            quickSortLoop<BlockPartition>(items, begin, pivot_pos, bad_allowed, leftmost, compare);
+            begin = pivot_pos + 1;
+            leftmost = false;
+        } else {
+            quickSortLoop<BlockPartition>(items, pivot_pos + 1, end, bad_allowed, false, compare);
+            end = pivot_pos;
+        }
+    }
+}
+
+template <typename T, typename Compare>
+std::pair<size_t, bool> QuickSorter::partitionRight(std::vector<T>& items, size_t begin, size_t end, Compare& compare) {
+    T pivot = std::move(items[begin]);
+    size_t first = begin;
+    size_t last = end;
+
+    // The pivot selection guarantees an element >= pivot, so this scan stops inside the range.
+    while (compare(items[++first], pivot)) {
+    }
+    // Guard the downward scan only if no element < pivot was found on the left.
+    if (first - 1 == begin) {
+        while (first < last && !compare(items[--last], pivot)) {
+        }
+    } else {
+        while (!compare(items[--last], pivot)) {
+        }
+    }
+
+    const bool already_partitioned = first >= last;
+    while (first < last) {
+        std::swap(items[first], items[last]);
+        while (compare(items[++first], pivot)) {
+        }
+        while (!compare(items[--last], pivot)) {
+        }
+    }
+
+    const size_t pivot_pos = first - 1;
+    items[begin] = std::move(items[pivot_pos]);
+    items[pivot_pos] = std::move(pivot);
+    return {pivot_pos, already_partitioned};
+}
+
+template <typename T, typename Compare>
+std::pair<size_t, bool> QuickSorter::partitionRightBlock(std::vector<T>& items, size_t begin, size_t end, Compare& compare) {
+    T pivot = std::move(items[begin]);
+    size_t first = begin;
+    size_t last = end;
+
+    // Same boundary scans as partitionRight().
+    while (compare(items[++first], pivot)) {
+    }
+    if (first - 1 == begin) {
+        while (first < last && !compare(items[--last], pivot)) {
+        }
+    } else {
+        while (!compare(items[--last], pivot)) {
+        }
+    }
+
+    const bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        std::swap(items[first], items[last]);
+        ++first;
+
+        // offsets_left: positions (from first) of elements >= pivot that must go right.
+        // offsets_right: positions (back from last, 1-based) of elements < pivot that must go left.
+        unsigned char offsets_left[BLOCK_SIZE];
+        unsigned char offsets_right[BLOCK_SIZE];
+        size_t num_left = 0, num_right = 0, start_left = 0, start_right = 0;
+
+        while (last - first > 2 * BLOCK_SIZE) {
+            if (num_left == 0) {
+                start_left = 0;
+                for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                    offsets_left[num_left] = static_cast<unsigned char>(i);
+                    num_left += !compare(items[first + i], pivot);
+                }
+            }
+            if (num_right == 0) {
+                start_right = 0;
+                for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+                    offsets_right[num_right] = static_cast<unsigned char>(i + 1);
+                    num_right += compare(items[last - i - 1], pivot);
+                }
+            }
+
+            const size_t count = std::min(num_left, num_right);
+            swapOffsets(items, first, last, offsets_left + start_left, offsets_right + start_right, count,
+                        num_left == num_right);
+            num_left -= count;
+            num_right -= count;
+            start_left += count;
+            start_right += count;
+            if (num_left == 0) first += BLOCK_SIZE;
+            if (num_right == 0) last -= BLOCK_SIZE;
+        }
+
+        // Fewer than two blocks are left unclassified; split them between the sides.
+        size_t left_size = 0, right_size = 0;
+        const size_t unknown = (last - first) - ((num_right || num_left) ? BLOCK_SIZE : 0);
+        if (num_right) {
+            left_size = unknown;
+            right_size = BLOCK_SIZE;
+        } else if (num_left) {
+            left_size = BLOCK_SIZE;
+            right_size = unknown;
+        } else {
+            left_size = unknown / 2;
+            right_size = unknown - left_size;
+        }
+
+        if (unknown && !num_left) {
+            start_left = 0;
+            for (size_t i = 0; i < left_size; ++i) {
+                offsets_left[num_left] = static_cast<unsigned char>(i);
+                num_left += !compare(items[first + i], pivot);
+            }
+        }
+        if (unknown && !num_right) {
+            start_right = 0;
+            for (size_t i = 0; i < right_size; ++i) {
+                offsets_right[num_right] = static_cast<unsigned char>(i + 1);
+                num_right += compare(items[last - i - 1], pivot);
+            }
+        }
+
+        const size_t count = std::min(num_left, num_right);
+        swapOffsets(items, first, last, offsets_left + start_left, offsets_right + start_right, count,
+                    num_left == num_right);
+        num_left -= count;
+        num_right -= count;
+        start_left += count;
+        start_right += count;
+        if (num_left == 0) first += left_size;
+        if (num_right == 0) last -= right_size;
+
+        // Every element is classified; move the leftovers of the one non-empty buffer.
+        if (num_left) {
+            while (num_left--) {
+                std::swap(items[first + offsets_left[start_left + num_left]], items[--last]);
+            }
+            first = last;
+        }
+        if (num_right) {
+            while (num_right--) {
+                std::swap(items[last - offsets_right[start_right + num_right]], items[first]);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    const size_t pivot_pos = first - 1;
+    items[begin] = std::move(items[pivot_pos]);
+    items[pivot_pos] = std::move(pivot);
+    return {pivot_pos, already_partitioned};
+}
+
+template <typename T>
+void QuickSorter::swapOffsets(std::vector<T>& items, size_t first, size_t last, const unsigned char* offsets_left,
+                              const unsigned char* offsets_right, size_t count, bool use_swaps) {
+    if (use_swaps) {
+        for (size_t i = 0; i < count; ++i) {
+            std::swap(items[first + offsets_left[i]], items[last - offsets_right[i]]);
+        }
+    } else if (count > 0) {
+        size_t left = first + offsets_left[0];
+        size_t right = last - offsets_right[0];
+        T saved = std::move(items[left]);
+        items[left] = std::move(items[right]);
+        for (size_t i = 1; i < count; ++i) {
+            left = first + offsets_left[i];
+            items[right] = std::move(items[left]);
+            right = last - offsets_right[i];
+            items[left] = std::move(items[right]);
+        }
+        items[right] = std::move(saved);
+    }
+}
+
+template <typename T, typename Compare>
+size_t QuickSorter::partitionLeft(std::vector<T>& items, size_t begin, size_t end, Compare& compare) {
+    T pivot = std::move(items[begin]);
+    size_t first = begin;
+    size_t last = end;
+
+    while (compare(pivot, items[--last])) {
+    }
+    if (last + 1 == end) {
+        while (first < last && !compare(pivot, items[++first])) {
+        }
+    } else {
+        while (!compare(pivot, items[++first])) {
+        }
+    }
+
+    while (first < last) {
+        std::swap(items[first], items[last]);
+        while (compare(pivot, items[--last])) {
+        }
+        while (!compare(pivot, items[++first])) {
+        }
+    }
+
+    const size_t pivot_pos = last;
+    items[begin] = std::move(items[pivot_pos]);
+    items[pivot_pos] = std::move(pivot);
+    return pivot_pos;
+}
+
+template <typename T, typename Compare>
+void QuickSorter::sort3(std::vector<T>& items, size_t a, size_t b, size_t c, Compare& compare) {
+    if (compare(items[b], items[a])) std::swap(items[a], items[b]);
+    if (compare(items[c], items[b])) std::swap(items[b], items[c]);
+    if (compare(items[b], items[a])) std::swap(items[a], items[b]);
+}
+
+template <typename T, typename Compare>
+void QuickSorter::insertionSort(std::vector<T>& items, size_t begin, size_t end, Compare& compare) {
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (!compare(items[i], items[i - 1])) {
+            continue;
+        }
+        T key = std::move(items[i]);
+        size_t j = i;
+        do {
+            items[j] = std::move(items[j - 1]);
+            --j;
+        } while (j > begin && compare(key, items[j - 1]));
+        items[j] = std::move(key);
+    }
+}
+
+template <typename T, typename Compare>
+bool QuickSorter::partialInsertionSort(std::vector<T>& items, size_t begin, size_t end, Compare& compare) {
+    size_t moves = 0;
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (moves > PARTIAL_INSERTION_LIMIT) {
+            return false;
+        }
+        if (!compare(items[i], items[i - 1])) {
+            continue;
+        }
+        T key = std::move(items[i]);
+        size_t j = i;
+        do {
+            items[j] = std::move(items[j - 1]);
+            --j;
+        } while (j > begin && compare(key, items[j - 1]));
+        items[j] = std::move(key);
+        moves += i - j;
+    }
+    return true;
+}
+
+template <typename T, typename Compare>
+void QuickSorter::heapSort(std::vector<T>& items, size_t begin, size_t end, Compare& compare) {
+    auto less = [&compare](const T& a, const T& b) { return compare(a, b); };
+    auto first = items.begin() + static_cast<std::ptrdiff_t>(begin);
+    auto last = items.begin() + static_cast<std::ptrdiff_t>(end);
+    std::make_heap(first, last, less);
+    std::sort_heap(first, last, less);
+}
+
 #endif // QUICK_SORTER_HPP
@@ -0,0 +1,54 @@
+//
+// LSD radix sort for the numeric City keys (population, lat, lng).
+//
+
+#ifndef RADIX_SORTER_HPP
+#define RADIX_SORTER_HPP
+
+#include <sorter.hpp>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief Stable byte-wise LSD radix sort keyed directly on a City column.
+ *
+ * Each row is reduced to a 64-bit unsigned key whose unsigned order matches the
+ * column's order (sign bit flipped for longs, sign-flip transform for doubles, all
+ * bits complemented for descending order), then sorted with up to eight counting
+ * passes of 8 bits. Passes where every key has the same byte are skipped.
+ *
+ * Composite keys are radix-sorted on their packed 64-bit key when every field fits
+ * in it (see packCompositeKeys()).
+ *
+ * Inputs of up to SMALL_SORT_MAX rows skip the passes and go through
+ * sortSmallPackedRows().
+ *
+ * String keys, composites that do not pack completely, and plain comparator calls (sort/sortIndices) have no numeric key to
+ * work on and fall back to a stable merge sort.
+ */
+class RadixSorter : public Sorter {
+public:
+    void sort(std::vector<City>& cities, Comparator compare) override;
+    Permutation sortIndices(const std::vector<City>& cities, Comparator compare) override;
+    void sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) override;
+    Permutation sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) override;
+    void sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override;
+    Permutation sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override;
+    [[nodiscard]] std::string getName() const override;
+    [[nodiscard]] bool isStable() const override;
+
+    // Order-preserving map from a signed integer / double to an unsigned 64-bit key.
+    static std::uint64_t encodeKey(long value);
+    static std::uint64_t encodeKey(double value);
+
+private:
+    // (key, row index); the same layout as a packed composite key.
+    using KeyedIndex = PackedRow;
+
+    // Builds (key, row index) pairs for a numeric column and radix-sorts them.
+    static std::vector<KeyedIndex> sortKeys(const std::vector<City>& cities, SortKey key, bool reverse_order);
+    static void radixSort(std::vector<KeyedIndex>& items);
+};
+
+#endif // RADIX_SORTER_HPP
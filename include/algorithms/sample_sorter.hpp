@@ -0,0 +1,190 @@
+//
+// Parallel sample sort: splitters from an oversampled sample, one scatter pass, per-bucket sorts.
+//
+
+#ifndef SAMPLE_SORTER_HPP
+#define SAMPLE_SORTER_HPP
+
+#include <key_dispatch_sorter.hpp>
+#include <thread_pool.hpp>
+#include <algorithms/quick_sorter.hpp>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+
+/**
+ * @brief Parallel sample sort on a ThreadPool.
+ *
+ * - Splitters: OVERSAMPLING random elements per bucket are sorted and every
+ *   OVERSAMPLING-th one becomes a splitter, which keeps buckets close to n / buckets.
+ * - Classification: each thread takes one chunk of the input, finds every element's
+ *   bucket with a binary search over the splitters and counts bucket sizes.
+ * - Scatter: prefix sums over the counts give every (chunk, bucket) pair its own
+ *   slice, so all threads move their elements into the buckets at once without locks.
+ * - Buckets are sorted independently with QuickSorter (block partitioning for numeric
+ *   keys) and moved back in place; no global merge is needed.
+ * - Equal keys: elements equal to a splitter go to an equality bucket of their own,
+ *   which is already sorted. Heavy duplicates (population) therefore do not pile up
+ *   in one oversized bucket.
+ *
+ * With one thread, or below SEQUENTIAL_THRESHOLD elements, it is plain QuickSorter.
+ * The pool is created on the first parallel sort and reused by later ones (an
+ * ExternalSorter sorts one chunk per call); setThreadCount() discards it.
+ * Not stable.
+ */
+class SampleSorter : public KeyDispatchSorter<SampleSorter> {
+public:
+    static constexpr size_t SEQUENTIAL_THRESHOLD = 16384;
+    static constexpr size_t OVERSAMPLING = 32;
+    // Several buckets per thread so that stealing can even out unequal buckets.
+    static constexpr size_t BUCKETS_PER_THREAD = 4;
+
+    // Default: one thread per hardware thread.
+    SampleSorter();
+
+    [[nodiscard]] std::string getName() const override;
+    void setThreadCount(unsigned int thread_count) override;
+    [[nodiscard]] unsigned int getThreadCount() const;
+
+    // Generic sample sort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    void sortRange(std::vector<T>& items, Compare& compare) const;
+
+private:
+    unsigned int thread_count_;
+    mutable std::mutex pool_mutex_;
+    mutable std::unique_ptr<ThreadPool> pool_;
+
+    // The shared pool, started with thread_count_ threads on first use.
+    ThreadPool& pool() const;
+
+    // Up to bucket_count - 1 strictly increasing splitters drawn from an oversampled sample.
+    template <typename T, typename Compare>
+    static std::vector<T> chooseSplitters(const std::vector<T>& items, size_t bucket_count, Compare& compare);
+
+    // Bucket 2i holds elements between splitters i - 1 and i; bucket 2i + 1 those equal to splitter i.
+    template <typename T, typename Compare>
+    static size_t classify(const T& item, const std::vector<T>& splitters, Compare& compare);
+};
+
+template <typename T, typename Compare>
+void SampleSorter::sortRange(std::vector<T>& items, Compare& compare) const {
+    const size_t n = items.size();
+    if (this->thread_count_ <= 1 || n < SEQUENTIAL_THRESHOLD) {
+        QuickSorter::sortRange(items, compare);
+        return;
+    }
+
+    const size_t chunk_count = this->thread_count_;
+    const std::vector<T> splitters = chooseSplitters(items, chunk_count * BUCKETS_PER_THREAD, compare);
+    const size_t bucket_count = 2 * splitters.size() + 1;
+    ThreadPool& pool = this->pool();
+
+    // Pass 1: classify each chunk and count its elements per bucket.
+    std::vector<std::uint32_t> bucket_of(n);
+    std::vector<size_t> offsets(chunk_count * bucket_count, 0); // counts, then each chunk's start in each bucket
+    {
+        TaskGroup group(pool);
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            group.run([&, chunk] {
+                size_t* counts = &offsets[chunk * bucket_count];
+                for (size_t i = n * chunk / chunk_count; i < n * (chunk + 1) / chunk_count; ++i) {
+                    const size_t bucket = classify(items[i], splitters, compare);
+                    bucket_of[i] = static_cast<std::uint32_t>(bucket);
+                    ++counts[bucket];
+                }
+            });
+        }
+        group.wait();
+    }
+
+    // Within a bucket, chunks keep their input order.
+    std::vector<std::vector<T>> buckets(bucket_count);
+    std::vector<size_t> bucket_start(bucket_count + 1, 0);
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        size_t size = 0;
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            const size_t count = offsets[chunk * bucket_count + bucket];
+            offsets[chunk * bucket_count + bucket] = size;
+            size += count;
+        }
+        buckets[bucket].resize(size);
+        bucket_start[bucket + 1] = bucket_start[bucket] + size;
+    }
+
+    // Pass 2: scatter. Every (chunk, bucket) slice is disjoint, so no synchronisation is needed.
+    {
+        TaskGroup group(pool);
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            group.run([&, chunk] {
+                size_t* cursors = &offsets[chunk * bucket_count];
+                for (size_t i = n * chunk / chunk_count; i < n * (chunk + 1) / chunk_count; ++i) {
+                    const size_t bucket = bucket_of[i];
+                    buckets[bucket][cursors[bucket]++] = std::move(items[i]);
+                }
+            });
+        }
+        group.wait();
+    }
+
+    // Pass 3: sort each bucket and move it back to its final position.
+    {
+        TaskGroup group(pool);
+        for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+            if (buckets[bucket].empty()) {
+                continue;
+            }
+            group.run([&, bucket] {
+                if (bucket % 2 == 0) { // equality buckets are already sorted
+                    QuickSorter::sortRange(buckets[bucket], compare);
+                }
+                std::move(buckets[bucket].begin(), buckets[bucket].end(), items.begin() + bucket_start[bucket]);
+                std::vector<T>().swap(buckets[bucket]);
+            });
+        }
+        group.wait();
+    }
+}
+
+template <typename T, typename Compare>
+std::vector<T> SampleSorter::chooseSplitters(const std::vector<T>& items, size_t bucket_count, Compare& compare) {
+    // Fixed seed: the same input always gets the same buckets.
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(items.size()));
+    std::uniform_int_distribution<size_t> position(0, items.size() - 1);
+    const size_t sample_size = std::min(items.size(), OVERSAMPLING * bucket_count);
+    std::vector<T> sample;
+    sample.reserve(sample_size);
+    for (size_t i = 0; i < sample_size; ++i) {
+        sample.push_back(items[position(rng)]);
+    }
+    QuickSorter::sortRange(sample, compare);
+
+    // Equal candidates collapse into one splitter; its equality bucket takes all copies.
+    std::vector<T> splitters;
+    for (size_t bucket = 1; bucket < bucket_count; ++bucket) {
+        const T& candidate = sample[bucket * sample_size / bucket_count];
+        if (splitters.empty() || compare(splitters.back(), candidate)) {
+            splitters.push_back(candidate);
+        }
+    }
+    return splitters;
+}
+
+template <typename T, typename Compare>
+size_t SampleSorter::classify(const T& item, const std::vector<T>& splitters, Compare& compare) {
+    const size_t position = static_cast<size_t>(
+        std::lower_bound(splitters.begin(), splitters.end(), item, [&compare](const T& a, const T& b) {
+            return compare(a, b);
+        }) - splitters.begin());
+    if (position < splitters.size() && !compare(item, splitters[position])) {
+        return 2 * position + 1;
+    }
+    return 2 * position;
+}
+
+#endif // SAMPLE_SORTER_HPP
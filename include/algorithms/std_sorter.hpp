@@ -5,14 +5,20 @@
 #ifndef STD_SORTER_HPP
 #define STD_SORTER_HPP
 
-#include <sorter.hpp>
+#include <key_dispatch_sorter.hpp>
 #include <vector>
 #include <string>
+#include <algorithm> // For std::sort
 
-class StdSorter : public Sorter {
+class StdSorter : public KeyDispatchSorter<StdSorter> {
 public:
-    void sort(std::vector<City>& cities, Comparator compare) override;
     [[nodiscard]] std::string getName() const override;
+
+    // std::sort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare) {
+        std::sort(items.begin(), items.end(), compare);
+    }
 };
 
 #endif // STD_SORTER_HPP
@@ -0,0 +1,525 @@
+//
+// TimSort: natural-run detection, minrun insertion sort and galloping merges.
+//
+
+#ifndef TIM_SORTER_HPP
+#define TIM_SORTER_HPP
+
+#include <key_dispatch_sorter.hpp>
+#include <vector>
+#include <string>
+#include <algorithm> // For std::reverse, std::move_backward, std::min, std::max
+#include <cstddef>
+#include <stdexcept>
+#include <utility> // For std::move
+
+/**
+ * @brief Adaptive, stable merge sort (TimSort, after CPython's listsort).
+ *
+ * - Runs: the input is scanned for natural runs. Non-descending runs are kept,
+ *   strictly descending ones are reversed in place (strict, so equal keys keep
+ *   their order). Runs shorter than minRunLength(n) (between MIN_MERGE / 2 and
+ *   MIN_MERGE) are extended with binary insertion sort.
+ * - Run stack: pending runs are merged as soon as their lengths stop shrinking
+ *   fast enough (the invariants fixed after de Gouw et al.), keeping merges balanced
+ *   and the stack O(log n) deep.
+ * - Merges: before merging, the prefix of the left run and the suffix of the right
+ *   run that are already in place are skipped with a gallop (exponential search).
+ *   Only the smaller run is copied to the buffer. When one run keeps winning
+ *   (MIN_GALLOP times in a row), the merge switches to galloping and copies whole
+ *   blocks at once; the threshold adapts to how well galloping pays off.
+ *
+ * Sorted, reversed and mostly sorted input (appended rows, pre-grouped data) costs
+ * close to n comparisons; random input is about as fast as a plain merge sort.
+ */
+class TimSorter : public KeyDispatchSorter<TimSorter> {
+public:
+    static constexpr size_t MIN_MERGE = 32;
+    static constexpr size_t MIN_GALLOP = 7;
+
+    [[nodiscard]] std::string getName() const override;
+    [[nodiscard]] bool isStable() const override;
+
+    // Generic TimSort over Cities or row indices; KeyDispatchSorter instantiates it per comparator.
+    template <typename T, typename Compare>
+    static void sortRange(std::vector<T>& items, Compare& compare);
+
+    // Minimum run length for n elements: n itself below MIN_MERGE, otherwise a value in
+    // [MIN_MERGE / 2, MIN_MERGE] such that n / minrun is a power of two or slightly below.
+    static size_t minRunLength(size_t n);
+
+private:
+    template <typename T, typename Compare>
+    class MergeState;
+
+    // Length of the run starting at lo (descending runs are reversed to ascending).
+    template <typename T, typename Compare>
+    static size_t countRunAndMakeAscending(std::vector<T>& items, size_t lo, size_t hi, Compare& compare);
+
+    // Sorts [lo, hi), given that [lo, start) is already sorted.
+    template <typename T, typename Compare>
+    static void binaryInsertionSort(std::vector<T>& items, size_t lo, size_t hi, size_t start, Compare& compare);
+
+    // Position in sorted a[0, length) where key would be inserted before any equal element.
+    template <typename T, typename Compare>
+    static size_t gallopLeft(const T& key, const T* a, size_t length, size_t hint, Compare& compare);
+
+    // Position in sorted a[0, length) where key would be inserted after any equal element.
+    template <typename T, typename Compare>
+    static size_t gallopRight(const T& key, const T* a, size_t length, size_t hint, Compare& compare);
+};
+
+// Pending runs and the merge buffer of one sortRange() call.
+template <typename T, typename Compare>
+class TimSorter::MergeState {
+public:
+    MergeState(std::vector<T>& items, Compare& compare) : items_(items), compare_(compare) {}
+
+    void pushRun(size_t base, size_t length) {
+        this->runs_.push_back({base, length});
+    }
+
+    // Merges until the run lengths satisfy the stack invariants:
+    // runs[i - 2] > runs[i - 1] + runs[i] and runs[i - 1] > runs[i].
+    void mergeCollapse() {
+        while (this->runs_.size() > 1) {
+            size_t n = this->runs_.size() - 2;
+            if ((n > 0 && this->runs_[n - 1].length <= this->runs_[n].length + this->runs_[n + 1].length) ||
+                (n > 1 && this->runs_[n - 2].length <= this->runs_[n - 1].length + this->runs_[n].length)) {
+                if (this->runs_[n - 1].length < this->runs_[n + 1].length) {
+                    --n;
+                }
+            } else if (this->runs_[n].length > this->runs_[n + 1].length) {
+                break;
+            }
+            this->mergeAt(n);
+        }
+    }
+
+    void mergeForceCollapse() {
+        while (this->runs_.size() > 1) {
+            size_t n = this->runs_.size() - 2;
+            if (n > 0 && this->runs_[n - 1].length < this->runs_[n + 1].length) {
+                --n;
+            }
+            this->mergeAt(n);
+        }
+    }
+
+private:
+    struct Run {
+        size_t base;
+        size_t length;
+    };
+
+    std::vector<T>& items_;
+    Compare& compare_;
+    std::vector<T> buffer_;
+    std::vector<Run> runs_;
+    size_t min_gallop_ = MIN_GALLOP;
+
+    // Merges runs i and i + 1 of the stack.
+    void mergeAt(size_t i) {
+        size_t base1 = this->runs_[i].base;
+        size_t length1 = this->runs_[i].length;
+        const size_t base2 = this->runs_[i + 1].base;
+        size_t length2 = this->runs_[i + 1].length;
+
+        this->runs_[i].length = length1 + length2;
+        if (i == this->runs_.size() - 3) {
+            this->runs_[i + 1] = this->runs_[i + 2];
+        }
+        this->runs_.pop_back();
+
+        T* a = this->items_.data();
+        // Elements of run 1 not greater than run 2's first element are already in place.
+        const size_t skip = gallopRight(a[base2], a + base1, length1, 0, this->compare_);
+        base1 += skip;
+        length1 -= skip;
+        if (length1 == 0) {
+            return;
+        }
+        // Elements of run 2 not less than run 1's last element are already in place.
+        length2 = gallopLeft(a[base1 + length1 - 1], a + base2, length2, length2 - 1, this->compare_);
+        if (length2 == 0) {
+            return;
+        }
+
+        if (length1 <= length2) {
+            this->mergeLow(base1, length1, base2, length2);
+        } else {
+            this->mergeHigh(base1, length1, base2, length2);
+        }
+    }
+
+    T* reserveBuffer(size_t length) {
+        if (this->buffer_.size() < length) {
+            this->buffer_.resize(std::max(length, std::min(this->items_.size() / 2, length * 2)));
+        }
+        return this->buffer_.data();
+    }
+
+    [[noreturn]] static void throwInconsistentComparator() {
+        throw std::runtime_error("TimSorter Error: The comparator is not a strict weak ordering.");
+    }
+
+    // Merges left to right with run 1 (the shorter one) in the buffer. Requires
+    // a[base2] < a[base1] and a[base1 + length1 - 1] > every element of run 2.
+    void mergeLow(size_t base1, size_t length1, size_t base2, size_t length2) {
+        T* a = this->items_.data();
+        T* buffer = this->reserveBuffer(length1);
+        std::move(a + base1, a + base1 + length1, buffer);
+
+        size_t cursor1 = 0;     // in buffer
+        size_t cursor2 = base2; // in a
+        size_t dest = base1;
+        a[dest++] = std::move(a[cursor2++]);
+        if (--length2 == 0) {
+            std::move(buffer + cursor1, buffer + cursor1 + length1, a + dest);
+            return;
+        }
+        if (length1 == 1) {
+            std::move(a + cursor2, a + cursor2 + length2, a + dest);
+            a[dest + length2] = std::move(buffer[cursor1]);
+            return;
+        }
+
+        size_t min_gallop = this->min_gallop_;
+        bool done = false;
+        while (!done) {
+            size_t count1 = 0; // times in a row run 1 won
+            size_t count2 = 0; // times in a row run 2 won
+
+            // One element at a time until a run starts winning consistently.
+            do {
+                if (this->compare_(a[cursor2], buffer[cursor1])) {
+                    a[dest++] = std::move(a[cursor2++]);
+                    ++count2;
+                    count1 = 0;
+                    if (--length2 == 0) {
+                        done = true;
+                    }
+                } else {
+                    a[dest++] = std::move(buffer[cursor1++]);
+                    ++count1;
+                    count2 = 0;
+                    if (--length1 == 1) {
+                        done = true;
+                    }
+                }
+            } while (!done && (count1 | count2) < min_gallop);
+
+            // Galloping: copy whole blocks while it keeps paying off.
+            while (!done) {
+                count1 = gallopRight(a[cursor2], buffer + cursor1, length1, 0, this->compare_);
+                if (count1 != 0) {
+                    std::move(buffer + cursor1, buffer + cursor1 + count1, a + dest);
+                    dest += count1;
+                    cursor1 += count1;
+                    length1 -= count1;
+                    if (length1 <= 1) {
+                        done = true;
+                        break;
+                    }
+                }
+                a[dest++] = std::move(a[cursor2++]);
+                if (--length2 == 0) {
+                    done = true;
+                    break;
+                }
+
+                count2 = gallopLeft(buffer[cursor1], a + cursor2, length2, 0, this->compare_);
+                if (count2 != 0) {
+                    std::move(a + cursor2, a + cursor2 + count2, a + dest);
+                    dest += count2;
+                    cursor2 += count2;
+                    length2 -= count2;
+                    if (length2 == 0) {
+                        done = true;
+                        break;
+                    }
+                }
+                a[dest++] = std::move(buffer[cursor1++]);
+                if (--length1 == 1) {
+                    done = true;
+                    break;
+                }
+
+                if (min_gallop > 0) {
+                    --min_gallop;
+                }
+                if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) {
+                    break;
+                }
+            }
+            if (!done) {
+                min_gallop += 2; // Penalty for leaving gallop mode
+            }
+        }
+        this->min_gallop_ = std::max<size_t>(min_gallop, 1);
+
+        if (length1 == 1) {
+            std::move(a + cursor2, a + cursor2 + length2, a + dest);
+            a[dest + length2] = std::move(buffer[cursor1]); // Run 1's last element is the largest
+        } else if (length1 == 0) {
+            throwInconsistentComparator();
+        } else {
+            std::move(buffer + cursor1, buffer + cursor1 + length1, a + dest);
+        }
+    }
+
+    // Merges right to left with run 2 (the shorter one) in the buffer. Same preconditions as mergeLow().
+    void mergeHigh(size_t base1, size_t length1, size_t base2, size_t length2) {
+        T* a = this->items_.data();
+        T* buffer = this->reserveBuffer(length2);
+        std::move(a + base2, a + base2 + length2, buffer);
+
+        // Signed: cursor1 ends one before base1, which may be -1.
+        auto cursor1 = static_cast<std::ptrdiff_t>(base1 + length1) - 1; // in a
+        auto cursor2 = static_cast<std::ptrdiff_t>(length2) - 1;         // in buffer
+        auto dest = static_cast<std::ptrdiff_t>(base2 + length2) - 1;
+        a[dest--] = std::move(a[cursor1--]);
+        if (--length1 == 0) {
+            std::move(buffer, buffer + length2, a + (dest - static_cast<std::ptrdiff_t>(length2) + 1));
+            return;
+        }
+        if (length2 == 1) {
+            dest -= static_cast<std::ptrdiff_t>(length1);
+            cursor1 -= static_cast<std::ptrdiff_t>(length1);
+            std::move_backward(a + (cursor1 + 1), a + (cursor1 + 1) + length1, a + (dest + 1) + length1);
+            a[dest] = std::move(buffer[cursor2]);
+            return;
+        }
+
+        size_t min_gallop = this->min_gallop_;
+        bool done = false;
+        while (!done) {
+            size_t count1 = 0;
+            size_t count2 = 0;
+
+            do {
+                if (this->compare_(buffer[cursor2], a[cursor1])) {
+                    a[dest--] = std::move(a[cursor1--]);
+                    ++count1;
+                    count2 = 0;
+                    if (--length1 == 0) {
+                        done = true;
+                    }
+                } else {
+                    a[dest--] = std::move(buffer[cursor2--]);
+                    ++count2;
+                    count1 = 0;
+                    if (--length2 == 1) {
+                        done = true;
+                    }
+                }
+            } while (!done && (count1 | count2) < min_gallop);
+
+            while (!done) {
+                count1 = length1 - gallopRight(buffer[cursor2], a + base1, length1, length1 - 1, this->compare_);
+                if (count1 != 0) {
+                    dest -= static_cast<std::ptrdiff_t>(count1);
+                    cursor1 -= static_cast<std::ptrdiff_t>(count1);
+                    length1 -= count1;
+                    std::move_backward(a + (cursor1 + 1), a + (cursor1 + 1) + count1, a + (dest + 1) + count1);
+                    if (length1 == 0) {
+                        done = true;
+                        break;
+                    }
+                }
+                a[dest--] = std::move(buffer[cursor2--]);
+                if (--length2 == 1) {
+                    done = true;
+                    break;
+                }
+
+                count2 = length2 - gallopLeft(a[cursor1], buffer, length2, length2 - 1, this->compare_);
+                if (count2 != 0) {
+                    dest -= static_cast<std::ptrdiff_t>(count2);
+                    cursor2 -= static_cast<std::ptrdiff_t>(count2);
+                    length2 -= count2;
+                    std::move(buffer + (cursor2 + 1), buffer + (cursor2 + 1) + count2, a + (dest + 1));
+                    if (length2 <= 1) {
+                        done = true;
+                        break;
+                    }
+                }
+                a[dest--] = std::move(a[cursor1--]);
+                if (--length1 == 0) {
+                    done = true;
+                    break;
+                }
+
+                if (min_gallop > 0) {
+                    --min_gallop;
+                }
+                if (count1 < MIN_GALLOP && count2 < MIN_GALLOP) {
+                    break;
+                }
+            }
+            if (!done) {
+                min_gallop += 2;
+            }
+        }
+        this->min_gallop_ = std::max<size_t>(min_gallop, 1);
+
+        if (length2 == 1) {
+            dest -= static_cast<std::ptrdiff_t>(length1);
+            cursor1 -= static_cast<std::ptrdiff_t>(length1);
+            std::move_backward(a + (cursor1 + 1), a + (cursor1 + 1) + length1, a + (dest + 1) + length1);
+            a[dest] = std::move(buffer[cursor2]); // Run 2's first element is the smallest
+        } else if (length2 == 0) {
+            throwInconsistentComparator();
+        } else {
+            std::move(buffer, buffer + length2, a + (dest - static_cast<std::ptrdiff_t>(length2) + 1));
+        }
+    }
+};
+
+template <typename T, typename Compare>
+void TimSorter::sortRange(std::vector<T>& items, Compare& compare) {
+    const size_t n = items.size();
+    if (n < 2) {
+        return;
+    }
+    if (n < MIN_MERGE) {
+        const size_t run_length = countRunAndMakeAscending(items, 0, n, compare);
+        binaryInsertionSort(items, 0, n, run_length, compare);
+        return;
+    }
+
+    MergeState<T, Compare> state(items, compare);
+    const size_t min_run = minRunLength(n);
+    size_t lo = 0;
+    while (lo < n) {
+        size_t run_length = countRunAndMakeAscending(items, lo, n, compare);
+        if (run_length < min_run) {
+            const size_t forced = std::min(n - lo, min_run);
+            binaryInsertionSort(items, lo, lo + forced, lo + run_length, compare);
+            run_length = forced;
+        }
+        state.pushRun(lo, run_length);
+        state.mergeCollapse();
+        lo += run_length;
+    }
+    state.mergeForceCollapse();
+}
+
+template <typename T, typename Compare>
+size_t TimSorter::countRunAndMakeAscending(std::vector<T>& items, size_t lo, size_t hi, Compare& compare) {
+    size_t run_hi = lo + 1;
+    if (run_hi == hi) {
+        return 1;
+    }
+    if (compare(items[run_hi++], items[lo])) { // Strictly descending
+        while (run_hi < hi && compare(items[run_hi], items[run_hi - 1])) {
+            ++run_hi;
+        }
+        std::reverse(items.begin() + static_cast<std::ptrdiff_t>(lo), items.begin() + static_cast<std::ptrdiff_t>(run_hi));
+    } else { // Non-descending
+        while (run_hi < hi && !compare(items[run_hi], items[run_hi - 1])) {
+            ++run_hi;
+        }
+    }
+    return run_hi - lo;
+}
+
+template <typename T, typename Compare>
+void TimSorter::binaryInsertionSort(std::vector<T>& items, size_t lo, size_t hi, size_t start, Compare& compare) {
+    for (; start < hi; ++start) {
+        T pivot = std::move(items[start]);
+        size_t left = lo;
+        size_t right = start;
+        while (left < right) { // Insert after equal elements: stable
+            const size_t mid = left + (right - left) / 2;
+            if (compare(pivot, items[mid])) {
+                right = mid;
+            } else {
+                left = mid + 1;
+            }
+        }
+        std::move_backward(items.begin() + static_cast<std::ptrdiff_t>(left),
+                           items.begin() + static_cast<std::ptrdiff_t>(start),
+                           items.begin() + static_cast<std::ptrdiff_t>(start) + 1);
+        items[left] = std::move(pivot);
+    }
+}
+
+template <typename T, typename Compare>
+size_t TimSorter::gallopLeft(const T& key, const T* a, size_t length, size_t hint, Compare& compare) {
+    // Exponential search from hint brackets the answer in (last_offset, offset], then binary search.
+    std::ptrdiff_t last_offset = 0;
+    std::ptrdiff_t offset = 1;
+    const auto signed_hint = static_cast<std::ptrdiff_t>(hint);
+    if (compare(a[hint], key)) { // Answer is right of hint
+        const auto max_offset = static_cast<std::ptrdiff_t>(length) - signed_hint;
+        while (offset < max_offset && compare(a[signed_hint + offset], key)) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        offset = std::min(offset, max_offset);
+        last_offset += signed_hint;
+        offset += signed_hint;
+    } else { // Answer is at or left of hint
+        const std::ptrdiff_t max_offset = signed_hint + 1;
+        while (offset < max_offset && !compare(a[signed_hint - offset], key)) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        offset = std::min(offset, max_offset);
+        const std::ptrdiff_t previous = last_offset;
+        last_offset = signed_hint - offset;
+        offset = signed_hint - previous;
+    }
+
+    ++last_offset;
+    while (last_offset < offset) {
+        const std::ptrdiff_t mid = last_offset + (offset - last_offset) / 2;
+        if (compare(a[mid], key)) {
+            last_offset = mid + 1;
+        } else {
+            offset = mid;
+        }
+    }
+    return static_cast<size_t>(offset);
+}
+
+template <typename T, typename Compare>
+size_t TimSorter::gallopRight(const T& key, const T* a, size_t length, size_t hint, Compare& compare) {
+    std::ptrdiff_t last_offset = 0;
+    std::ptrdiff_t offset = 1;
+    const auto signed_hint = static_cast<std::ptrdiff_t>(hint);
+    if (compare(key, a[hint])) { // Answer is at or left of hint
+        const std::ptrdiff_t max_offset = signed_hint + 1;
+        while (offset < max_offset && compare(key, a[signed_hint - offset])) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        offset = std::min(offset, max_offset);
+        const std::ptrdiff_t previous = last_offset;
+        last_offset = signed_hint - offset;
+        offset = signed_hint - previous;
+    } else { // Answer is right of hint
+        const auto max_offset = static_cast<std::ptrdiff_t>(length) - signed_hint;
+        while (offset < max_offset && !compare(key, a[signed_hint + offset])) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        offset = std::min(offset, max_offset);
+        last_offset += signed_hint;
+        offset += signed_hint;
+    }
+
+    ++last_offset;
+    while (last_offset < offset) {
+        const std::ptrdiff_t mid = last_offset + (offset - last_offset) / 2;
+        if (compare(key, a[mid])) {
+            offset = mid;
+        } else {
+            last_offset = mid + 1;
+        }
+    }
+    return static_cast<size_t>(offset);
+}
+
+#endif // TIM_SORTER_HPP
@@ -6,6 +6,7 @@
 #define CITY_HPP
 
 #include <string>
+#include <cstdint>
 #include <iostream> // Optional: for easy printing/debugging
 
 struct City {
@@ -14,6 +15,11 @@ struct City {
     double lat{};
     double lng{};
     long population{};
+    // Dictionary code of `country` (see CountryDictionary); codes follow the sorted order
+    // of the country names. 0 means "not interned": compare the strings instead.
+    // It is kept alongside the string, so with padding it adds 8 bytes to every City;
+    // only CityTable stores codes instead of strings.
+    std::uint16_t country_code{};
 
     // Overload ostream operator for printing of City objects
     friend std::ostream& operator<<(std::ostream& os, const City& city) {
@@ -0,0 +1,83 @@
+//
+// Binary columnar snapshot of a parsed city dataset.
+//
+
+#ifndef CITY_SNAPSHOT_HPP
+#define CITY_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <city.hpp>
+#include <mapped_file.hpp>
+
+/**
+ * @class CitySnapshot
+ * @brief Read-only, memory-mapped view of a city dataset saved in binary columnar form.
+ *
+ * File layout (native byte order, every section 8-byte aligned):
+ *   - Header: magic "CITYSNAP", format version, byte-order mark, row count, the size
+ *     and modification time of the CSV it was built from, and section offsets.
+ *   - lat, lng:        row_count doubles each
+ *   - population:      row_count int64 values
+ *   - name offsets:    row_count + 1 uint32 offsets into the string heap
+ *   - country offsets: row_count + 1 uint32 offsets into the string heap
+ *   - string heap:     the name and country bytes, not NUL terminated
+ *
+ * Opening a snapshot only maps and validates it; columns are read in place, so
+ * accessors cost nothing beyond the page faults. toCities() materialises City objects
+ * for the existing vector-based pipeline.
+ *
+ * Exceptions:
+ *   - The constructor throws std::runtime_error if the file can't be mapped, or if it
+ *     is not a snapshot of a supported version and byte order, is truncated, has a
+ *     misaligned section, or has a string offset outside the heap.
+ *   - write() throws std::runtime_error if the file can't be written.
+ */
+class CitySnapshot {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Identifies the CSV a snapshot was built from; a snapshot is stale if these differ.
+    struct SourceInfo {
+        uint64_t size = 0;
+        int64_t  mtime = 0; // Filesystem clock ticks since its epoch
+
+        bool operator==(const SourceInfo& other) const { return size == other.size && mtime == other.mtime; }
+        bool operator!=(const SourceInfo& other) const { return !(*this == other); }
+    };
+
+    explicit CitySnapshot(const std::string& snapshot_path);
+
+    // Size and mtime of a file. Throws std::runtime_error if it doesn't exist.
+    static SourceInfo describeSource(const std::string& csv_path);
+
+    // Writes cities to snapshot_path (via a temporary file that is renamed into place).
+    static void write(const std::string& snapshot_path, const std::vector<City>& cities, const SourceInfo& source);
+
+    [[nodiscard]] const SourceInfo& source() const { return source_; }
+    [[nodiscard]] bool isFreshFor(const SourceInfo& source) const { return source_ == source; }
+
+    [[nodiscard]] size_t size() const { return row_count_; }
+    [[nodiscard]] double lat(size_t row) const { return lat_[row]; }
+    [[nodiscard]] double lng(size_t row) const { return lng_[row]; }
+    [[nodiscard]] long population(size_t row) const { return static_cast<long>(population_[row]); }
+    [[nodiscard]] std::string_view name(size_t row) const;
+    [[nodiscard]] std::string_view country(size_t row) const;
+
+    [[nodiscard]] std::vector<City> toCities() const;
+
+private:
+    MappedFile file_;
+    SourceInfo source_;
+    size_t row_count_ = 0;
+    const double* lat_ = nullptr;
+    const double* lng_ = nullptr;
+    const int64_t* population_ = nullptr;
+    const uint32_t* name_offsets_ = nullptr;
+    const uint32_t* country_offsets_ = nullptr;
+    const char* heap_ = nullptr;
+};
+
+#endif // CITY_SNAPSHOT_HPP
@@ -0,0 +1,72 @@
+//
+// Structure-of-arrays container for city data.
+//
+
+#ifndef CITY_TABLE_HPP
+#define CITY_TABLE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <city.hpp>
+#include <country_dictionary.hpp>
+#include <sort_key.hpp>
+
+/**
+ * @class CityTable
+ * @brief Stores a city dataset column by column instead of as a vector of City structs.
+ *
+ * Each City field lives in its own contiguous vector, so sorting by one key only
+ * touches that key's column: sortPermutation() reads just the key column and returns
+ * the sorted row order, and applyPermutation() moves each column once at the end.
+ * With the AoS std::vector<City>, every swap during a sort drags both strings and all
+ * scalars of a ~96 byte City through the cache instead.
+ *
+ * The country column is dictionary encoded: each row stores a 16-bit code (see
+ * CountryDictionary) and the distinct names are kept once, so sorting by country is
+ * an integer sort and the column costs 2 bytes per row.
+ *
+ * Keys are SortKey values, as for Sorter::sortByKey(); parseSortKey() maps the CLI names.
+ *
+ * Exceptions:
+ *   - applyPermutation() throws std::invalid_argument if the permutation has the wrong size.
+ */
+class CityTable {
+public:
+    CityTable() = default;
+
+    static CityTable fromCities(const std::vector<City>& cities);
+    [[nodiscard]] std::vector<City> toCities() const;
+
+
+    [[nodiscard]] size_t size() const { return populations_.size(); }
+    [[nodiscard]] bool empty() const { return populations_.empty(); }
+    [[nodiscard]] City row(size_t index) const;
+
+    [[nodiscard]] const std::vector<std::string>& names() const { return names_; }
+    [[nodiscard]] const std::string& country(size_t index) const { return dictionary_.nameOf(country_codes_[index]); }
+    [[nodiscard]] const std::vector<CountryDictionary::Code>& countryCodes() const { return country_codes_; }
+    [[nodiscard]] const CountryDictionary& countryDictionary() const { return dictionary_; }
+    [[nodiscard]] const std::vector<double>& lats() const { return lats_; }
+    [[nodiscard]] const std::vector<double>& lngs() const { return lngs_; }
+    [[nodiscard]] const std::vector<long>& populations() const { return populations_; }
+
+    // Stable sorted row order for key; result[i] is the original index of the i-th row.
+    [[nodiscard]] std::vector<uint32_t> sortPermutation(SortKey key, bool reverse_order) const;
+
+    // Reorders all columns so that new row i is old row permutation[i].
+    void applyPermutation(const std::vector<uint32_t>& permutation);
+
+    // sortPermutation() followed by applyPermutation().
+    void sortBy(SortKey key, bool reverse_order);
+
+private:
+    std::vector<std::string> names_;
+    std::vector<CountryDictionary::Code> country_codes_;
+    CountryDictionary dictionary_;
+    std::vector<double> lats_;
+    std::vector<double> lngs_;
+    std::vector<long> populations_;
+};
+
+#endif // CITY_TABLE_HPP
@@ -25,6 +25,18 @@
  * @method getKey() Returns the selected key as a string.
  * @method isReverseOrder() Returns true if reverse order is enabled.
  * @method getLimitRows() Returns an optional integer specifying row limit, if set.
+ * @method getThreadCount() Returns the number of worker threads requested with -j (default 1).
+ * @method isSnapshotEnabled() Returns true if --snapshot was given.
+ * @method isIndexSortMode() Returns true if -I/--index-sort was given.
+ * @method isFullSortMode() Returns true if --full-sort was given (no top-K shortcut for -n).
+ * @method isExternalSortMode() Returns true if --external was given.
+ * @method getMemoryBudgetMiB() Returns the external sort memory budget in MiB (--memory-budget, default 64).
+ * @method isServeMode() Returns true if --serve was given (sort server on a Unix domain socket).
+ * @method isClientMode() Returns true if --client was given (one query to a running server).
+ * @method isLoadTestMode() Returns true if --load-test was given (load generator against a running server).
+ * @method getSocketPath() Returns the server socket path (--socket, default "citysort.sock").
+ * @method getRequestCount() Returns the number of queries --load-test sends (--requests, default 1000).
+ * @method isCacheEnabled() Returns true if --cache was given (sorted orders kept in <csv>.perm).
  * @method printUsage() Prints usage information for the program.
  * @method isPerformanceTestMode() Returns true if performance test mode is enabled.
  * @method getValidAlgorithms() Returns a list of valid algorithm names.
@@ -36,13 +48,25 @@
  * @var reverse_order_ Indicates if reverse order is enabled.
  * @var performance_test_mode_ Indicates if performance test mode is enabled.
  * @var limit_rows_ Stores the optional row limit.
+ * @var thread_count_ Stores the number of worker threads.
+ * @var snapshot_enabled_ Indicates if the binary dataset snapshot should be used.
+ * @var index_sort_mode_ Indicates if rows should be sorted by index instead of moving City objects.
+ * @var full_sort_mode_ Indicates if the whole dataset must be sorted even when -n limits the output.
+ * @var external_sort_mode_ Indicates if the CSV should be sorted out of core (ExternalSorter).
+ * @var memory_budget_mib_ Stores the external sort memory budget in MiB.
+ * @var serve_mode_ Indicates if the program should run as a sort server.
+ * @var client_mode_ Indicates if the query should be sent to a sort server.
+ * @var load_test_mode_ Indicates if a sort server should be load tested.
+ * @var socket_path_ Stores the sort server socket path.
+ * @var request_count_ Stores the number of load test queries.
+ * @var cache_enabled_ Indicates if sorted orders should be cached (PermutationCache).
  * @var valid_algorithms_ Static list of valid algorithms.
  * @var valid_keys_ Static list of valid keys.
  *
  * @private
  * @method parseArguments() Parses and validates command-line arguments.
  * @method isValidAlgorithm() Checks if a given algorithm is valid.
- * @method isValidKey() Checks if a given key is valid.
+ * @method isValidKey() Checks if a given key, or comma-separated key list, is valid.
  */
 class CliParser {
 public:
@@ -52,6 +76,18 @@ public:
     [[nodiscard]] const std::string& getKey() const;
     [[nodiscard]] bool isReverseOrder() const;
     [[nodiscard]] std::optional<int> getLimitRows() const;
+    [[nodiscard]] int getThreadCount() const;
+    [[nodiscard]] bool isSnapshotEnabled() const;
+    [[nodiscard]] bool isIndexSortMode() const;
+    [[nodiscard]] bool isFullSortMode() const;
+    [[nodiscard]] bool isExternalSortMode() const;
+    [[nodiscard]] int getMemoryBudgetMiB() const;
+    [[nodiscard]] bool isServeMode() const;
+    [[nodiscard]] bool isClientMode() const;
+    [[nodiscard]] bool isLoadTestMode() const;
+    [[nodiscard]] const std::string& getSocketPath() const;
+    [[nodiscard]] int getRequestCount() const;
+    [[nodiscard]] bool isCacheEnabled() const;
 
     static void printUsage(const char* programName);
     [[nodiscard]] bool isPerformanceTestMode() const;
@@ -64,6 +100,18 @@ private:
     bool reverse_order_ = false;
     bool performance_test_mode_ = false;
     std::optional<int> limit_rows_;
+    int thread_count_ = 1;
+    bool snapshot_enabled_ = false;
+    bool index_sort_mode_ = false;
+    bool full_sort_mode_ = false;
+    bool external_sort_mode_ = false;
+    int memory_budget_mib_ = 64;
+    bool serve_mode_ = false;
+    bool client_mode_ = false;
+    bool load_test_mode_ = false;
+    std::string socket_path_ = "citysort.sock";
+    int request_count_ = 1000;
+    bool cache_enabled_ = false;
 
     static const std::vector<std::string> valid_algorithms_;
     static const std::vector<std::string> valid_keys_;
@@ -0,0 +1,172 @@
+//
+// Composite sort keys (e.g. "country,-population,name") and their comparators.
+//
+
+#ifndef COMPOSITE_KEY_HPP
+#define COMPOSITE_KEY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "city.hpp"
+#include "sort_key.hpp"
+
+/**
+ * @brief One column of a composite key and its direction.
+ */
+struct KeyField {
+    SortKey key;
+    bool descending = false;
+};
+
+/**
+ * @brief Columns in priority order: later fields only order rows that are equal on
+ *        all earlier ones.
+ */
+using CompositeKey = std::vector<KeyField>;
+
+/**
+ * @brief Parses a comma-separated key list; a leading '-' makes a field descending.
+ *        "population" and "country,-population,name" are both valid.
+ * @throws std::invalid_argument on an empty list or field, an unknown key, or a
+ *         key that appears twice.
+ */
+CompositeKey parseCompositeKey(const std::string& spec);
+
+/**
+ * @brief Returns the CLI spelling of a composite key (inverse of parseCompositeKey()).
+ */
+std::string compositeKeyName(const CompositeKey& keys);
+
+/**
+ * @brief Fused comparator for a composite key.
+ *
+ * Each field is a three-way column compare picked once, at construction, from a
+ * per-key table; a comparison walks the fields until one differs. A pair of cities
+ * is therefore compared in one pass instead of one stable sort per field.
+ * reverse_order flips every field, as -r does for a single key.
+ */
+class CompositeLess {
+public:
+    CompositeLess() = default;
+    CompositeLess(const CompositeKey& keys, bool reverse_order);
+
+    bool operator()(const City& a, const City& b) const {
+        for (size_t i = 0; i < this->field_count_; ++i) {
+            const int order = this->fields_[i].compare(a, b);
+            if (order != 0) {
+                return this->fields_[i].descending ? order > 0 : order < 0;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool empty() const { return this->field_count_ == 0; }
+
+private:
+    struct Field {
+        int (*compare)(const City&, const City&); // <0, 0, >0 like std::string::compare
+        bool descending;
+    };
+
+    // Keys cannot repeat, so there are at most SORT_KEY_COUNT fields.
+    std::array<Field, SORT_KEY_COUNT> fields_{};
+    size_t field_count_ = 0;
+};
+
+/**
+ * @brief Comparator for a composite key as a Sorter::Comparator. A single field gets
+ *        the plain createKeyComparator() comparator.
+ */
+std::function<bool(const City&, const City&)> createCompositeComparator(const CompositeKey& keys, bool reverse_order);
+
+/**
+ * @brief A row reduced to an unsigned key whose order is the composite order of its
+ *        packed fields.
+ */
+struct PackedRow {
+    std::uint64_t key;
+    std::uint32_t index;
+};
+
+/**
+ * @brief Orders PackedRows by key alone (every field was packed).
+ */
+struct PackedRowLess {
+    // One integer compare: cheap enough for branch-free partitioning.
+    static constexpr bool numeric_key = true;
+
+    bool operator()(const PackedRow& a, const PackedRow& b) const {
+        return a.key < b.key;
+    }
+};
+
+/**
+ * @brief Orders PackedRows by key, then by the fields that did not fit in the key.
+ */
+struct PackedRowTailLess {
+    const std::vector<City>& cities;
+    const CompositeLess& tail;
+
+    bool operator()(const PackedRow& a, const PackedRow& b) const {
+        if (a.key != b.key) {
+            return a.key < b.key;
+        }
+        return tail(cities[a.index], cities[b.index]);
+    }
+};
+
+/**
+ * @brief First 8 bytes of a string as a big-endian integer, zero-padded.
+ *
+ * stringPrefixKey(a) < stringPrefixKey(b) implies a < b; equal prefixes say nothing,
+ * so a string packed this way still needs the full compare on ties.
+ */
+std::uint64_t stringPrefixKey(std::string_view text);
+
+/**
+ * @brief Leading fields of a composite key packed into one 64-bit key per row.
+ *
+ * rows[i] is row i of the dataset. packed_fields is how many fields went into the
+ * key; 0 means none fit and rows is empty. tail compares the fields the key does
+ * not settle: those that did not fit, plus a string field packed as a prefix.
+ */
+struct PackedCompositeKeys {
+    std::vector<PackedRow> rows;
+    size_t packed_fields = 0;
+    CompositeLess tail;
+};
+
+/**
+ * @brief Packs as many leading fields of `keys` as fit into 64 bits.
+ *
+ * Every field is mapped to an order-preserving unsigned value: numeric columns
+ * through orderedKeyBits(), country through its dictionary code when every row has
+ * one, and name (or an uninterned country) through stringPrefixKey(). Values are
+ * complemented when the field sorts descending and rebased on their minimum, so a
+ * field only takes as many bits as its range needs (a prefix shared by every row
+ * costs nothing). Fields are concatenated, the first one in the most significant
+ * bits; a string prefix is always the last field packed.
+ *
+ * Sorting the rows compares 16-byte records instead of City objects, and only
+ * dereferences a row (through the tail) when two keys are equal.
+ *
+ * @throws std::length_error if cities has 2^32 or more rows.
+ */
+PackedCompositeKeys packCompositeKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order);
+
+/**
+ * @brief Reorders `cities` into the order of sorted packed rows (moves, no copies).
+ */
+void applyPackedOrder(std::vector<City>& cities, const std::vector<PackedRow>& rows);
+
+/**
+ * @brief The row indices of sorted packed rows.
+ */
+std::vector<std::uint32_t> packedRowIndices(const std::vector<PackedRow>& rows);
+
+#endif // COMPOSITE_KEY_HPP
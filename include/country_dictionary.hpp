@@ -0,0 +1,54 @@
+//
+// Dictionary encoding for the low-cardinality City::country column.
+//
+
+#ifndef COUNTRY_DICTIONARY_HPP
+#define COUNTRY_DICTIONARY_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <city.hpp>
+
+/**
+ * @class CountryDictionary
+ * @brief Maps each distinct country name to a 16-bit code.
+ *
+ * Codes are assigned in sorted (byte-wise) order of the names, starting at 1, so
+ * comparing two codes gives the same order as comparing the two country strings.
+ * Code 0 (UNASSIGNED) means "not interned"; comparators must fall back to the
+ * strings when either side is unassigned.
+ *
+ * Lookups binary-search the sorted names (~8 compares for ~240 countries), which also
+ * keeps the dictionary trivially copyable and movable.
+ *
+ * If a dataset has more distinct countries than fit in 16 bits, no codes are assigned
+ * and the dictionary stays empty; everything keeps working through string compares.
+ */
+class CountryDictionary {
+public:
+    using Code = std::uint16_t;
+    static constexpr Code UNASSIGNED = 0;
+
+    CountryDictionary() = default;
+
+    // Builds a dictionary from the distinct countries of `cities` without touching them.
+    static CountryDictionary build(const std::vector<City>& cities);
+
+    // Same as build(), and also stores each city's code in City::country_code.
+    static CountryDictionary encode(std::vector<City>& cities);
+
+    [[nodiscard]] Code codeOf(std::string_view country) const;
+    [[nodiscard]] const std::string& nameOf(Code code) const;
+    [[nodiscard]] size_t size() const { return names_.size(); }
+    [[nodiscard]] bool empty() const { return names_.empty(); }
+
+    // Approximate heap footprint of the dictionary itself.
+    [[nodiscard]] size_t memoryBytes() const;
+
+private:
+    std::vector<std::string> names_; // Sorted; names_[code - 1]
+};
+
+#endif // COUNTRY_DICTIONARY_HPP
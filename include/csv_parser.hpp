@@ -11,6 +11,7 @@
 #include <vector>
 #include <fstream>
 #include <stdexcept>
+#include <cstdint>
 
 using CsvRow = std::vector<std::string>;
 
@@ -26,6 +27,9 @@ using CsvRow = std::vector<std::string>;
  * @brief Constructs a CsvReader for the specified file and delimiter.
  * @param filename The path to the CSV file to read.
  * @param delimiter The character used to separate fields in the CSV file (default is ',').
+ * @param backend How lines are split into fields: the original byte-by-byte loop (Scalar)
+ *        or the vectorized structural-character scanner from csv_scan.hpp (Simd).
+ *        Both produce identical rows.
  */
  
 /**
@@ -46,7 +50,12 @@ using CsvRow = std::vector<std::string>;
  */
 class CsvReader {
 public:
-    explicit CsvReader(std::string  filename, char delimiter = ',');
+    enum class ParseBackend {
+        Scalar, // Walks every byte and builds fields in a std::stringstream
+        Simd    // Jumps between delimiter/quote offsets found by csv_scan
+    };
+
+    explicit CsvReader(std::string  filename, char delimiter = ',', ParseBackend backend = ParseBackend::Scalar);
     ~CsvReader() = default;
 
     CsvReader(const CsvReader&) = delete;
@@ -60,10 +69,14 @@ public:
 private:
     std::string filename_;
     char        delimiter_;
+    ParseBackend backend_;
     std::ifstream fileStream_;
     bool        isOpen_ = false;
+    mutable std::vector<uint32_t> structuralOffsets_; // Scratch space for the Simd backend
 
     void parseLine(const std::string& line, CsvRow& row) const;
+    void parseLineScalar(const std::string& line, CsvRow& row) const;
+    void parseLineSimd(const std::string& line, CsvRow& row) const;
 };
 
 #endif // CSVREADER_HPP
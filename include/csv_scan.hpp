@@ -0,0 +1,54 @@
+//
+// Vectorized scanning of CSV structural characters (delimiter, quote, newline).
+//
+
+#ifndef CSV_SCAN_HPP
+#define CSV_SCAN_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace csv_scan
+ * @brief Kernels that locate CSV structural characters 16/32 bytes at a time.
+ *
+ * A "structural" character is the field delimiter, a double quote or '\n'. The
+ * kernels only find their positions; interpreting them (quoting, escapes) is left to
+ * the callers, CsvReader and CsvViewReader.
+ *
+ * Three kernels exist: a portable scalar loop, SSE2 (16 bytes per step, baseline on
+ * x86-64) and AVX2 (32 bytes per step). The best kernel supported by the running CPU
+ * is picked once at startup; setKernel() overrides the choice, e.g. for benchmarks.
+ */
+namespace csv_scan {
+
+    enum class Kernel {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    // Returns a pointer to the first structural character in [begin, end), or end.
+    const char* findStructural(const char* begin, const char* end, char delimiter);
+
+    // Appends the offsets (relative to data.data()) of every structural character in data.
+    // Returns the number of offsets appended.
+    size_t scanStructural(std::string_view data, char delimiter, std::vector<uint32_t>& offsets);
+
+    // The kernel currently used by findStructural/scanStructural.
+    Kernel activeKernel();
+
+    // True if the running CPU (and this build) can execute the given kernel.
+    bool isSupported(Kernel kernel);
+
+    // Forces a kernel. Returns false (and leaves the active kernel unchanged) if unsupported.
+    bool setKernel(Kernel kernel);
+
+    // Short lowercase name of a kernel ("scalar", "sse2", "avx2").
+    std::string kernelName(Kernel kernel);
+
+} // namespace csv_scan
+
+#endif // CSV_SCAN_HPP
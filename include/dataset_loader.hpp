@@ -5,10 +5,15 @@
 #ifndef DATASET_LOADER_HPP
 #define DATASET_LOADER_HPP
 
+#include <array>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <city.hpp>        // Definition of the City struct
 #include <csv_parser.hpp>  // Your CsvReader class
+#include <city_snapshot.hpp> // Binary columnar snapshot
+#include <country_dictionary.hpp> // Interned country codes
 
 /**
  * @class DatasetLoader
@@ -27,14 +32,74 @@
  *   - 'city_ascii' is used for the city name.
  *   - Rows with missing population data are skipped.
  *   - Malformed rows (less than EXPECTED_MIN_COLUMNS) are ignored.
+ *   - Rows with a non-numeric or out-of-range population, lat or lng are skipped.
+ *   Numeric fields are decoded without exceptions (see field_decoder.hpp). Skipped
+ *   rows are counted per reason in LoadStats and reported in one summary line.
+ *
+ * Backends:
+ *   - CsvBackend::Mmap (default) maps the file and parses fields as string views
+ *     (see MmapCsvReader); no per-field strings are built.
+ *   - CsvBackend::Stream reads line by line through CsvReader.
+ *
+ * Parallel loading:
+ *   - With the Mmap backend, setThreadCount(n > 1) splits the file body into n
+ *     record-aligned byte ranges (see splitAtRecordBoundaries), parses each range
+ *     on its own thread and concatenates the results in file order. The skip rules
+ *     are the same as for sequential loading. The Stream backend is always sequential.
+ *
+ * Country dictionary:
+ *   - After every load the distinct countries are interned into a CountryDictionary
+ *     and each City::country_code is set, so sorting by country can compare 16-bit
+ *     codes instead of strings.
+ *
+ * Streaming:
+ *   - streamCities() reads the CSV row by row (always with CsvReader) and hands each
+ *     City to a callback instead of collecting them, so memory use does not grow with
+ *     the file. Skip rules and LoadStats are the same; no snapshot or country dictionary
+ *     is used. ExternalSorter is fed this way.
+ *
+ * Snapshots:
+ *   - With setSnapshotEnabled(true), a binary columnar snapshot (see CitySnapshot) is
+ *     kept next to the CSV as "<csv path>.snap". If it exists and was built from a CSV
+ *     with the same size and mtime, it is mapped and the CSV is not parsed at all;
+ *     otherwise the CSV is parsed and the snapshot is (re)written.
  *
  * Exceptions:
  *   - Throws std::runtime_error if the file cannot be opened or if critical parsing errors occur.
  */
 class DatasetLoader {
 public:
+    // Why a data row was not turned into a City.
+    enum class SkipReason {
+        None,                 // Row was loaded
+        TooFewColumns,
+        MissingPopulation,
+        InvalidPopulation,
+        PopulationOutOfRange,
+        MissingCoordinates,   // Empty lat or lng
+        InvalidCoordinates    // Non-numeric or out-of-range lat or lng
+    };
+    static constexpr size_t SKIP_REASON_COUNT = 7;
+
+    // Row counts of the most recent loadAndParseCities() call.
+    struct LoadStats {
+        size_t loaded = 0;
+        std::array<size_t, SKIP_REASON_COUNT> skipped{}; // Indexed by SkipReason
+
+        [[nodiscard]] size_t totalSkipped() const;
+        void merge(const LoadStats& other);
+        // e.g. "Skipped 12 rows (missing population: 10, invalid lat/lng: 2)."
+        [[nodiscard]] std::string summary() const;
+    };
+
+    // Which CSV reader is used to read the file.
+    enum class CsvBackend {
+        Stream, // CsvReader: std::getline + owned strings per field
+        Mmap    // MmapCsvReader: memory-mapped file + string_view fields
+    };
+
     // Constructor: takes the path to the CSV file.
-    explicit DatasetLoader(std::string  csv_filepath);
+    explicit DatasetLoader(std::string  csv_filepath, CsvBackend backend = CsvBackend::Mmap);
 
     // Main method to load data from the CSV file.
     // It reads rows, parses them into City objects,
@@ -42,8 +107,44 @@ public:
     // Throws std::runtime_error if the file cannot be opened or critical parsing fails.
     std::vector<City> loadAndParseCities();
 
+    // Parses the CSV row by row and passes every loaded City to `consume` without keeping it.
+    // Returns the number of cities passed. Throws std::runtime_error if the file cannot be opened.
+    size_t streamCities(const std::function<void(City&&)>& consume);
+
+    // Per-reason skip counts of the last load.
+    [[nodiscard]] const LoadStats& getLastLoadStats() const;
+
+    // Dictionary built for the cities returned by the last loadAndParseCities() call.
+    [[nodiscard]] const CountryDictionary& getCountryDictionary() const;
+
+    // Use (and maintain) a binary snapshot next to the CSV. Off by default.
+    void setSnapshotEnabled(bool enabled);
+    [[nodiscard]] bool isSnapshotEnabled() const;
+    [[nodiscard]] std::string getSnapshotPath() const;
+    // True if the last loadAndParseCities() call was served from the snapshot.
+    [[nodiscard]] bool lastLoadUsedSnapshot() const;
+
+    // Number of threads used to parse the file (Mmap backend only). 0 is treated as 1.
+    void setThreadCount(unsigned int thread_count);
+    [[nodiscard]] unsigned int getThreadCount() const;
+
 private:
     std::string filepath_;
+    CsvBackend backend_;
+    unsigned int thread_count_ = 1;
+    LoadStats last_stats_;
+    bool snapshot_enabled_ = false;
+    bool last_load_used_snapshot_ = false;
+    CountryDictionary country_dictionary_;
+
+    std::vector<City> loadWithStreamReader();
+    // Feeds every parsed row of the CSV to `consume`, counting skipped rows in last_stats_.
+    void readWithStreamReader(const std::function<void(City&&)>& consume);
+    std::vector<City> loadWithMmapReader();
+    std::optional<std::vector<City>> loadFromSnapshot(const CitySnapshot::SourceInfo& source) const;
+
+    template <typename Row>
+    static SkipReason parseCityRow(const Row& row, City& city);
 
     // city,city_ascii,lat,lng,country,iso2,iso3,admin_name,capital,population,id
     // We'll use 'city_ascii' for name as it's often cleaner.
@@ -0,0 +1,114 @@
+//
+// External merge sort: sorted runs spilled to temporary files, merged with a loser tree.
+//
+
+#ifndef EXTERNAL_SORTER_HPP
+#define EXTERNAL_SORTER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <city.hpp>
+#include <sorter.hpp>
+#include <sort_key.hpp>
+#include <composite_key.hpp>
+
+/**
+ * @class ExternalSorter
+ * @brief Sorts more cities than fit in memory by spilling sorted runs to disk.
+ *
+ * Usage:
+ *   - add() every city (e.g. from DatasetLoader::streamCities()), then call finish(),
+ *     then read the sorted cities with next() until it returns false.
+ *
+ * Run generation:
+ *   - add() collects cities in a chunk. A quarter of the memory budget holds the chunk's
+ *     City array and another quarter its string bytes; the other half is left for the
+ *     Sorter's scratch space (merge sorts copy the chunk) and the run writer.
+ *   - A full chunk is sorted with the given Sorter (sortByKeys) and written to a run file
+ *     in the temp directory: "CITYRUN1", then per city the name and country lengths
+ *     (uint16), lat, lng (double), population (int64) and the string bytes.
+ *   - If all cities fit in one chunk, nothing is written: it is sorted in memory.
+ *
+ * Merging:
+ *   - Each open run costs one MERGE_BUFFER_BYTES read buffer, so at most
+ *     budget / MERGE_BUFFER_BYTES - 1 runs (capped at MAX_FAN_IN for file handles) are
+ *     merged at once. finish() merges consecutive groups of runs into longer runs until
+ *     that many remain; the final merge is streamed by next().
+ *   - Merges use a LoserTree. Ties go to the earlier run, so the result is stable
+ *     whenever the chunk Sorter is.
+ *
+ * Run files are removed once merged, and all remaining ones by the destructor.
+ *
+ * Exceptions:
+ *   - The constructor throws std::invalid_argument if the budget is below MIN_MEMORY_BUDGET.
+ *   - Run file I/O failures throw std::runtime_error.
+ */
+class ExternalSorter {
+public:
+    static constexpr size_t MIN_MEMORY_BUDGET = size_t{1} << 20;   // 1 MiB
+    static constexpr size_t MERGE_BUFFER_BYTES = size_t{64} << 10; // Per open run file
+    static constexpr size_t MAX_FAN_IN = 128;
+
+    struct Stats {
+        size_t rows = 0;
+        size_t initial_runs = 0;   // Runs written by run generation (0: sorted in memory)
+        size_t merge_passes = 0;   // Intermediate passes before the final merge
+        size_t max_fan_in = 0;     // Runs merged at once
+        size_t spilled_bytes = 0;  // Bytes written to run files over all passes
+    };
+
+    // An empty temp_directory means std::filesystem::temp_directory_path().
+    ExternalSorter(Sorter& sorter, SortKey key, bool reverse_order, size_t memory_budget_bytes,
+                   std::string temp_directory = "");
+    // Composite key, sorted with Sorter::sortByKeys() and merged with CompositeLess.
+    ExternalSorter(Sorter& sorter, CompositeKey keys, bool reverse_order, size_t memory_budget_bytes,
+                   std::string temp_directory = "");
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    void add(City city);
+
+    // Spills the last chunk and runs the intermediate merge passes.
+    const Stats& finish();
+
+    // Next city in sorted order; false once all have been returned. Requires finish().
+    bool next(City& city);
+
+    [[nodiscard]] const Stats& getStats() const;
+    // Most cities a chunk can hold before it is spilled.
+    [[nodiscard]] size_t getChunkRowCapacity() const;
+
+private:
+    class RunMerger;
+
+    Sorter& sorter_;
+    CompositeKey keys_;
+    bool reverse_order_;
+    Sorter::Comparator less_;
+    size_t memory_budget_;
+    std::string temp_directory_;
+    std::string run_prefix_;
+
+    std::vector<City> chunk_;
+    size_t chunk_row_capacity_;
+    size_t chunk_string_budget_;
+    size_t chunk_string_bytes_ = 0;
+
+    std::vector<std::string> runs_;       // Runs waiting to be merged, in input order
+    std::vector<std::string> temp_files_; // Every file created, for cleanup
+    std::unique_ptr<RunMerger> merger_;
+    bool finished_ = false;
+    bool in_memory_ = false;
+    size_t next_in_memory_row_ = 0;
+    Stats stats_;
+
+    void spillChunk();
+    std::string createRunPath();
+    [[nodiscard]] size_t maxFanIn() const;
+};
+
+#endif // EXTERNAL_SORTER_HPP
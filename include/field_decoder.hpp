@@ -0,0 +1,37 @@
+//
+// Allocation-free, non-throwing decoding of numeric CSV fields.
+//
+
+#ifndef FIELD_DECODER_HPP
+#define FIELD_DECODER_HPP
+
+#include <string_view>
+
+/**
+ * @brief Result of decoding a numeric field.
+ */
+enum class DecodeStatus {
+    Ok,         // The whole field was a valid number
+    Empty,      // The field was empty or only whitespace
+    Invalid,    // Not a number, or trailing characters after the number
+    OutOfRange  // A number, but it does not fit the target type
+};
+
+/**
+ * @brief Decodes a base-10 integer field into a long.
+ *
+ * Built on std::from_chars: it never allocates, never throws and ignores the locale.
+ * Leading/trailing whitespace and a leading '+' are accepted (as with std::stol);
+ * unlike std::stol, trailing non-space characters make the field Invalid.
+ * `out` is only written when the status is Ok.
+ */
+DecodeStatus decodeLong(std::string_view field, long& out);
+
+/**
+ * @brief Decodes a decimal floating point field into a double.
+ *
+ * Same rules as decodeLong, with std::from_chars in general (fixed or scientific) format.
+ */
+DecodeStatus decodeDouble(std::string_view field, double& out);
+
+#endif // FIELD_DECODER_HPP
@@ -0,0 +1,167 @@
+//
+// Sorter base that instantiates an algorithm once per key and direction.
+//
+
+#ifndef KEY_DISPATCH_SORTER_HPP
+#define KEY_DISPATCH_SORTER_HPP
+
+#include "sorter.hpp"
+#include "sort_key.hpp"
+#include "composite_key.hpp"
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief True when Derived declares `static constexpr bool packed_numeric_keys = true;`:
+ *        its sortRange() is fastest on PackedRow records (e.g. a sorting-network base
+ *        case), so numeric keys are packed too instead of using the KeyLess tables.
+ */
+template <typename Derived, typename = void>
+struct packs_numeric_keys : std::false_type {};
+
+template <typename Derived>
+struct packs_numeric_keys<Derived, std::void_t<decltype(Derived::packed_numeric_keys)>>
+    : std::bool_constant<Derived::packed_numeric_keys> {};
+
+/**
+ * @brief CRTP base for comparison sorters with a static sortRange<T, Compare>().
+ *
+ * sortByKey()/sortIndicesByKey() look up a function pointer in a table with one
+ * entry per (key, direction) pair. Each entry is Derived::sortRange instantiated
+ * with KeyLess<Key, Reverse>, so the comparison inlines into the algorithm and the
+ * runtime key/direction choice is made once per sort instead of once per comparison.
+ *
+ * The string keys (name, country) and composite keys (sortByKeys()/sortIndicesByKeys())
+ * are first reduced to one (64-bit key, row index) record per row by packCompositeKeys():
+ * names become 8-byte prefixes, so the algorithm compares integers in a compact array
+ * and only reads the strings (PackedRowTailLess) when two prefixes tie. The fused
+ * CompositeLess is used directly if no field could be packed. Sorters that opt in through
+ * packs_numeric_keys take the packed path for population/lat/lng as well.
+ *
+ * sort()/sortIndices() keep accepting any Sorter::Comparator; they instantiate the
+ * same algorithm with std::function and remain as the compatibility path.
+ *
+ * @tparam Derived The concrete sorter, providing
+ *         template <typename T, typename Compare> void sortRange(std::vector<T>&, Compare&),
+ *         either static or a member (to read per-instance settings such as a thread count).
+ */
+template <typename Derived>
+class KeyDispatchSorter : public Sorter {
+public:
+    void sort(std::vector<City>& cities, Comparator compare) override {
+        self().sortRange(cities, compare);
+    }
+
+    Permutation sortIndices(const std::vector<City>& cities, Comparator compare) override {
+        Permutation indices = identityPermutation(cities.size());
+        IndexComparator<Comparator> index_compare{cities, compare};
+        self().sortRange(indices, index_compare);
+        return indices;
+    }
+
+    void sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) override {
+        if (!isNumericKey(key) || packs_numeric_keys<Derived>::value) {
+            sortByPackedKeys(cities, CompositeKey{{key, false}}, reverse_order);
+            return;
+        }
+        city_sorters_[keyDispatchIndex(key, reverse_order)](self(), cities);
+    }
+
+    Permutation sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) override {
+        if (!isNumericKey(key) || packs_numeric_keys<Derived>::value) {
+            return sortIndicesByPackedKeys(cities, CompositeKey{{key, false}}, reverse_order);
+        }
+        Permutation indices = identityPermutation(cities.size());
+        index_sorters_[keyDispatchIndex(key, reverse_order)](self(), cities, indices);
+        return indices;
+    }
+
+    void sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override {
+        if (keys.size() == 1) {
+            sortByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+            return;
+        }
+        sortByPackedKeys(cities, keys, reverse_order);
+    }
+
+    Permutation sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) override {
+        if (keys.size() == 1) {
+            return sortIndicesByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+        }
+        return sortIndicesByPackedKeys(cities, keys, reverse_order);
+    }
+
+private:
+    using CitySortFn = void (*)(Derived&, std::vector<City>&);
+    using IndexSortFn = void (*)(Derived&, const std::vector<City>&, Permutation&);
+
+    Derived& self() {
+        return static_cast<Derived&>(*this);
+    }
+
+    void sortByPackedKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+        PackedCompositeKeys packed = packCompositeKeys(cities, keys, reverse_order);
+        if (packed.packed_fields == 0) {
+            CompositeLess less(keys, reverse_order);
+            self().sortRange(cities, less);
+            return;
+        }
+        sortPacked(cities, packed);
+        applyPackedOrder(cities, packed.rows);
+    }
+
+    Permutation sortIndicesByPackedKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+        PackedCompositeKeys packed = packCompositeKeys(cities, keys, reverse_order);
+        if (packed.packed_fields == 0) {
+            Permutation indices = identityPermutation(cities.size());
+            CompositeLess less(keys, reverse_order);
+            IndexComparator<CompositeLess> index_compare{cities, less};
+            self().sortRange(indices, index_compare);
+            return indices;
+        }
+        sortPacked(cities, packed);
+        return packedRowIndices(packed.rows);
+    }
+
+    void sortPacked(const std::vector<City>& cities, PackedCompositeKeys& packed) {
+        if (packed.tail.empty()) {
+            PackedRowLess less;
+            self().sortRange(packed.rows, less);
+        } else {
+            PackedRowTailLess less{cities, packed.tail};
+            self().sortRange(packed.rows, less);
+        }
+    }
+
+    template <SortKey Key, bool Reverse>
+    static void sortCitiesBy(Derived& sorter, std::vector<City>& cities) {
+        KeyLess<Key, Reverse> less;
+        sorter.sortRange(cities, less);
+    }
+
+    template <SortKey Key, bool Reverse>
+    static void sortIndicesBy(Derived& sorter, const std::vector<City>& cities, Permutation& indices) {
+        KeyLess<Key, Reverse> less;
+        IndexComparator<KeyLess<Key, Reverse>> index_compare{cities, less};
+        sorter.sortRange(indices, index_compare);
+    }
+
+    // Both tables are indexed by keyDispatchIndex(): [key * 2 + reverse].
+    static constexpr CitySortFn city_sorters_[SORT_KEY_COUNT * 2] = {
+        &sortCitiesBy<SortKey::Name, false>,       &sortCitiesBy<SortKey::Name, true>,
+        &sortCitiesBy<SortKey::Country, false>,    &sortCitiesBy<SortKey::Country, true>,
+        &sortCitiesBy<SortKey::Population, false>, &sortCitiesBy<SortKey::Population, true>,
+        &sortCitiesBy<SortKey::Lat, false>,        &sortCitiesBy<SortKey::Lat, true>,
+        &sortCitiesBy<SortKey::Lng, false>,        &sortCitiesBy<SortKey::Lng, true>
+    };
+
+    static constexpr IndexSortFn index_sorters_[SORT_KEY_COUNT * 2] = {
+        &sortIndicesBy<SortKey::Name, false>,       &sortIndicesBy<SortKey::Name, true>,
+        &sortIndicesBy<SortKey::Country, false>,    &sortIndicesBy<SortKey::Country, true>,
+        &sortIndicesBy<SortKey::Population, false>, &sortIndicesBy<SortKey::Population, true>,
+        &sortIndicesBy<SortKey::Lat, false>,        &sortIndicesBy<SortKey::Lat, true>,
+        &sortIndicesBy<SortKey::Lng, false>,        &sortIndicesBy<SortKey::Lng, true>
+    };
+};
+
+#endif // KEY_DISPATCH_SORTER_HPP
@@ -0,0 +1,74 @@
+//
+// Tournament (loser) tree for k-way merging.
+//
+
+#ifndef LOSER_TREE_HPP
+#define LOSER_TREE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Loser tree over `source_count` sorted sources, used for k-way merges.
+ *
+ * Sources sit at the leaves; every inner node remembers the loser of the match played
+ * there and node 0 holds the overall winner. After the winner's source advances,
+ * replay() walks only its leaf-to-root path: one comparison per level, log2(k) in
+ * total, against log2(k) * 2 for a binary heap's sift-down.
+ *
+ * @tparam Beats Callable bool(size_t a, size_t b): true if source a's current head must
+ *         be output before source b's. It has to be a strict total order over the
+ *         sources (break ties by source index for a stable merge) and should rank
+ *         exhausted sources last.
+ */
+template <typename Beats>
+class LoserTree {
+public:
+    LoserTree(size_t source_count, Beats beats) : source_count_(source_count), beats_(std::move(beats)), nodes_(source_count) {
+        if (source_count == 0) {
+            throw std::invalid_argument("LoserTree Error: At least one source is required.");
+        }
+        // Leaves are nodes [k, 2k), inner nodes [1, k). Play every match bottom-up.
+        std::vector<size_t> winners(2 * source_count);
+        for (size_t source = 0; source < source_count; ++source) {
+            winners[source_count + source] = source;
+        }
+        for (size_t node = source_count - 1; node >= 1; --node) {
+            const size_t left = winners[2 * node];
+            const size_t right = winners[2 * node + 1];
+            if (this->beats_(right, left)) {
+                winners[node] = right;
+                this->nodes_[node] = left;
+            } else {
+                winners[node] = left;
+                this->nodes_[node] = right;
+            }
+        }
+        this->nodes_[0] = source_count > 1 ? winners[1] : 0;
+    }
+
+    // Source whose head comes next.
+    [[nodiscard]] size_t winner() const {
+        return this->nodes_[0];
+    }
+
+    // Re-plays the matches of `source` (the previous winner) after its head changed.
+    void replay(size_t source) {
+        size_t winner = source;
+        for (size_t node = (source + this->source_count_) / 2; node >= 1; node /= 2) {
+            if (this->beats_(this->nodes_[node], winner)) {
+                std::swap(this->nodes_[node], winner);
+            }
+        }
+        this->nodes_[0] = winner;
+    }
+
+private:
+    size_t source_count_;
+    Beats beats_;
+    std::vector<size_t> nodes_; // [0]: winner, [1, k): loser of each match
+};
+
+#endif // LOSER_TREE_HPP
@@ -0,0 +1,49 @@
+//
+// Read-only memory mapping of a whole file, shared by the zero-copy readers.
+//
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * @brief RAII wrapper around a read-only memory mapping of an entire file.
+ *
+ * The mapping stays valid for the lifetime of the object, so views handed out
+ * by readers built on top of it (e.g. MmapCsvReader) remain valid as long as
+ * the MappedFile is alive. An empty file is represented by a null data pointer
+ * and a size of zero; no mapping is created for it.
+ *
+ * Exceptions:
+ *   - Throws std::runtime_error if the file cannot be opened or mapped.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] const char* data() const { return data_; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+
+    void release() noexcept;
+};
+
+#endif // MAPPED_FILE_HPP
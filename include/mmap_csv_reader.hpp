@@ -0,0 +1,105 @@
+//
+// Zero-copy CSV reader over a memory-mapped file, to be used by other classes
+//
+
+#ifndef MMAP_CSV_READER_HPP
+#define MMAP_CSV_READER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mapped_file.hpp>
+
+using CsvRowView = std::vector<std::string_view>;
+
+/**
+ * @class CsvViewReader
+ * @brief Parses CSV records out of an in-memory buffer it does not own.
+ *
+ * Field views point straight into the buffer, so no per-field allocation or copy
+ * happens. The only exception are quoted fields containing `""` escapes: those are
+ * unescaped into a per-row scratch buffer owned by the reader.
+ *
+ * Quoting rules follow CsvReader::parseLine: a quote opens a quoted field only at the
+ * start of a field, `""` inside quotes is an escaped quote, and a quote closes the
+ * field only when followed by the delimiter or the end of the record. Unlike
+ * CsvReader, a newline inside a quoted field does not end the record, and a CRLF
+ * line ending is treated as a single record terminator.
+ *
+ * Lifetime: views into the buffer stay valid as long as the buffer does; views into
+ * the scratch buffer (unescaped fields) stay valid until the next readRow().
+ */
+class CsvViewReader {
+public:
+    explicit CsvViewReader(std::string_view data = {}, char delimiter = ',');
+
+    bool isOpen() const;
+    bool readRow(CsvRowView& row);
+
+    // Offset of the first byte that has not been consumed yet.
+    [[nodiscard]] size_t position() const;
+
+private:
+    std::string_view data_;
+    char        delimiter_;
+    size_t      position_ = 0;
+    bool        isOpen_ = true;
+    std::string scratch_; // Backing storage for fields that needed unescaping
+
+    // An unescaped field of the current row. scratch_ may still grow while the row is
+    // parsed, so its view is only built once the row is complete.
+    struct ScratchField {
+        size_t field;  // Index in the row
+        size_t offset; // Into scratch_
+        size_t length;
+    };
+    std::vector<ScratchField> scratch_fields_;
+
+    std::string_view parseQuotedField(const char* content, const char* end, const char*& cursor, size_t field);
+    bool isRecordEnd(const char* p, const char* end) const;
+};
+
+/**
+ * @class MmapCsvReader
+ * @brief A CSV reader that maps the whole file and hands out fields as string views.
+ *
+ * Combines a MappedFile with a CsvViewReader over the whole mapping; see
+ * CsvViewReader for the quoting rules and view lifetimes.
+ */
+class MmapCsvReader {
+public:
+    explicit MmapCsvReader(std::string filename, char delimiter = ',');
+    ~MmapCsvReader() = default;
+
+    MmapCsvReader(const MmapCsvReader&) = delete;
+    MmapCsvReader& operator=(const MmapCsvReader&) = delete;
+    MmapCsvReader(MmapCsvReader&&) = delete;
+    MmapCsvReader& operator=(MmapCsvReader&&) = delete;
+
+    bool isOpen() const;
+    bool readRow(CsvRowView& row);
+
+    // Total size of the mapped input in bytes.
+    [[nodiscard]] size_t size() const;
+
+private:
+    std::string   filename_;
+    MappedFile    file_;
+    CsvViewReader parser_;
+};
+
+/**
+ * @brief Splits a CSV buffer into `parts` byte ranges that each start on a record boundary.
+ *
+ * The buffer is first cut into equal raw chunks whose quote counts are taken in
+ * parallel; a prefix sum over those counts gives the quote parity at each cut, and
+ * each cut is then moved forward to the first newline that lies outside quotes. This
+ * keeps quoted fields that contain newlines inside a single range. It assumes quotes
+ * only appear as field delimiters or `""` escapes (true for RFC 4180 style files).
+ *
+ * @return parts + 1 ascending offsets; range i is [offsets[i], offsets[i + 1]).
+ *         Ranges may be empty when records are longer than a raw chunk.
+ */
+std::vector<size_t> splitAtRecordBoundaries(std::string_view data, size_t parts);
+
+#endif // MMAP_CSV_READER_HPP
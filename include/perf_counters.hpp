@@ -0,0 +1,48 @@
+//
+// Hardware branch and cache counters around a code region (Linux perf_event_open).
+//
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Counts retired branches, branch mispredictions, cache references and cache
+ *        misses between start() and stop().
+ *
+ * Uses perf_event_open on Linux. When the counters cannot be opened (other platforms,
+ * containers, perf_event_paranoid restrictions) isAvailable() is false, start()/stop()
+ * do nothing and the counts stay zero, so callers fall back to reporting time only.
+ * The cache counters are optional: if only they cannot be opened, isCacheAvailable()
+ * is false and their counts stay zero.
+ */
+class PerfCounters {
+public:
+    struct Sample {
+        std::uint64_t branches = 0;
+        std::uint64_t branch_misses = 0;
+        std::uint64_t cache_references = 0; // Last-level cache accesses
+        std::uint64_t cache_misses = 0;
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool isAvailable() const;
+    [[nodiscard]] bool isCacheAvailable() const;
+
+    void start();
+    Sample stop();
+
+private:
+    int branches_fd_ = -1;
+    int misses_fd_ = -1;
+    int cache_references_fd_ = -1;
+    int cache_misses_fd_ = -1;
+};
+
+#endif // PERF_COUNTERS_HPP
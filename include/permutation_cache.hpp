@@ -0,0 +1,126 @@
+//
+// Sorted row orders kept per dataset and key, so repeating a sort costs a copy.
+//
+
+#ifndef PERMUTATION_CACHE_HPP
+#define PERMUTATION_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <city.hpp>
+#include <sorter.hpp>
+#include <composite_key.hpp>
+
+/**
+ * @class PermutationCache
+ * @brief Remembers the sorted row order (index-mode permutation) of one dataset per key.
+ *
+ * Entries are keyed by the dataset fingerprint (fingerprintCities(): every row, in
+ * order), the composite key, and whether ties are known to be in dataset order.
+ *
+ * Directions:
+ *   - A key and its mirror image share one entry: "population" with -r and
+ *     "-population" are both the ascending "population" order walked from the end.
+ *     Entries are stored for the spelling whose first field is ascending.
+ *
+ * Stability:
+ *   - An order from an arbitrary sorter may leave rows with equal keys in any order.
+ *     A request for a stable order (ties in dataset order, as selectTopK() and the
+ *     Sorter::isStable() sorters return) upgrades such an entry once, by sorting each
+ *     run of equal keys by row index.
+ *     The stable entry then serves every request.
+ *   - Walking a stable order backwards would reverse its ties, so a stable descending
+ *     order walks the runs of equal keys from the end, each run front to back.
+ *
+ * Persistence:
+ *   - save() writes every entry to a file (by convention <csv>.perm, next to the data):
+ *     "CITYPERM", format version, byte-order mark, fingerprint, row count, entry count,
+ *     then per entry the key's length, a stable flag, the key spelling and the
+ *     permutation (uint32 per row).
+ *   - load() reads such a file back, and ignores it if it belongs to another dataset.
+ *
+ * Thread-safe: the sort server shares one cache between its connections. A miss
+ * sorts outside the lock, so concurrent misses on one key each sort once.
+ *
+ * Exceptions:
+ *   - load() throws std::runtime_error for a file that is unreadable, truncated or not a
+ *     valid cache; save() throws std::runtime_error if the file can't be written.
+ *   - get() throws std::logic_error if `sort_ascending` returns the wrong number of rows.
+ */
+class PermutationCache {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    struct Stats {
+        size_t hits = 0;           // Requests answered from an entry
+        size_t reversed_hits = 0;  // ... of which by walking an entry from the end
+        size_t misses = 0;         // Requests that had to sort
+        size_t stabilized = 0;     // Entries upgraded to a stable order
+        size_t loaded = 0;         // Entries read by load()
+        size_t entries = 0;
+    };
+
+    // Sorts all rows by `keys` ascending (reverse_order false), e.g. Sorter::sortIndicesByKeys().
+    using SortAscending = std::function<Sorter::Permutation(const CompositeKey& keys)>;
+
+    // `cities` must outlive the cache and must not change while it is used.
+    explicit PermutationCache(const std::vector<City>& cities);
+
+    PermutationCache(const PermutationCache&) = delete;
+    PermutationCache& operator=(const PermutationCache&) = delete;
+
+    /**
+     * @brief The first min(limit, rows) entries of the (keys, reverse_order) order.
+     *
+     * On a miss, `sort_ascending` is called with the stored spelling of the key and its
+     * result is kept.
+     * @param stable Ties must be in dataset order (as in a stable sort).
+     */
+    Sorter::Permutation get(const CompositeKey& keys, bool reverse_order, bool stable,
+                            const SortAscending& sort_ascending, size_t limit = SIZE_MAX);
+
+    /**
+     * @brief Adds the entries of a file written by save() for the same dataset.
+     * @return Entries loaded: 0 if the file does not exist or is for another dataset.
+     */
+    size_t load(const std::string& path);
+
+    // Writes all entries to `path` (via a temporary file that is renamed into place).
+    void save(const std::string& path) const;
+
+    // True if entries were added or upgraded since construction or the last load()/save().
+    [[nodiscard]] bool isModified() const;
+
+    [[nodiscard]] std::uint64_t fingerprint() const { return fingerprint_; }
+    [[nodiscard]] Stats getStats() const;
+
+    // One line for logs: "2 hits (1 reversed), 1 miss, 0 stabilized, 1 entry (0 loaded)".
+    [[nodiscard]] std::string describeStats() const;
+
+    /**
+     * @brief 64-bit FNV-1a hash of the row count and every field of every row, in order.
+     */
+    static std::uint64_t fingerprintCities(const std::vector<City>& cities);
+
+private:
+    struct Entry {
+        std::shared_ptr<const Sorter::Permutation> order; // Ascending; shared with readers
+        bool stable = false;
+    };
+
+    const std::vector<City>& cities_;
+    std::uint64_t fingerprint_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_; // By compositeKeyName() of the ascending spelling
+    Stats stats_;
+    mutable bool modified_ = false;
+};
+
+#endif // PERMUTATION_CACHE_HPP
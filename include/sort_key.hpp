@@ -0,0 +1,121 @@
+//
+// Sort keys (columns of City) and the comparators that order by them.
+//
+
+#ifndef SORT_KEY_HPP
+#define SORT_KEY_HPP
+
+#include <string>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "city.hpp"
+#include "country_dictionary.hpp"
+
+/**
+ * @brief The City column a sort is keyed on.
+ *
+ * Sorters that only see an opaque comparator cannot tell what is being compared;
+ * passing the key itself lets key-aware sorters (e.g. radix sort) read the column
+ * directly instead of going through comparisons.
+ */
+enum class SortKey {
+    Name,
+    Country,
+    Population,
+    Lat,
+    Lng
+};
+
+constexpr size_t SORT_KEY_COUNT = 5;
+
+/**
+ * @brief Slot of a (key, direction) pair in per-key dispatch tables:
+ *        ascending at 2 * key, descending at 2 * key + 1.
+ */
+constexpr size_t keyDispatchIndex(SortKey key, bool reverse_order) {
+    return static_cast<size_t>(key) * 2 + (reverse_order ? 1 : 0);
+}
+
+/**
+ * @brief Compile-time comparator for one key and direction.
+ *
+ * Unlike the std::function returned by createKeyComparator(), the column and the
+ * direction are template parameters, so a sorter instantiated with KeyLess gets
+ * an inlined comparison with no indirect call and no per-call direction branch.
+ */
+template <SortKey Key, bool Reverse>
+struct KeyLess {
+    // A single numeric compare: cheap enough for branch-free partitioning.
+    static constexpr bool numeric_key = Key == SortKey::Population || Key == SortKey::Lat || Key == SortKey::Lng;
+
+    bool operator()(const City& a, const City& b) const {
+        if constexpr (Reverse) {
+            return less(b, a);
+        } else {
+            return less(a, b);
+        }
+    }
+
+    static bool less(const City& a, const City& b) {
+        if constexpr (Key == SortKey::Name) {
+            return a.name < b.name;
+        } else if constexpr (Key == SortKey::Country) {
+            // Interned codes follow the order of the names, so compare the 16-bit codes
+            // and only fall back to the strings for cities that were never interned.
+            if (a.country_code != CountryDictionary::UNASSIGNED && b.country_code != CountryDictionary::UNASSIGNED) {
+                return a.country_code < b.country_code;
+            }
+            return a.country < b.country;
+        } else if constexpr (Key == SortKey::Population) {
+            return a.population < b.population;
+        } else if constexpr (Key == SortKey::Lat) {
+            return a.lat < b.lat;
+        } else {
+            return a.lng < b.lng;
+        }
+    }
+};
+
+/**
+ * @brief Parses a CLI key name ("name", "country", "population", "lat", "lng").
+ * @throws std::invalid_argument if the name is not a known key.
+ */
+SortKey parseSortKey(const std::string& key);
+
+/**
+ * @brief Returns the CLI name of a key.
+ */
+std::string sortKeyName(SortKey key);
+
+/**
+ * @brief True for population, lat and lng; false for the string keys.
+ */
+bool isNumericKey(SortKey key);
+
+/**
+ * @brief Order-preserving maps to unsigned 64-bit keys: a < b exactly when
+ *        orderedKeyBits(a) < orderedKeyBits(b) (-0.0 and 0.0 map to the same key).
+ */
+std::uint64_t orderedKeyBits(long value);
+std::uint64_t orderedKeyBits(double value);
+
+/**
+ * @brief Builds the comparator for a key: a strict "less than" on the column,
+ *        or "greater than" when reverse_order is set.
+ */
+std::function<bool(const City&, const City&)> createKeyComparator(SortKey key, bool reverse_order);
+
+/**
+ * @brief True if Compare declares `static constexpr bool numeric_key = true`
+ *        (KeyLess on population/lat/lng, and index comparators wrapping one).
+ */
+template <typename Compare, typename = void>
+struct is_numeric_key_compare : std::false_type {};
+
+template <typename Compare>
+struct is_numeric_key_compare<Compare, std::void_t<decltype(Compare::numeric_key)>>
+    : std::bool_constant<Compare::numeric_key> {};
+
+#endif // SORT_KEY_HPP
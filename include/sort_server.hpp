@@ -0,0 +1,213 @@
+//
+// Long-running sort service: the dataset is loaded once and queried over a Unix domain socket.
+//
+
+#ifndef SORT_SERVER_HPP
+#define SORT_SERVER_HPP
+
+#include <city.hpp>
+#include <permutation_cache.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief One sort request: the choices of a citysort run (-k, -r, -n, -a).
+ *
+ * Wire form, one line: "SORT key=<keys> [order=asc|desc] [limit=N] [algo=<name>]".
+ * <keys> is a -k value (e.g. "country,-population"). As with -n, a limit below the
+ * row count selects the first rows (selectTopK) instead of sorting them all with <algo>.
+ */
+struct SortQuery {
+    std::string key;
+    bool reverse_order = false;
+    std::optional<size_t> limit;
+    std::string algorithm = "auto";
+};
+
+/**
+ * @brief Parses a "SORT ..." request line.
+ * @throws std::invalid_argument naming the first bad field.
+ */
+SortQuery parseSortQuery(const std::string& line);
+
+/**
+ * @brief The request line for `query`, without the newline.
+ */
+std::string formatSortQuery(const SortQuery& query);
+
+/**
+ * @brief A server's answer to a SortQuery.
+ */
+struct SortReply {
+    size_t total_rows = 0;    // Rows in the server's dataset
+    std::string algorithm;    // What ran: a sorter name, "auto:<delegate>", "top-k", or "cache"
+    long long server_us = 0;  // Time the server spent on the query, formatting excluded
+    std::vector<City> rows;   // The selected rows, in order (country_code is not sent)
+};
+
+/**
+ * @class SortServer
+ * @brief Answers sort queries against one read-only dataset over a Unix domain socket.
+ *
+ * Protocol: text, one request per line, any number of requests per connection.
+ *   - SORT ...  -> "OK rows=<k> total=<n> algo=<name> us=<micros>", then k rows as
+ *                  "name\tcountry\tpopulation\tlat\tlng" (tabs and newlines in the
+ *                  names are sent as spaces; the numbers round-trip exactly).
+ *   - PING      -> "PONG"
+ *   - STATS     -> "STATS connections=<c> queries=<q> errors=<e>", plus
+ *                  " cache_hits=<h> cache_misses=<m>" with a permutation cache
+ *   - QUIT      -> "BYE", then the server closes the connection.
+ *   - SHUTDOWN  -> "BYE", then serve() returns: connections are closed once their
+ *                  current request is answered.
+ *   - Anything else, or a query that fails -> "ERR <message>"; the connection stays open.
+ *
+ * Threads: each connection has its own thread, and at most `query_threads` queries run
+ * at once (the others wait for a slot). A query sorts row indices (sortIndicesByKeys)
+ * with a single-threaded sorter, so the shared dataset is only ever read.
+ *
+ * With a PermutationCache, every query is answered from the cached order of its key
+ * (sorting with <algo> on a miss), limited queries included. Limited queries and
+ * stable algorithms ask for a stable order, so they return the same rows as
+ * selectTopK() or <algo> without the cache.
+ *
+ * POSIX only: on Windows listen() throws std::runtime_error.
+ */
+class SortServer {
+public:
+    static constexpr size_t MAX_LINE_BYTES = 4096; // Longer requests close the connection
+
+    struct Stats {
+        size_t connections = 0;
+        size_t queries = 0;
+        size_t errors = 0;
+    };
+
+    // `cities` must outlive the server and must not change while it runs.
+    SortServer(const std::vector<City>& cities, unsigned int query_threads);
+    ~SortServer();
+
+    SortServer(const SortServer&) = delete;
+    SortServer& operator=(const SortServer&) = delete;
+
+    /**
+     * @brief Binds `socket_path` and starts listening.
+     *
+     * A socket file left behind by a server that is gone is replaced.
+     * @throws std::runtime_error if the path is in use by a live server, or on socket errors.
+     */
+    void listen(const std::string& socket_path);
+
+    /**
+     * @brief Accepts connections until stop() or a SHUTDOWN request, then waits for
+     *        the connection threads. Requires listen().
+     */
+    void serve();
+
+    // Makes serve() return. Safe to call from any thread, and more than once.
+    void stop();
+
+    /**
+     * @brief Answers one request line (without its newline): the complete reply, newline-terminated.
+     *
+     * This is what a connection thread runs for every line; a reply starting with "BYE"
+     * ends the connection.
+     */
+    std::string handleRequest(const std::string& line);
+
+    // Answers queries from `cache` (built over the same cities; must outlive the server). Call before serve().
+    void setPermutationCache(PermutationCache* cache);
+
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::thread thread;
+        std::atomic<bool> finished{false};
+    };
+
+    const std::vector<City>& cities_;
+    unsigned int query_threads_;
+    PermutationCache* cache_ = nullptr;
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    int wake_fds_[2] = {-1, -1}; // Self-pipe: written once by stop(), never drained
+
+    std::mutex connections_mutex_;
+    std::list<Connection> connections_;
+
+    std::mutex slots_mutex_;
+    std::condition_variable slot_freed_;
+    unsigned int running_queries_ = 0;
+
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> connection_count_{0};
+    std::atomic<size_t> query_count_{0};
+    std::atomic<size_t> error_count_{0};
+
+    void serveConnection(Connection& connection);
+    std::string runQuery(const std::string& line);
+    void joinConnections(bool finished_only);
+    void closeSockets() noexcept;
+};
+
+/**
+ * @class SortClient
+ * @brief One connection to a SortServer.
+ *
+ * @throws std::runtime_error on connection errors, and from query() for an "ERR" reply.
+ */
+class SortClient {
+public:
+    explicit SortClient(const std::string& socket_path);
+    ~SortClient();
+
+    SortClient(const SortClient&) = delete;
+    SortClient& operator=(const SortClient&) = delete;
+
+    SortReply query(const SortQuery& query);
+
+    // Sends a one-line request (PING, STATS, QUIT, SHUTDOWN) and returns the reply line.
+    std::string request(const std::string& line);
+
+private:
+    int fd_ = -1;
+    std::string buffer_;       // Bytes received but not yet returned by readLine()
+    size_t buffer_offset_ = 0;
+
+    void sendLine(const std::string& line);
+    void readLine(std::string& line);
+};
+
+/**
+ * @brief Client-side latencies of a load run against a SortServer.
+ */
+struct LoadReport {
+    size_t requests = 0;   // Answered without error
+    size_t errors = 0;
+    double seconds = 0.0;  // Wall time of the whole run
+    double throughput = 0.0; // Answered requests per second
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @brief Load generator: `connections` clients send `requests` queries in total, as fast
+ *        as the server answers them.
+ *
+ * Client i sends queries[i], queries[i + 1], ... (wrapping around), so a mix of
+ * queries is spread over all connections. A latency covers sending the request,
+ * the server's work and reading and decoding the whole reply.
+ */
+LoadReport runLoadGenerator(const std::string& socket_path, const std::vector<SortQuery>& queries,
+                            unsigned int connections, size_t requests);
+
+#endif // SORT_SERVER_HPP
@@ -4,7 +4,11 @@
 #include <vector>
 #include <functional> // For std::function
 #include <string>
+#include <cstdint>
+#include <stdexcept>
 #include "city.hpp"   // Include the City struct definition
+#include "sort_key.hpp"
+#include "composite_key.hpp"
 
 /**
  * @brief Abstract base class for sorting collections of City objects.
@@ -12,6 +16,10 @@
  * The Sorter class defines an interface for sorting a vector of City objects
  * using a user-provided comparison function. Derived classes must implement
  * the sort algorithm and provide a name for the sorter.
+ *
+ * Besides sorting in place, every sorter can run in index mode (sortIndices):
+ * it sorts row indices against an immutable dataset and returns the permutation,
+ * so no City is copied or swapped and several keys can share one loaded dataset.
  */
 class Sorter {
 public:
@@ -22,6 +30,12 @@ public:
      */
     using Comparator = std::function<bool(const City&, const City&)>;
 
+    /**
+     * @brief Row order produced by index mode: element i is the index (into the
+     *        original vector) of the City that belongs at position i.
+     */
+    using Permutation = std::vector<std::uint32_t>;
+
     /**
      * @brief Virtual destructor for proper cleanup of derived classes.
      */
@@ -35,12 +49,134 @@ public:
      */
     virtual void sort(std::vector<City>& cities, Comparator compare) = 0;
 
+    /**
+     * @brief Sorts row indices of an immutable vector of City objects (index mode).
+     *
+     * Runs the same algorithm as sort(), but moves 4-byte indices instead of City
+     * objects. The cities themselves are never modified or copied.
+     *
+     * @param cities The dataset to order. Must have fewer than 2^32 elements.
+     * @param compare The comparator function to determine the order of elements.
+     * @return The sorted permutation of [0, cities.size()).
+     */
+    virtual Permutation sortIndices(const std::vector<City>& cities, Comparator compare) = 0;
+
+    /**
+     * @brief Sorts a vector of City objects by a known key column.
+     *
+     * The default builds the key's comparator and calls sort(). Sorters that can
+     * exploit the key type directly (e.g. radix sort on numeric columns) override it.
+     *
+     * @param cities The vector of City objects to be sorted.
+     * @param key The column to sort by.
+     * @param reverse_order Sort descending instead of ascending.
+     */
+    virtual void sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) {
+        sort(cities, createKeyComparator(key, reverse_order));
+    }
+
+    /**
+     * @brief Index-mode counterpart of sortByKey().
+     */
+    virtual Permutation sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) {
+        return sortIndices(cities, createKeyComparator(key, reverse_order));
+    }
+
+    /**
+     * @brief Sorts by a composite key (e.g. country, then population descending) in one pass.
+     *
+     * A single field is forwarded to sortByKey(). Otherwise the default calls sort()
+     * with the fused CompositeLess comparator; comparison sorters override it to pack
+     * the leading fields into integer keys (see packCompositeKeys()).
+     *
+     * @param cities The vector of City objects to be sorted.
+     * @param keys The columns to sort by, in priority order. Must not be empty.
+     * @param reverse_order Flip the direction of every field.
+     */
+    virtual void sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+        if (keys.size() == 1) {
+            sortByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+            return;
+        }
+        sort(cities, createCompositeComparator(keys, reverse_order));
+    }
+
+    /**
+     * @brief Index-mode counterpart of sortByKeys().
+     */
+    virtual Permutation sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+        if (keys.size() == 1) {
+            return sortIndicesByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+        }
+        return sortIndices(cities, createCompositeComparator(keys, reverse_order));
+    }
+
     /**
      * @brief Returns the name of the sorting algorithm.
      *
      * @return A string representing the name of the sorter.
      */
     [[nodiscard]] virtual std::string getName() const = 0;
+
+    /**
+     * @brief True if rows with equal keys keep their input order, in every sort method.
+     *
+     * Callers that reuse a sorted order (PermutationCache) rely on it to reproduce
+     * this sorter's ties.
+     */
+    [[nodiscard]] virtual bool isStable() const {
+        return false;
+    }
+
+    /**
+     * @brief Sets how many threads a parallel sorter may use. Sequential sorters ignore it.
+     */
+    virtual void setThreadCount(unsigned int thread_count) {
+        static_cast<void>(thread_count);
+    }
+
+    /**
+     * @brief Returns the identity permutation 0, 1, ..., size - 1.
+     * @throws std::length_error if size does not fit in 32-bit indices.
+     */
+    static Permutation identityPermutation(size_t size) {
+        if (size > UINT32_MAX) {
+            throw std::length_error("Sorter Error: Index mode supports at most 2^32 - 1 rows.");
+        }
+        Permutation indices(size);
+        for (size_t i = 0; i < size; ++i) {
+            indices[i] = static_cast<std::uint32_t>(i);
+        }
+        return indices;
+    }
+
+    /**
+     * @brief Materialises a permutation: returns the cities in permutation order.
+     */
+    static std::vector<City> applyPermutation(const std::vector<City>& cities, const Permutation& permutation) {
+        std::vector<City> ordered;
+        ordered.reserve(permutation.size());
+        for (std::uint32_t index : permutation) {
+            ordered.push_back(cities[index]);
+        }
+        return ordered;
+    }
+
+protected:
+    /**
+     * @brief Adapts a City comparator to compare row indices into `cities`.
+     */
+    template <typename Compare>
+    struct IndexComparator {
+        static constexpr bool numeric_key = is_numeric_key_compare<Compare>::value;
+
+        const std::vector<City>& cities;
+        Compare& compare;
+
+        bool operator()(std::uint32_t a, std::uint32_t b) const {
+            return compare(cities[a], cities[b]);
+        }
+    };
 };
 
 #endif // SORTER_HPP
\ No newline at end of file
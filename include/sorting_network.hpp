@@ -0,0 +1,77 @@
+//
+// Sorting networks for small blocks of packed (key, row index) records.
+//
+
+#ifndef SORTING_NETWORK_HPP
+#define SORTING_NETWORK_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include "composite_key.hpp"
+
+/**
+ * @brief Implementation behind sortSmallPackedRows().
+ *
+ * - Insertion: insertion sort by (key, index), no network.
+ * - ScalarNetwork: a 16-input bitonic network of branch-free compare-exchanges.
+ * - Avx2Network: the same 16 records in eight registers (keys and indices as 4 x 64-bit
+ *   lanes). A 4-input network across the registers sorts each column, a 4 x 4
+ *   transpose turns the columns into four sorted runs, and two rounds of bitonic
+ *   merges finish the block. Only built for x86-64 GCC/Clang, and only used when the
+ *   CPU reports AVX2.
+ *
+ * The portable network does about 80 compare-exchanges per block. That is more work
+ * than insertion sort, and it only wins once four of them run per instruction, so
+ * without AVX2 the sorters use Insertion. ScalarNetwork is kept as the reference
+ * the vector kernel is tested and benchmarked against.
+ */
+enum class SmallSortKernel {
+    Insertion,
+    ScalarNetwork,
+    Avx2Network
+};
+
+// Records sorted by one network pass; larger blocks are split and merged.
+constexpr std::size_t SORTING_NETWORK_SIZE = 16;
+
+// Block sizes up to this are merged through a stack buffer.
+constexpr std::size_t SMALL_SORT_MAX = 128;
+
+/**
+ * @brief True if `kernel` is compiled in and supported by this CPU.
+ */
+bool isSmallSortKernelAvailable(SmallSortKernel kernel);
+
+/**
+ * @brief The kernel sortSmallPackedRows() uses: Avx2Network where available, else Insertion.
+ */
+SmallSortKernel activeSmallSortKernel();
+
+/**
+ * @brief Sorts rows[0, count) by key, then by row index.
+ *
+ * Blocks of SORTING_NETWORK_SIZE are sorted on their own (a network block is padded
+ * with records that sort after every real one) and then merged. Ordering ties by
+ * index makes the result unique. For records from packCompositeKeys(), whose index
+ * is their input position, that is exactly the order a stable sort by key gives.
+ *
+ * Meant for the leaves of recursive sorts: any count works, but blocks larger than
+ * SMALL_SORT_MAX allocate their merge buffer.
+ */
+void sortSmallPackedRows(PackedRow* rows, std::size_t count);
+
+/**
+ * @brief sortSmallPackedRows() with the kernel chosen explicitly (tests, benchmarks).
+ * @throws std::invalid_argument if the kernel is not available.
+ */
+void sortSmallPackedRowsWith(SmallSortKernel kernel, PackedRow* rows, std::size_t count);
+
+/**
+ * @brief True when a sortRange<T, Compare>() can hand its small ranges to
+ *        sortSmallPackedRows(): packed rows ordered by their whole key.
+ */
+template <typename T, typename Compare>
+constexpr bool uses_sorting_network_v =
+    std::is_same_v<T, PackedRow> && std::is_same_v<std::remove_const_t<Compare>, PackedRowLess>;
+
+#endif // SORTING_NETWORK_HPP
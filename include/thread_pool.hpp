@@ -0,0 +1,95 @@
+//
+// Work-stealing thread pool with fork/join task groups.
+//
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool where every worker owns a task deque.
+ *
+ * A worker pushes and pops its own tasks at the back (LIFO, cache-warm) and, when
+ * it runs dry, steals from the front of another worker's deque (the oldest, usually
+ * largest, subproblems). Tasks submitted from outside the pool are spread round-robin.
+ *
+ * A pool of N threads starts N - 1 workers: the thread that waits on a TaskGroup
+ * runs tasks too, so ThreadPool(1) executes everything on the calling thread.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned int thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Total threads working on tasks, including the waiting caller.
+     */
+    [[nodiscard]] unsigned int threadCount() const;
+
+    void submit(Task task);
+
+    /**
+     * @brief Runs one queued task on the calling thread, if any is available.
+     * @return true if a task was run.
+     */
+    bool runPendingTask();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> next_queue_{0};
+    bool stopping_ = false;
+
+    void workerLoop(size_t index);
+    bool popTask(size_t preferred, Task& task);
+    [[nodiscard]] size_t currentQueue() const;
+};
+
+/**
+ * @brief Fork/join helper: run() forks tasks into the pool, wait() joins them.
+ *
+ * wait() keeps executing pool tasks while it waits, so nested groups (a task that
+ * forks and waits on its own children) never block a worker. The first exception
+ * thrown by a task is rethrown from wait().
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    ThreadPool& pool_;
+    std::atomic<size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,47 @@
+//
+// Selection of the first K rows of a sort order without sorting the whole dataset.
+//
+
+#ifndef TOP_K_HPP
+#define TOP_K_HPP
+
+#include "sorter.hpp"
+#include "sort_key.hpp"
+#include "composite_key.hpp"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief How selectTopK() finds the first K rows.
+ *
+ * - Heap: one pass with a bounded max-heap of the K best rows so far. O(n log K),
+ *   and most rows are rejected by a single compare against the heap top.
+ * - NthElement: std::nth_element on all row indices, then sort the first K. O(n + K log K),
+ *   but it touches and moves every index; it wins once K is a sizeable part of n.
+ * - Auto: Heap while K <= n / TOP_K_HEAP_RATIO, NthElement above.
+ */
+enum class TopKStrategy {
+    Auto,
+    Heap,
+    NthElement
+};
+
+// Auto picks the heap while K is at most 1/HEAP_RATIO of the rows.
+constexpr std::size_t TOP_K_HEAP_RATIO = 64;
+
+/**
+ * @brief Row indices of the first `k` cities in (key, direction) order.
+ *
+ * Rows with equal keys keep their dataset order, so the result equals the first `k`
+ * entries of a stable full sort. Returns min(k, cities.size()) indices.
+ */
+Sorter::Permutation selectTopK(const std::vector<City>& cities, SortKey key, bool reverse_order, std::size_t k,
+                               TopKStrategy strategy = TopKStrategy::Auto);
+
+/**
+ * @brief selectTopK() for a composite key, compared with the fused CompositeLess.
+ */
+Sorter::Permutation selectTopK(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order,
+                               std::size_t k, TopKStrategy strategy = TopKStrategy::Auto);
+
+#endif // TOP_K_HPP
@@ -0,0 +1,222 @@
+//
+// Picks a sorter per call from a cheap sample of the input ("-a auto").
+//
+
+#include "../../include/algorithms/auto_sorter.hpp"
+#include "../../include/algorithms/sample_sorter.hpp"
+#include "../../include/country_dictionary.hpp"
+#include "../../include/sorter_factory.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Fixed seed: the same input always gets the same decision.
+constexpr unsigned int SAMPLE_SEED = 0x5eed;
+
+// Fills the sampled fields of `profile`; less(a, b) is the order the sort will produce.
+template <typename Less>
+void sampleRows(const std::vector<City>& cities, const Less& less, InputProfile& profile) {
+    const size_t n = cities.size();
+    profile.rows = n;
+    if (n < 2) {
+        profile.sampled_rows = n;
+        profile.distinct_keys = n;
+        profile.ascending_pairs = 1.0;
+        profile.descending_pairs = 1.0;
+        return;
+    }
+
+    // Neighbours at evenly spaced positions.
+    const size_t pairs = std::min(AutoSorter::SAMPLE_SIZE, n - 1);
+    const size_t pair_stride = (n - 1) / pairs;
+    size_t ascending = 0;
+    size_t descending = 0;
+    for (size_t i = 0; i < pairs; ++i) {
+        const City& a = cities[i * pair_stride];
+        const City& b = cities[i * pair_stride + 1];
+        ascending += !less(b, a);
+        descending += !less(a, b);
+    }
+    profile.sampled_pairs = pairs;
+    profile.ascending_pairs = static_cast<double>(ascending) / static_cast<double>(pairs);
+    profile.descending_pairs = static_cast<double>(descending) / static_cast<double>(pairs);
+
+    // Random pairs, for disorder that neighbours miss (e.g. two sorted halves swapped).
+    std::mt19937 rng(SAMPLE_SEED);
+    std::uniform_int_distribution<size_t> row(0, n - 1);
+    size_t compared = 0;
+    size_t inverted = 0;
+    for (size_t i = 0; i < AutoSorter::SAMPLE_SIZE; ++i) {
+        size_t first = row(rng);
+        size_t second = row(rng);
+        if (first == second) {
+            continue;
+        }
+        if (first > second) {
+            std::swap(first, second);
+        }
+        ++compared;
+        inverted += less(cities[second], cities[first]);
+    }
+    profile.inversions = compared == 0 ? 0.0 : static_cast<double>(inverted) / static_cast<double>(compared);
+
+    // Distinct keys among evenly spaced rows: sort the sample, count the steps.
+    const size_t sample_rows = std::min(AutoSorter::SAMPLE_SIZE, n);
+    const size_t row_stride = n / sample_rows;
+    std::vector<const City*> sample(sample_rows);
+    for (size_t i = 0; i < sample_rows; ++i) {
+        sample[i] = &cities[i * row_stride];
+    }
+    std::sort(sample.begin(), sample.end(), [&less](const City* a, const City* b) { return less(*a, *b); });
+    size_t distinct = 1;
+    for (size_t i = 1; i < sample_rows; ++i) {
+        distinct += less(*sample[i - 1], *sample[i]);
+    }
+    profile.sampled_rows = sample_rows;
+    profile.distinct_keys = distinct;
+}
+
+// Country codes are all-or-nothing per dataset (see packCompositeKeys()); a sample settles it.
+bool countriesInterned(const std::vector<City>& cities) {
+    const size_t step = std::max<size_t>(1, cities.size() / AutoSorter::SAMPLE_SIZE);
+    for (size_t i = 0; i < cities.size(); i += step) {
+        if (cities[i].country_code == CountryDictionary::UNASSIGNED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string AutoDecision::describe() const {
+    std::ostringstream out;
+    out.precision(3);
+    out << this->algorithm;
+    if (this->threads > 1) {
+        out << " x" << this->threads << " threads";
+    }
+    out << " (" << this->reason << "); rows=" << this->profile.rows
+        << " ascending=" << this->profile.ascending_pairs << " descending=" << this->profile.descending_pairs
+        << " inversions=" << this->profile.inversions << " distinct=" << this->profile.distinct_keys << "/"
+        << this->profile.sampled_rows << " key="
+        << (this->profile.opaque ? "comparator" : this->profile.radix_key ? "integer" : "string");
+    return out.str();
+}
+
+AutoSorter::AutoSorter() : thread_count_(std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::string AutoSorter::getName() const {
+    return "auto";
+}
+
+void AutoSorter::setThreadCount(unsigned int thread_count) {
+    this->thread_count_ = std::max(1u, thread_count);
+}
+
+const AutoDecision& AutoSorter::lastDecision() const {
+    return this->last_decision_;
+}
+
+InputProfile AutoSorter::profileInput(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    InputProfile profile;
+    sampleRows(cities, CompositeLess(keys, reverse_order), profile);
+
+    const bool has_name = std::any_of(keys.begin(), keys.end(), [](const KeyField& field) {
+        return field.key == SortKey::Name;
+    });
+    const bool has_country = std::any_of(keys.begin(), keys.end(), [](const KeyField& field) {
+        return field.key == SortKey::Country;
+    });
+    const bool all_numeric = !has_name && !has_country;
+    // RadixSorter packs interned countries only in lists; a lone string key falls back to merge sort.
+    profile.radix_key = all_numeric || (keys.size() > 1 && !has_name && countriesInterned(cities));
+    profile.single_string = keys.size() == 1 && !all_numeric;
+    return profile;
+}
+
+InputProfile AutoSorter::profileInput(const std::vector<City>& cities, const Comparator& compare) {
+    InputProfile profile;
+    sampleRows(cities, compare, profile);
+    profile.opaque = true;
+    return profile;
+}
+
+AutoDecision AutoSorter::decide(const InputProfile& profile, bool index_mode, unsigned int thread_count) {
+    AutoDecision decision;
+    decision.profile = profile;
+
+    const bool ascending = profile.ascending_pairs >= PRESORTED_FRACTION && profile.inversions <= 1.0 - PRESORTED_FRACTION;
+    const bool descending = profile.descending_pairs >= PRESORTED_FRACTION && profile.inversions >= PRESORTED_FRACTION;
+    const bool low_cardinality = profile.distinct_keys * LOW_CARDINALITY_DIVISOR <= profile.sampled_rows;
+
+    if (profile.rows <= SMALL_INPUT) {
+        decision.algorithm = "insertion";
+        decision.reason = "small input";
+    } else if (ascending || descending) {
+        decision.reason = ascending ? "nearly sorted" : "nearly reversed";
+        if (index_mode) {
+            decision.algorithm = "tim";
+        } else {
+            decision.algorithm = "quick"; // pdqsort on the rows themselves
+            decision.reason += ", rows stay in place";
+        }
+    } else if (profile.radix_key && low_cardinality) {
+        decision.algorithm = "quick"; // pdqsort gathers each run of equal keys in one pass
+        decision.reason = "few distinct integer keys";
+    } else if (profile.radix_key) {
+        decision.algorithm = "radix";
+        decision.reason = "integer key";
+    } else if (thread_count > 1 && profile.rows >= SampleSorter::SEQUENTIAL_THRESHOLD) {
+        decision.algorithm = "samplesort";
+        decision.threads = thread_count;
+        decision.reason = "comparison key, several threads";
+    } else if (profile.single_string && low_cardinality) {
+        decision.algorithm = "multikey";
+        decision.reason = "few distinct strings";
+    } else if (profile.opaque) {
+        decision.algorithm = "quick";
+        decision.reason = "plain comparator";
+    } else {
+        decision.algorithm = "blockquick";
+        decision.reason = "comparison key";
+    }
+    return decision;
+}
+
+std::unique_ptr<Sorter> AutoSorter::choose(const InputProfile& profile, bool index_mode) {
+    this->last_decision_ = decide(profile, index_mode, this->thread_count_);
+    std::unique_ptr<Sorter> delegate = SorterFactory::createSorter(this->last_decision_.algorithm);
+    delegate->setThreadCount(this->last_decision_.threads);
+    return delegate;
+}
+
+void AutoSorter::sort(std::vector<City>& cities, Comparator compare) {
+    choose(profileInput(cities, compare), false)->sort(cities, compare);
+}
+
+Sorter::Permutation AutoSorter::sortIndices(const std::vector<City>& cities, Comparator compare) {
+    return choose(profileInput(cities, compare), true)->sortIndices(cities, compare);
+}
+
+void AutoSorter::sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) {
+    sortByKeys(cities, CompositeKey{{key, false}}, reverse_order);
+}
+
+Sorter::Permutation AutoSorter::sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) {
+    return sortIndicesByKeys(cities, CompositeKey{{key, false}}, reverse_order);
+}
+
+void AutoSorter::sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    choose(profileInput(cities, keys, reverse_order), false)->sortByKeys(cities, keys, reverse_order);
+}
+
+Sorter::Permutation AutoSorter::sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys,
+                                                  bool reverse_order) {
+    return choose(profileInput(cities, keys, reverse_order), true)->sortIndicesByKeys(cities, keys, reverse_order);
+}
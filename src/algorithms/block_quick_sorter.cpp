@@ -0,0 +1,10 @@
+//
+// QuickSorter with the branch-free block partition forced on for every key.
+//
+
+#include "../../include/algorithms/block_quick_sorter.hpp"
+#include <string>
+
+std::string BlockQuickSorter::getName() const {
+    return "blockquick";
+}
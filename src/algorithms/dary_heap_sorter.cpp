@@ -0,0 +1,10 @@
+//
+// Bottom-up (Floyd) heapsort on a d-ary heap, moving elements through a hole.
+//
+
+#include "../../include/algorithms/dary_heap_sorter.hpp"
+#include <string>
+
+std::string DaryHeapSorter::getName() const {
+    return "heap4";
+}
@@ -0,0 +1,142 @@
+//
+// Multikey (three-way radix) quicksort for the string City keys (name, country).
+//
+
+#include "../../include/algorithms/multikey_sorter.hpp"
+#include "../../include/algorithms/std_sorter.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Byte at `depth`, shifted by one so that 0 can mark "past the end of the string":
+// a string that ends sorts before any string that continues.
+inline int byteAt(std::string_view text, size_t depth) {
+    return depth < text.size() ? static_cast<unsigned char>(text[depth]) + 1 : 0;
+}
+
+} // namespace
+
+std::string MultikeySorter::getName() const {
+    return "multikey";
+}
+
+void MultikeySorter::insertionSort(StringRef* items, size_t count, size_t depth) {
+    for (size_t i = 1; i < count; ++i) {
+        StringRef current = items[i];
+        std::string_view current_tail = current.text.substr(std::min(depth, current.text.size()));
+        size_t j = i;
+        while (j > 0 && current_tail < items[j - 1].text.substr(std::min(depth, items[j - 1].text.size()))) {
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = current;
+    }
+}
+
+void MultikeySorter::multikeySort(StringRef* items, size_t count, size_t depth) {
+    while (count >= INSERTION_CUTOFF) {
+        // Median-of-three pivot byte.
+        int a = byteAt(items[0].text, depth);
+        int b = byteAt(items[count / 2].text, depth);
+        int c = byteAt(items[count - 1].text, depth);
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        // Three-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, count) > pivot.
+        size_t lt = 0;
+        size_t gt = count;
+        size_t i = 0;
+        while (i < gt) {
+            int current = byteAt(items[i].text, depth);
+            if (current < pivot) {
+                std::swap(items[lt++], items[i++]);
+            } else if (current > pivot) {
+                std::swap(items[i], items[--gt]);
+            } else {
+                ++i;
+            }
+        }
+
+        multikeySort(items, lt, depth);
+        multikeySort(items + gt, count - gt, depth);
+
+        if (pivot == 0) {
+            return; // Every string in the middle bucket has ended: they are all equal.
+        }
+        // Continue with the middle bucket one byte deeper, without recursing.
+        items += lt;
+        count = gt - lt;
+        ++depth;
+    }
+    insertionSort(items, count, depth);
+}
+
+Sorter::Permutation MultikeySorter::sortStrings(const std::vector<City>& cities, SortKey key, bool reverse_order) {
+    if (cities.size() > UINT32_MAX) {
+        throw std::length_error("MultikeySorter Error: At most 2^32 - 1 rows can be sorted.");
+    }
+    std::vector<StringRef> items(cities.size());
+    for (size_t i = 0; i < cities.size(); ++i) {
+        const std::string& text = key == SortKey::Name ? cities[i].name : cities[i].country;
+        items[i] = {text, static_cast<std::uint32_t>(i)};
+    }
+    multikeySort(items.data(), items.size(), 0);
+
+    Permutation order(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        order[i] = items[i].index;
+    }
+    if (reverse_order) {
+        std::reverse(order.begin(), order.end());
+    }
+    return order;
+}
+
+void MultikeySorter::sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) {
+    if (isNumericKey(key)) {
+        StdSorter().sortByKey(cities, key, reverse_order);
+        return;
+    }
+
+    Permutation order = sortStrings(cities, key, reverse_order);
+    std::vector<City> sorted;
+    sorted.reserve(cities.size());
+    for (std::uint32_t index : order) {
+        sorted.push_back(std::move(cities[index]));
+    }
+    cities.swap(sorted);
+}
+
+Sorter::Permutation MultikeySorter::sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) {
+    if (isNumericKey(key)) {
+        return StdSorter().sortIndicesByKey(cities, key, reverse_order);
+    }
+    return sortStrings(cities, key, reverse_order);
+}
+
+void MultikeySorter::sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    if (keys.size() == 1) {
+        sortByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+        return;
+    }
+    StdSorter().sortByKeys(cities, keys, reverse_order);
+}
+
+Sorter::Permutation MultikeySorter::sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    if (keys.size() == 1) {
+        return sortIndicesByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+    }
+    return StdSorter().sortIndicesByKeys(cities, keys, reverse_order);
+}
+
+void MultikeySorter::sort(std::vector<City>& cities, Comparator compare) {
+    // No key to extract from an opaque comparator.
+    std::sort(cities.begin(), cities.end(), compare);
+}
+
+Sorter::Permutation MultikeySorter::sortIndices(const std::vector<City>& cities, Comparator compare) {
+    Permutation indices = identityPermutation(cities.size());
+    std::sort(indices.begin(), indices.end(), IndexComparator<Comparator>{cities, compare});
+    return indices;
+}
@@ -0,0 +1,38 @@
+//
+// Stable parallel merge sort on a work-stealing thread pool.
+//
+
+#include "../../include/algorithms/parallel_merge_sorter.hpp"
+#include <string>
+#include <thread>
+
+ParallelMergeSorter::ParallelMergeSorter() : thread_count_(std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::string ParallelMergeSorter::getName() const {
+    return "pmerge";
+}
+
+bool ParallelMergeSorter::isStable() const {
+    return true;
+}
+
+void ParallelMergeSorter::setThreadCount(unsigned int thread_count) {
+    const unsigned int count = std::max(1u, thread_count);
+    std::lock_guard<std::mutex> lock(this->pool_mutex_);
+    if (count != this->thread_count_) {
+        this->pool_.reset();
+    }
+    this->thread_count_ = count;
+}
+
+unsigned int ParallelMergeSorter::getThreadCount() const {
+    return this->thread_count_;
+}
+
+ThreadPool& ParallelMergeSorter::pool() const {
+    std::lock_guard<std::mutex> lock(this->pool_mutex_);
+    if (!this->pool_) {
+        this->pool_ = std::make_unique<ThreadPool>(this->thread_count_);
+    }
+    return *this->pool_;
+}
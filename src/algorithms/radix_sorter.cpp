@@ -0,0 +1,167 @@
+//
+// LSD radix sort for the numeric City keys (population, lat, lng).
+//
+
+#include "../../include/algorithms/radix_sorter.hpp"
+#include "../../include/algorithms/merge_sorter.hpp"
+#include "../../include/sorting_network.hpp"
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+std::string RadixSorter::getName() const {
+    return "radix";
+}
+
+bool RadixSorter::isStable() const {
+    return true;
+}
+
+std::uint64_t RadixSorter::encodeKey(long value) {
+    return orderedKeyBits(value);
+}
+
+std::uint64_t RadixSorter::encodeKey(double value) {
+    return orderedKeyBits(value);
+}
+
+std::vector<RadixSorter::KeyedIndex> RadixSorter::sortKeys(const std::vector<City>& cities, SortKey key, bool reverse_order) {
+    if (cities.size() > UINT32_MAX) {
+        throw std::length_error("RadixSorter Error: At most 2^32 - 1 rows can be sorted.");
+    }
+    std::vector<KeyedIndex> items(cities.size());
+    for (size_t i = 0; i < cities.size(); ++i) {
+        const City& city = cities[i];
+        std::uint64_t encoded = 0;
+        switch (key) {
+            case SortKey::Population: encoded = encodeKey(city.population); break;
+            case SortKey::Lat:        encoded = encodeKey(city.lat); break;
+            case SortKey::Lng:        encoded = encodeKey(city.lng); break;
+            default: break;
+        }
+        // Complementing the key reverses the order while the counting passes stay stable,
+        // so equal rows keep their input order exactly like the "b < a" comparator would.
+        items[i] = {reverse_order ? ~encoded : encoded, static_cast<std::uint32_t>(i)};
+    }
+    radixSort(items);
+    return items;
+}
+
+void RadixSorter::radixSort(std::vector<KeyedIndex>& items) {
+    const size_t n = items.size();
+    if (n < 2) {
+        return;
+    }
+    // Clearing and scanning eight histograms costs more than sorting a small input
+    // outright. Rows still hold their input position, so (key, index) order is stable.
+    if (n <= SMALL_SORT_MAX) {
+        sortSmallPackedRows(items.data(), n);
+        return;
+    }
+
+    // One histogram per byte, all filled in a single read of the keys.
+    std::vector<std::array<size_t, 256>> counts(8);
+    for (auto& histogram : counts) {
+        histogram.fill(0);
+    }
+    for (const KeyedIndex& item : items) {
+        for (unsigned byte = 0; byte < 8; ++byte) {
+            ++counts[byte][(item.key >> (byte * 8)) & 0xFF];
+        }
+    }
+
+    std::vector<KeyedIndex> buffer(n);
+    std::vector<KeyedIndex>* source = &items;
+    std::vector<KeyedIndex>* target = &buffer;
+
+    for (unsigned byte = 0; byte < 8; ++byte) {
+        std::array<size_t, 256>& histogram = counts[byte];
+        const unsigned shift = byte * 8;
+
+        // Every key shares this byte: the pass would be an identity copy.
+        if (histogram[((*source)[0].key >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : histogram) {
+            size_t bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+        for (const KeyedIndex& item : *source) {
+            (*target)[histogram[(item.key >> shift) & 0xFF]++] = item;
+        }
+        std::swap(source, target);
+    }
+
+    if (source != &items) {
+        items.swap(buffer);
+    }
+}
+
+void RadixSorter::sortByKey(std::vector<City>& cities, SortKey key, bool reverse_order) {
+    if (!isNumericKey(key)) {
+        MergeSorter().sortByKey(cities, key, reverse_order);
+        return;
+    }
+
+    std::vector<KeyedIndex> order = sortKeys(cities, key, reverse_order);
+    std::vector<City> sorted;
+    sorted.reserve(cities.size());
+    for (const KeyedIndex& item : order) {
+        sorted.push_back(std::move(cities[item.index]));
+    }
+    cities.swap(sorted);
+}
+
+Sorter::Permutation RadixSorter::sortIndicesByKey(const std::vector<City>& cities, SortKey key, bool reverse_order) {
+    if (!isNumericKey(key)) {
+        return MergeSorter().sortIndicesByKey(cities, key, reverse_order);
+    }
+
+    std::vector<KeyedIndex> order = sortKeys(cities, key, reverse_order);
+    Permutation indices(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        indices[i] = order[i].index;
+    }
+    return indices;
+}
+
+void RadixSorter::sortByKeys(std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    if (keys.size() == 1) {
+        sortByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+        return;
+    }
+    PackedCompositeKeys packed = packCompositeKeys(cities, keys, reverse_order);
+    if (packed.packed_fields == 0 || !packed.tail.empty()) {
+        MergeSorter().sortByKeys(cities, keys, reverse_order);
+        return;
+    }
+    radixSort(packed.rows);
+    applyPackedOrder(cities, packed.rows);
+}
+
+Sorter::Permutation RadixSorter::sortIndicesByKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    if (keys.size() == 1) {
+        return sortIndicesByKey(cities, keys.front().key, keys.front().descending != reverse_order);
+    }
+    PackedCompositeKeys packed = packCompositeKeys(cities, keys, reverse_order);
+    if (packed.packed_fields == 0 || !packed.tail.empty()) {
+        return MergeSorter().sortIndicesByKeys(cities, keys, reverse_order);
+    }
+    radixSort(packed.rows);
+    return packedRowIndices(packed.rows);
+}
+
+void RadixSorter::sort(std::vector<City>& cities, Comparator compare) {
+    // No key to extract from an opaque comparator: stay stable with merge sort.
+    MergeSorter::sortRange(cities, compare);
+}
+
+Sorter::Permutation RadixSorter::sortIndices(const std::vector<City>& cities, Comparator compare) {
+    Permutation indices = identityPermutation(cities.size());
+    IndexComparator<Comparator> index_compare{cities, compare};
+    MergeSorter::sortRange(indices, index_compare);
+    return indices;
+}
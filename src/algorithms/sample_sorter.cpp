@@ -0,0 +1,34 @@
+//
+// Parallel sample sort: splitters from an oversampled sample, one scatter pass, per-bucket sorts.
+//
+
+#include "../../include/algorithms/sample_sorter.hpp"
+#include <string>
+#include <thread>
+
+SampleSorter::SampleSorter() : thread_count_(std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::string SampleSorter::getName() const {
+    return "samplesort";
+}
+
+void SampleSorter::setThreadCount(unsigned int thread_count) {
+    const unsigned int count = std::max(1u, thread_count);
+    std::lock_guard<std::mutex> lock(this->pool_mutex_);
+    if (count != this->thread_count_) {
+        this->pool_.reset();
+    }
+    this->thread_count_ = count;
+}
+
+unsigned int SampleSorter::getThreadCount() const {
+    return this->thread_count_;
+}
+
+ThreadPool& SampleSorter::pool() const {
+    std::lock_guard<std::mutex> lock(this->pool_mutex_);
+    if (!this->pool_) {
+        this->pool_ = std::make_unique<ThreadPool>(this->thread_count_);
+    }
+    return *this->pool_;
+}
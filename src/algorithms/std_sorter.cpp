@@ -5,12 +5,7 @@
 #include "../../include/algorithms/std_sorter.hpp"
 #include <vector>
 #include <string>
-#include <algorithm> // For std::sort
 
 std::string StdSorter::getName() const {
     return "std";
 }
-
-void StdSorter::sort(std::vector<City>& cities, Comparator compare) {
-    std::sort(cities.begin(), cities.end(), compare);
-}
\ No newline at end of file
@@ -0,0 +1,23 @@
+//
+// TimSort: natural-run detection, minrun insertion sort and galloping merges.
+//
+
+#include "../../include/algorithms/tim_sorter.hpp"
+#include <string>
+
+std::string TimSorter::getName() const {
+    return "tim";
+}
+
+bool TimSorter::isStable() const {
+    return true;
+}
+
+size_t TimSorter::minRunLength(size_t n) {
+    size_t low_bits = 0; // Becomes 1 if any bit shifted off is set
+    while (n >= MIN_MERGE) {
+        low_bits |= n & 1;
+        n >>= 1;
+    }
+    return n + low_bits;
+}
@@ -0,0 +1,231 @@
+//
+// Binary columnar snapshot of a parsed city dataset.
+//
+
+#include <city_snapshot.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+namespace {
+    constexpr char SNAPSHOT_MAGIC[8] = {'C', 'I', 'T', 'Y', 'S', 'N', 'A', 'P'};
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+    struct SnapshotHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t row_count;
+        uint64_t source_size;
+        int64_t  source_mtime;
+        uint64_t lat_offset;
+        uint64_t lng_offset;
+        uint64_t population_offset;
+        uint64_t name_offsets_offset;
+        uint64_t country_offsets_offset;
+        uint64_t heap_offset;
+        uint64_t heap_size;
+    };
+
+    constexpr uint64_t alignTo8(uint64_t value) {
+        return (value + 7u) & ~uint64_t{7u};
+    }
+
+    void writePadding(std::ofstream& out, uint64_t& position, uint64_t target) {
+        static const char zeros[8] = {};
+        out.write(zeros, static_cast<std::streamsize>(target - position));
+        position = target;
+    }
+
+    // True if `count` values of T starting at `offset` are 8-byte aligned and lie inside the file.
+    // Written so that no product or sum can overflow, whatever the header says.
+    template <typename T>
+    bool columnFits(uint64_t offset, uint64_t count, uint64_t file_size) {
+        return offset % 8 == 0 && offset <= file_size && count <= (file_size - offset) / sizeof(T);
+    }
+
+    // String offsets must never decrease and must stay inside the heap: name(row) and
+    // country(row) build a string_view from two neighbours without checking them.
+    bool offsetsValid(const uint32_t* offsets, uint64_t rows, uint64_t heap_size) {
+        for (uint64_t i = 0; i < rows; ++i) {
+            if (offsets[i] > offsets[i + 1]) {
+                return false;
+            }
+        }
+        return offsets[rows] <= heap_size;
+    }
+
+    template <typename T>
+    void writeColumn(std::ofstream& out, uint64_t& position, const std::vector<T>& column) {
+        out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+        position += column.size() * sizeof(T);
+    }
+}
+
+CitySnapshot::SourceInfo CitySnapshot::describeSource(const std::string& csv_path) {
+    std::error_code ec;
+    SourceInfo info;
+    info.size = static_cast<uint64_t>(std::filesystem::file_size(csv_path, ec));
+    if (ec) {
+        throw std::runtime_error("CitySnapshot Error: Could not stat source file: " + csv_path);
+    }
+    info.mtime = static_cast<int64_t>(std::filesystem::last_write_time(csv_path, ec).time_since_epoch().count());
+    if (ec) {
+        throw std::runtime_error("CitySnapshot Error: Could not read modification time of: " + csv_path);
+    }
+    return info;
+}
+
+void CitySnapshot::write(const std::string& snapshot_path, const std::vector<City>& cities, const SourceInfo& source) {
+    const size_t rows = cities.size();
+
+    // Build the string heap and offset columns first; they determine the section sizes.
+    std::string heap;
+    std::vector<uint32_t> name_offsets(rows + 1);
+    std::vector<uint32_t> country_offsets(rows + 1);
+    auto append = [&heap](const std::string& text) {
+        if (heap.size() + text.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("CitySnapshot Error: String heap exceeds 4 GiB.");
+        }
+        heap += text;
+        return static_cast<uint32_t>(heap.size());
+    };
+    for (size_t i = 0; i < rows; ++i) {
+        name_offsets[i + 1] = append(cities[i].name);
+    }
+    country_offsets[0] = static_cast<uint32_t>(heap.size());
+    for (size_t i = 0; i < rows; ++i) {
+        country_offsets[i + 1] = append(cities[i].country);
+    }
+
+    std::vector<double> lat(rows);
+    std::vector<double> lng(rows);
+    std::vector<int64_t> population(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        lat[i] = cities[i].lat;
+        lng[i] = cities[i].lng;
+        population[i] = static_cast<int64_t>(cities[i].population);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.row_count = rows;
+    header.source_size = source.size;
+    header.source_mtime = source.mtime;
+    header.lat_offset = alignTo8(sizeof(SnapshotHeader));
+    header.lng_offset = header.lat_offset + rows * sizeof(double);
+    header.population_offset = header.lng_offset + rows * sizeof(double);
+    header.name_offsets_offset = header.population_offset + rows * sizeof(int64_t);
+    header.country_offsets_offset = alignTo8(header.name_offsets_offset + (rows + 1) * sizeof(uint32_t));
+    header.heap_offset = alignTo8(header.country_offsets_offset + (rows + 1) * sizeof(uint32_t));
+    header.heap_size = heap.size();
+
+    const std::string temp_path = snapshot_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("CitySnapshot Error: Could not create file: " + temp_path);
+        }
+        uint64_t position = 0;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        position += sizeof(header);
+        writePadding(out, position, header.lat_offset);
+        writeColumn(out, position, lat);
+        writeColumn(out, position, lng);
+        writeColumn(out, position, population);
+        writeColumn(out, position, name_offsets);
+        writePadding(out, position, header.country_offsets_offset);
+        writeColumn(out, position, country_offsets);
+        writePadding(out, position, header.heap_offset);
+        out.write(heap.data(), static_cast<std::streamsize>(heap.size()));
+        if (!out) {
+            throw std::runtime_error("CitySnapshot Error: Failed while writing: " + temp_path);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, snapshot_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("CitySnapshot Error: Could not move snapshot into place: " + snapshot_path);
+    }
+}
+
+CitySnapshot::CitySnapshot(const std::string& snapshot_path) : file_(snapshot_path) {
+    const char* base = this->file_.data();
+    const uint64_t file_size = this->file_.size();
+
+    SnapshotHeader header{};
+    if (file_size < sizeof(header)) {
+        throw std::runtime_error("CitySnapshot Error: File too small to be a snapshot: " + snapshot_path);
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error("CitySnapshot Error: Not a city snapshot: " + snapshot_path);
+    }
+    if (header.byte_order != BYTE_ORDER_MARK) {
+        throw std::runtime_error("CitySnapshot Error: Snapshot was written with a different byte order: " + snapshot_path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw std::runtime_error("CitySnapshot Error: Unsupported snapshot version " + std::to_string(header.version)
+                                 + " in " + snapshot_path);
+    }
+
+    // The columns are read in place, so every section must be aligned for its type and
+    // inside the file, and every string offset inside the heap.
+    const uint64_t rows = header.row_count;
+    const bool sections_fit =
+        rows < file_size && // so rows + 1 can't overflow
+        columnFits<double>(header.lat_offset, rows, file_size) &&
+        columnFits<double>(header.lng_offset, rows, file_size) &&
+        columnFits<int64_t>(header.population_offset, rows, file_size) &&
+        columnFits<uint32_t>(header.name_offsets_offset, rows + 1, file_size) &&
+        columnFits<uint32_t>(header.country_offsets_offset, rows + 1, file_size) &&
+        columnFits<char>(header.heap_offset, header.heap_size, file_size);
+    if (!sections_fit) {
+        throw std::runtime_error("CitySnapshot Error: Snapshot is truncated or has misaligned sections: " + snapshot_path);
+    }
+
+    this->source_ = SourceInfo{header.source_size, header.source_mtime};
+    this->row_count_ = static_cast<size_t>(rows);
+    this->lat_ = reinterpret_cast<const double*>(base + header.lat_offset);
+    this->lng_ = reinterpret_cast<const double*>(base + header.lng_offset);
+    this->population_ = reinterpret_cast<const int64_t*>(base + header.population_offset);
+    this->name_offsets_ = reinterpret_cast<const uint32_t*>(base + header.name_offsets_offset);
+    this->country_offsets_ = reinterpret_cast<const uint32_t*>(base + header.country_offsets_offset);
+    this->heap_ = base + header.heap_offset;
+
+    if (!offsetsValid(this->name_offsets_, rows, header.heap_size) ||
+        !offsetsValid(this->country_offsets_, rows, header.heap_size)) {
+        throw std::runtime_error("CitySnapshot Error: Snapshot string heap is corrupt: " + snapshot_path);
+    }
+}
+
+std::string_view CitySnapshot::name(size_t row) const {
+    return {this->heap_ + this->name_offsets_[row], this->name_offsets_[row + 1] - this->name_offsets_[row]};
+}
+
+std::string_view CitySnapshot::country(size_t row) const {
+    return {this->heap_ + this->country_offsets_[row], this->country_offsets_[row + 1] - this->country_offsets_[row]};
+}
+
+std::vector<City> CitySnapshot::toCities() const {
+    std::vector<City> cities(this->row_count_);
+    for (size_t i = 0; i < this->row_count_; ++i) {
+        City& city = cities[i];
+        const std::string_view city_name = this->name(i);
+        const std::string_view city_country = this->country(i);
+        city.name.assign(city_name.data(), city_name.size());
+        city.country.assign(city_country.data(), city_country.size());
+        city.lat = this->lat_[i];
+        city.lng = this->lng_[i];
+        city.population = static_cast<long>(this->population_[i]);
+    }
+    return cities;
+}
@@ -0,0 +1,125 @@
+//
+// Structure-of-arrays container for city data.
+//
+
+#include <city_table.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    // Sorts (key, row) pairs, which keeps the comparisons on one contiguous array,
+    // then returns just the row indices.
+    template <typename T>
+    std::vector<uint32_t> sortNumericColumn(const std::vector<T>& column, bool reverse_order) {
+        std::vector<std::pair<T, uint32_t>> keyed(column.size());
+        for (size_t i = 0; i < column.size(); ++i) {
+            keyed[i] = {column[i], static_cast<uint32_t>(i)};
+        }
+        if (reverse_order) {
+            std::stable_sort(keyed.begin(), keyed.end(),
+                             [](const auto& a, const auto& b) { return b.first < a.first; });
+        } else {
+            std::stable_sort(keyed.begin(), keyed.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
+        }
+        std::vector<uint32_t> permutation(keyed.size());
+        for (size_t i = 0; i < keyed.size(); ++i) {
+            permutation[i] = keyed[i].second;
+        }
+        return permutation;
+    }
+
+    std::vector<uint32_t> sortStringColumn(const std::vector<std::string>& column, bool reverse_order) {
+        std::vector<uint32_t> permutation(column.size());
+        for (size_t i = 0; i < column.size(); ++i) {
+            permutation[i] = static_cast<uint32_t>(i);
+        }
+        if (reverse_order) {
+            std::stable_sort(permutation.begin(), permutation.end(),
+                             [&column](uint32_t a, uint32_t b) { return column[b] < column[a]; });
+        } else {
+            std::stable_sort(permutation.begin(), permutation.end(),
+                             [&column](uint32_t a, uint32_t b) { return column[a] < column[b]; });
+        }
+        return permutation;
+    }
+
+    template <typename T>
+    void gather(std::vector<T>& column, const std::vector<uint32_t>& permutation) {
+        std::vector<T> reordered;
+        reordered.reserve(column.size());
+        for (uint32_t source : permutation) {
+            reordered.push_back(std::move(column[source]));
+        }
+        column.swap(reordered);
+    }
+}
+
+CityTable CityTable::fromCities(const std::vector<City>& cities) {
+    CityTable table;
+    table.dictionary_ = CountryDictionary::build(cities);
+    if (table.dictionary_.empty() && !cities.empty()) {
+        throw std::length_error("CityTable Error: Too many distinct countries to dictionary-encode.");
+    }
+
+    table.names_.reserve(cities.size());
+    table.country_codes_.reserve(cities.size());
+    table.lats_.reserve(cities.size());
+    table.lngs_.reserve(cities.size());
+    table.populations_.reserve(cities.size());
+    for (const City& city : cities) {
+        table.names_.push_back(city.name);
+        table.country_codes_.push_back(table.dictionary_.codeOf(city.country));
+        table.lats_.push_back(city.lat);
+        table.lngs_.push_back(city.lng);
+        table.populations_.push_back(city.population);
+    }
+    return table;
+}
+
+std::vector<City> CityTable::toCities() const {
+    std::vector<City> cities;
+    cities.reserve(this->size());
+    for (size_t i = 0; i < this->size(); ++i) {
+        cities.push_back(this->row(i));
+    }
+    return cities;
+}
+
+City CityTable::row(size_t index) const {
+    return City{this->names_[index], this->country(index), this->lats_[index], this->lngs_[index],
+                this->populations_[index], this->country_codes_[index]};
+}
+
+std::vector<uint32_t> CityTable::sortPermutation(SortKey key, bool reverse_order) const {
+    switch (key) {
+        case SortKey::Name:
+            return sortStringColumn(this->names_, reverse_order);
+        case SortKey::Country:
+            return sortNumericColumn(this->country_codes_, reverse_order); // Codes follow name order
+        case SortKey::Population:
+            return sortNumericColumn(this->populations_, reverse_order);
+        case SortKey::Lat:
+            return sortNumericColumn(this->lats_, reverse_order);
+        case SortKey::Lng:
+            return sortNumericColumn(this->lngs_, reverse_order);
+    }
+    throw std::invalid_argument("CityTable Error: Unknown sort key.");
+}
+
+void CityTable::applyPermutation(const std::vector<uint32_t>& permutation) {
+    if (permutation.size() != this->size()) {
+        throw std::invalid_argument("CityTable Error: Permutation size does not match table size.");
+    }
+    gather(this->names_, permutation);
+    gather(this->country_codes_, permutation);
+    gather(this->lats_, permutation);
+    gather(this->lngs_, permutation);
+    gather(this->populations_, permutation);
+}
+
+void CityTable::sortBy(SortKey key, bool reverse_order) {
+    this->applyPermutation(this->sortPermutation(key, reverse_order));
+}
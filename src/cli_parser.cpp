@@ -3,6 +3,7 @@
 //
 
 #include <cli_parser.hpp>
+#include <composite_key.hpp>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -11,7 +12,7 @@
 #include <algorithm>
 
 const std::vector<std::string> CliParser::valid_algorithms_ = {
-    "bubble", "insertion", "merge", "quick", "heap", "std"
+    "bubble", "insertion", "merge", "quick", "heap", "std", "radix", "multikey", "blockquick", "pmerge", "samplesort", "tim", "heap4", "auto"
 };
 
 const std::vector<std::string> CliParser::valid_keys_ = {
@@ -31,11 +32,17 @@ CliParser::CliParser(int argc, char* argv[]) {
     this->limit_rows_ = std::nullopt;
     this->parseArguments(argc, argv);
 
-    if (algorithm_.empty() && !performance_test_mode_) {
+    if (static_cast<int>(serve_mode_) + static_cast<int>(client_mode_) + static_cast<int>(load_test_mode_) > 1) {
+        throw std::invalid_argument("Error: --serve, --client and --load-test cannot be combined.");
+    }
+    // The server takes its queries from clients, and a client's -a defaults to the server's (auto);
+    // a load test without -k sends a mix of queries.
+    const bool query_optional = performance_test_mode_ || serve_mode_ || load_test_mode_;
+    if (algorithm_.empty() && !query_optional && !client_mode_) {
         CliParser::printUsage(argv[0]);
         throw std::runtime_error("Error: Missing required argument -a <algo>.");
     }
-    if (key_.empty() && !performance_test_mode_) {
+    if (key_.empty() && !query_optional) {
         CliParser::printUsage(argv[0]);
         throw std::runtime_error("Error: Missing required argument -k <key>.");
     }
@@ -84,6 +91,80 @@ void CliParser::parseArguments(int argc, char* argv[]) {
                 CliParser::printUsage(argv[0]);
                 throw std::runtime_error("Error: Argument -n requires an integer value N.");
             }
+        } else if (arg == "-j") {
+            if (i + 1 < argc) {
+                try {
+                    int j_value = std::stoi(argv[++i]);
+                    if (j_value <= 0) {
+                         throw std::invalid_argument("Error: Value for -j must be a positive integer.");
+                    }
+                    this->thread_count_ = j_value;
+                } catch (const std::invalid_argument&) {
+                    throw std::invalid_argument("Error: Invalid integer value provided for -j.");
+                } catch (const std::out_of_range&) {
+                    throw std::out_of_range("Error: Integer value for -j is out of range.");
+                }
+            } else {
+                CliParser::printUsage(argv[0]);
+                throw std::runtime_error("Error: Argument -j requires an integer value N.");
+            }
+        } else if (arg == "--snapshot") {
+            this->snapshot_enabled_ = true;
+        } else if (arg == "--index-sort" || arg == "-I") {
+            this->index_sort_mode_ = true;
+        } else if (arg == "--full-sort") {
+            this->full_sort_mode_ = true;
+        } else if (arg == "--external") {
+            this->external_sort_mode_ = true;
+        } else if (arg == "--memory-budget") {
+            if (i + 1 < argc) {
+                try {
+                    int budget_value = std::stoi(argv[++i]);
+                    if (budget_value <= 0) {
+                         throw std::invalid_argument("Error: Value for --memory-budget must be a positive integer.");
+                    }
+                    this->memory_budget_mib_ = budget_value;
+                } catch (const std::invalid_argument&) {
+                    throw std::invalid_argument("Error: Invalid integer value provided for --memory-budget.");
+                } catch (const std::out_of_range&) {
+                    throw std::out_of_range("Error: Integer value for --memory-budget is out of range.");
+                }
+            } else {
+                CliParser::printUsage(argv[0]);
+                throw std::runtime_error("Error: Argument --memory-budget requires an integer value MiB.");
+            }
+        } else if (arg == "--cache") {
+            this->cache_enabled_ = true;
+        } else if (arg == "--serve") {
+            this->serve_mode_ = true;
+        } else if (arg == "--client") {
+            this->client_mode_ = true;
+        } else if (arg == "--load-test") {
+            this->load_test_mode_ = true;
+        } else if (arg == "--socket") {
+            if (i + 1 < argc && argv[i + 1][0] != '\0') {
+                this->socket_path_ = argv[++i];
+            } else {
+                CliParser::printUsage(argv[0]);
+                throw std::runtime_error("Error: Argument --socket requires a path.");
+            }
+        } else if (arg == "--requests") {
+            if (i + 1 < argc) {
+                try {
+                    int request_value = std::stoi(argv[++i]);
+                    if (request_value <= 0) {
+                         throw std::invalid_argument("Error: Value for --requests must be a positive integer.");
+                    }
+                    this->request_count_ = request_value;
+                } catch (const std::invalid_argument&) {
+                    throw std::invalid_argument("Error: Invalid integer value provided for --requests.");
+                } catch (const std::out_of_range&) {
+                    throw std::out_of_range("Error: Integer value for --requests is out of range.");
+                }
+            } else {
+                CliParser::printUsage(argv[0]);
+                throw std::runtime_error("Error: Argument --requests requires an integer value N.");
+            }
         } else if (arg == "--performance-test" || arg == "-P") { // Choose one or both
             this->performance_test_mode_ = true;
         } else {
@@ -98,7 +179,13 @@ bool CliParser::isValidAlgorithm(const std::string& algo) {
 }
 
 bool CliParser::isValidKey(const std::string& key) {
-     return std::find(CliParser::valid_keys_.begin(), CliParser::valid_keys_.end(), key) != CliParser::valid_keys_.end();
+    // A single key, or a composite such as "country,-population,name".
+    try {
+        parseCompositeKey(key);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+    return true;
 }
 
 const std::string& CliParser::getAlgorithm() const {
@@ -117,20 +204,91 @@ std::optional<int> CliParser::getLimitRows() const {
     return this->limit_rows_;
 }
 
+int CliParser::getThreadCount() const {
+    return this->thread_count_;
+}
+
+bool CliParser::isSnapshotEnabled() const {
+    return this->snapshot_enabled_;
+}
+
+bool CliParser::isIndexSortMode() const {
+    return this->index_sort_mode_;
+}
+
+bool CliParser::isFullSortMode() const {
+    return this->full_sort_mode_;
+}
+
+bool CliParser::isExternalSortMode() const {
+    return this->external_sort_mode_;
+}
+
+int CliParser::getMemoryBudgetMiB() const {
+    return this->memory_budget_mib_;
+}
+
+bool CliParser::isServeMode() const {
+    return this->serve_mode_;
+}
+
+bool CliParser::isClientMode() const {
+    return this->client_mode_;
+}
+
+bool CliParser::isLoadTestMode() const {
+    return this->load_test_mode_;
+}
+
+const std::string& CliParser::getSocketPath() const {
+    return this->socket_path_;
+}
+
+int CliParser::getRequestCount() const {
+    return this->request_count_;
+}
+
+bool CliParser::isCacheEnabled() const {
+    return this->cache_enabled_;
+}
+
 bool CliParser::isPerformanceTestMode() const {
     return this->performance_test_mode_;
 }
 
 void CliParser::printUsage(const char* programName) {
     std::cerr << "Usage: " << (programName ? programName : "citysort")
-              << " -a <algo> -k <key> [-r] [-n N]\n"
+              << " -a <algo> -k <key> [-r] [-n N] [-j N] [--snapshot] [--cache] [-I] [--full-sort] [--external [--memory-budget MiB]]\n"
+              << "       " << (programName ? programName : "citysort") << " --serve [-j N] [--snapshot] [--cache] [--socket PATH]\n"
+              << "       " << (programName ? programName : "citysort") << " --client -k <key> [-a <algo>] [-r] [-n N] [--socket PATH]\n"
+              << "       " << (programName ? programName : "citysort") << " --load-test [-k <key> [-a <algo>] [-r] [-n N]] [-j N] [--requests N] [--socket PATH]\n"
               << "\nOptions:\n"
               << "  -a <algo>         : Sorting algorithm. Required.\n"
-              << "                      <algo>: bubble|insertion|merge|quick|heap|std\n"
-              << "  -k <key>          : Sorting key (column). Required.\n"
-              << "                      <key>: name|country|population|lat|lng\n"
-              << "  -r                : Reverse sort order (descending). Optional.\n"
+              << "                      <algo>: bubble|insertion|merge|quick|heap|std|radix|multikey|blockquick|pmerge|samplesort|tim|heap4|auto\n"
+              << "                      auto samples the input and picks one of the others (the choice is logged).\n"
+              << "  -k <key>          : Sorting key (column), or keys. Required.\n"
+              << "                      <key>: name|country|population|lat|lng, or a comma-separated list sorted in\n"
+              << "                      priority order; prefix a key with '-' to sort it descending (e.g. country,-population).\n"
+              << "  -r                : Reverse sort order (descending; flips every key of a list). Optional.\n"
               << "  -n N              : Print only the first N rows. Optional. N must be > 0.\n"
+              << "                      Only the first N rows are selected (partial sort) instead of sorting everything.\n"
+              << "  -j N              : Worker threads for loading the CSV and for parallel sorters (pmerge, samplesort). Optional. Default 1.\n"
+              << "  --snapshot        : Load from / save to a binary snapshot next to the CSV (<csv>.snap). Optional.\n"
+              << "  --cache           : Keep sorted orders per key in <csv>.perm and answer repeated sorts (either\n"
+              << "                      direction, any -n) from it; cache hits and misses are printed. Optional.\n"
+              << "  --index-sort  -I  : Sort row indices instead of moving City objects. Optional.\n"
+              << "  --full-sort       : Always sort the whole dataset with <algo>, even with -n (for benchmarking). Optional.\n"
+              << "  --external        : External merge sort: stream the CSV in chunks sorted with <algo>, spill sorted\n"
+              << "                      runs to temp files and merge them. For data that does not fit in memory. Optional.\n"
+              << "  --memory-budget M : Memory budget of --external in MiB (at least 1). Optional. Default 64.\n"
+              << "  --serve           : Load the dataset once and answer sort queries on a Unix domain socket until a\n"
+              << "                      client sends SHUTDOWN. -j N queries run at once. Optional.\n"
+              << "  --client          : Send -k/-r/-n/-a as one query to a running --serve and print the reply. -a defaults\n"
+              << "                      to auto. Optional.\n"
+              << "  --load-test       : Send --requests queries over -j connections to a running --serve and report the\n"
+              << "                      throughput and p50/p99 latency. Without -k, a mix of keys and limits. Optional.\n"
+              << "  --socket PATH     : Socket of --serve/--client/--load-test. Optional. Default citysort.sock.\n"
+              << "  --requests N      : Queries sent by --load-test. Optional. Default 1000.\n"
               << "  --performace-test  -P : Run performance logging on all algorithm (this will ignore every other flags).\n"
               << std::endl;
 }
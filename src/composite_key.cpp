@@ -0,0 +1,225 @@
+//
+// Composite sort keys (e.g. "country,-population,name") and their comparators.
+//
+
+#include <composite_key.hpp>
+#include <country_dictionary.hpp>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+template <SortKey Key>
+int compareColumn(const City& a, const City& b) {
+    if constexpr (Key == SortKey::Name) {
+        return a.name.compare(b.name);
+    } else {
+        using Less = KeyLess<Key, false>;
+        if (Less::less(a, b)) {
+            return -1;
+        }
+        return Less::less(b, a) ? 1 : 0;
+    }
+}
+
+using ColumnCompareFn = int (*)(const City&, const City&);
+
+// Indexed by SortKey.
+constexpr ColumnCompareFn column_compare_table[SORT_KEY_COUNT] = {
+    &compareColumn<SortKey::Name>,
+    &compareColumn<SortKey::Country>,
+    &compareColumn<SortKey::Population>,
+    &compareColumn<SortKey::Lat>,
+    &compareColumn<SortKey::Lng>
+};
+
+// Country is exact through its dictionary code if every row has one. Otherwise, and for
+// name, only the string's first bytes fit: ties on them need the full string compare.
+bool isExactlyPackable(const std::vector<City>& cities, SortKey key) {
+    if (key == SortKey::Name) {
+        return false;
+    }
+    if (key == SortKey::Country) {
+        return std::none_of(cities.begin(), cities.end(), [](const City& city) {
+            return city.country_code == CountryDictionary::UNASSIGNED;
+        });
+    }
+    return true;
+}
+
+std::uint64_t encodeField(const City& city, SortKey key, bool exact, bool descending) {
+    std::uint64_t encoded = 0;
+    switch (key) {
+        case SortKey::Name:       encoded = stringPrefixKey(city.name); break;
+        case SortKey::Country:    encoded = exact ? city.country_code : stringPrefixKey(city.country); break;
+        case SortKey::Population: encoded = orderedKeyBits(city.population); break;
+        case SortKey::Lat:        encoded = orderedKeyBits(city.lat); break;
+        case SortKey::Lng:        encoded = orderedKeyBits(city.lng); break;
+    }
+    return descending ? ~encoded : encoded;
+}
+
+unsigned bitWidth(std::uint64_t value) {
+    unsigned bits = 0;
+    while (value != 0) {
+        ++bits;
+        value >>= 1;
+    }
+    return bits;
+}
+
+// A packed field: its encoded values lie in [min, min + 2^bits).
+struct PackedField {
+    SortKey key;
+    bool exact;
+    bool descending;
+    std::uint64_t min;
+    unsigned bits;
+};
+
+} // namespace
+
+std::uint64_t stringPrefixKey(std::string_view text) {
+    // Big-endian, zero-padded: unsigned integer order is the byte-wise order of the prefixes,
+    // the same order std::string::compare gives the strings.
+    std::uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        key <<= 8;
+        if (i < text.size()) {
+            key |= static_cast<unsigned char>(text[i]);
+        }
+    }
+    return key;
+}
+
+CompositeKey parseCompositeKey(const std::string& spec) {
+    CompositeKey keys;
+    size_t begin = 0;
+    while (true) {
+        const size_t end = std::min(spec.find(',', begin), spec.size());
+        std::string part = spec.substr(begin, end - begin);
+        KeyField field{SortKey::Name, false};
+        if (!part.empty() && part.front() == '-') {
+            field.descending = true;
+            part.erase(0, 1);
+        }
+        if (part.empty()) {
+            throw std::invalid_argument("Error: Empty field in sort key list: \"" + spec + "\"");
+        }
+        field.key = parseSortKey(part);
+        for (const KeyField& existing : keys) {
+            if (existing.key == field.key) {
+                throw std::invalid_argument("Error: Sort key appears more than once: " + part);
+            }
+        }
+        keys.push_back(field);
+        if (end == spec.size()) {
+            break;
+        }
+        begin = end + 1;
+    }
+    return keys;
+}
+
+std::string compositeKeyName(const CompositeKey& keys) {
+    std::string name;
+    for (const KeyField& field : keys) {
+        if (!name.empty()) {
+            name += ',';
+        }
+        if (field.descending) {
+            name += '-';
+        }
+        name += sortKeyName(field.key);
+    }
+    return name;
+}
+
+CompositeLess::CompositeLess(const CompositeKey& keys, bool reverse_order) {
+    if (keys.size() > SORT_KEY_COUNT) {
+        throw std::invalid_argument("Error: A composite key has at most one field per column.");
+    }
+    for (const KeyField& field : keys) {
+        this->fields_[this->field_count_++] = {column_compare_table[static_cast<size_t>(field.key)],
+                                               field.descending != reverse_order};
+    }
+}
+
+std::function<bool(const City&, const City&)> createCompositeComparator(const CompositeKey& keys, bool reverse_order) {
+    if (keys.size() == 1) {
+        return createKeyComparator(keys.front().key, keys.front().descending != reverse_order);
+    }
+    return CompositeLess(keys, reverse_order);
+}
+
+PackedCompositeKeys packCompositeKeys(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order) {
+    if (cities.size() > UINT32_MAX) {
+        throw std::length_error("Composite Key Error: At most 2^32 - 1 rows can be packed.");
+    }
+
+    // Take leading fields while their value ranges still fit in 64 bits together. A string
+    // prefix is the last field taken: its ties are settled by the tail, which starts there.
+    std::vector<PackedField> fields;
+    size_t exact_fields = 0;
+    unsigned total_bits = 0;
+    for (const KeyField& key_field : keys) {
+        const bool exact = isExactlyPackable(cities, key_field.key);
+        const bool descending = key_field.descending != reverse_order;
+        std::uint64_t min = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t max = 0;
+        for (const City& city : cities) {
+            const std::uint64_t encoded = encodeField(city, key_field.key, exact, descending);
+            min = std::min(min, encoded);
+            max = std::max(max, encoded);
+        }
+        const unsigned bits = cities.empty() ? 0 : bitWidth(max - min);
+        if (total_bits + bits > 64) {
+            break;
+        }
+        total_bits += bits;
+        fields.push_back({key_field.key, exact, descending, min, bits});
+        if (!exact) {
+            break;
+        }
+        ++exact_fields;
+    }
+
+    PackedCompositeKeys packed;
+    packed.packed_fields = fields.size();
+    packed.tail = CompositeLess(CompositeKey(keys.begin() + static_cast<std::ptrdiff_t>(exact_fields), keys.end()),
+                                reverse_order);
+    if (fields.empty()) {
+        return packed;
+    }
+
+    packed.rows.resize(cities.size());
+    for (size_t i = 0; i < cities.size(); ++i) {
+        std::uint64_t key = 0;
+        for (const PackedField& field : fields) {
+            const std::uint64_t value = encodeField(cities[i], field.key, field.exact, field.descending) - field.min;
+            // A 64-bit field is necessarily the only one; shifting by 64 would be undefined.
+            key = field.bits >= 64 ? value : (key << field.bits) | value;
+        }
+        packed.rows[i] = {key, static_cast<std::uint32_t>(i)};
+    }
+    return packed;
+}
+
+void applyPackedOrder(std::vector<City>& cities, const std::vector<PackedRow>& rows) {
+    std::vector<City> ordered;
+    ordered.reserve(rows.size());
+    for (const PackedRow& row : rows) {
+        ordered.push_back(std::move(cities[row.index]));
+    }
+    cities.swap(ordered);
+}
+
+std::vector<std::uint32_t> packedRowIndices(const std::vector<PackedRow>& rows) {
+    std::vector<std::uint32_t> indices(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        indices[i] = rows[i].index;
+    }
+    return indices;
+}
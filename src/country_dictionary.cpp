@@ -0,0 +1,59 @@
+//
+// Dictionary encoding for the low-cardinality City::country column.
+//
+
+#include <country_dictionary.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_set>
+
+CountryDictionary CountryDictionary::build(const std::vector<City>& cities) {
+    CountryDictionary dictionary;
+    // Deduplicate through views first so only the distinct names are copied and sorted.
+    std::unordered_set<std::string_view> seen;
+    for (const City& city : cities) {
+        seen.insert(city.country);
+    }
+    if (seen.size() > std::numeric_limits<Code>::max()) {
+        return dictionary; // Too many to encode; callers fall back to strings.
+    }
+    dictionary.names_.assign(seen.begin(), seen.end());
+    std::sort(dictionary.names_.begin(), dictionary.names_.end());
+    return dictionary;
+}
+
+CountryDictionary CountryDictionary::encode(std::vector<City>& cities) {
+    CountryDictionary dictionary = build(cities);
+    for (City& city : cities) {
+        city.country_code = dictionary.codeOf(city.country);
+    }
+    return dictionary;
+}
+
+CountryDictionary::Code CountryDictionary::codeOf(std::string_view country) const {
+    auto it = std::lower_bound(this->names_.begin(), this->names_.end(), country,
+                               [](const std::string& name, std::string_view value) { return name < value; });
+    if (it == this->names_.end() || *it != country) {
+        return UNASSIGNED;
+    }
+    return static_cast<Code>(it - this->names_.begin() + 1);
+}
+
+const std::string& CountryDictionary::nameOf(Code code) const {
+    if (code == UNASSIGNED || code > this->names_.size()) {
+        throw std::out_of_range("CountryDictionary Error: Unknown country code " + std::to_string(code));
+    }
+    return this->names_[code - 1];
+}
+
+size_t CountryDictionary::memoryBytes() const {
+    size_t bytes = this->names_.capacity() * sizeof(std::string);
+    for (const std::string& name : this->names_) {
+        if (name.capacity() > std::string().capacity()) { // Beyond the small-string buffer
+            bytes += name.capacity() + 1;
+        }
+    }
+    return bytes;
+}
@@ -5,13 +5,14 @@
 // A minimal csv parser, to be used by other classes
 
 #include <csv_parser.hpp>
+#include <csv_scan.hpp>
 
 #include <sstream>
 #include <iostream>
 #include <utility>
 
-CsvReader::CsvReader(std::string  filename, char delimiter)
-    : filename_(std::move(filename)), delimiter_(delimiter)
+CsvReader::CsvReader(std::string  filename, char delimiter, ParseBackend backend)
+    : filename_(std::move(filename)), delimiter_(delimiter), backend_(backend)
 {
     this->fileStream_.open(this->filename_);
     this->isOpen_ = this->fileStream_.is_open();
@@ -63,6 +64,14 @@ bool CsvReader::readRow(CsvRow& row) {
     }
 }
 void CsvReader::parseLine(const std::string& line, CsvRow& row) const {
+    if (this->backend_ == ParseBackend::Simd) {
+        this->parseLineSimd(line, row);
+    } else {
+        this->parseLineScalar(line, row);
+    }
+}
+
+void CsvReader::parseLineScalar(const std::string& line, CsvRow& row) const {
     std::stringstream fieldBuilder;
     bool inQuotes = false;
 
@@ -102,3 +111,50 @@ void CsvReader::parseLine(const std::string& line, CsvRow& row) const {
 
     row.push_back(fieldBuilder.str());
 }
+
+// Same state machine as parseLineScalar, but only visits the structural characters
+// (delimiters and quotes) found by the vectorized scanner; the bytes in between are
+// appended to the field as whole runs.
+void CsvReader::parseLineSimd(const std::string& line, CsvRow& row) const {
+    this->structuralOffsets_.clear();
+    csv_scan::scanStructural(line, this->delimiter_, this->structuralOffsets_);
+
+    std::string field;
+    bool inQuotes = false;
+    size_t runStart = 0; // First byte not yet appended to field
+    const size_t length = line.length();
+    const size_t count = this->structuralOffsets_.size();
+
+    for (size_t k = 0; k < count; ++k) {
+        const size_t i = this->structuralOffsets_[k];
+        field.append(line, runStart, i - runStart);
+        runStart = i + 1;
+
+        const char currentChar = line[i];
+        if (currentChar == '"') {
+            if (!inQuotes) {
+                if (field.empty()) {
+                    inQuotes = true;
+                } else {
+                    field.push_back('"');
+                }
+            } else if (i + 1 < length && line[i + 1] == '"') {
+                field.push_back('"');
+                runStart = i + 2;
+                ++k; // The second quote is the next structural offset
+            } else if (i + 1 == length || line[i + 1] == this->delimiter_) {
+                inQuotes = false;
+            } else {
+                field.push_back('"');
+            }
+        } else if (currentChar == this->delimiter_ && !inQuotes) {
+            row.push_back(std::move(field));
+            field.clear();
+        } else {
+            field.push_back(currentChar); // Delimiter inside quotes, or a stray '\n'
+        }
+    }
+
+    field.append(line, runStart, length - runStart);
+    row.push_back(std::move(field));
+}
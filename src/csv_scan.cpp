@@ -0,0 +1,251 @@
+//
+// Vectorized scanning of CSV structural characters (delimiter, quote, newline).
+//
+
+#include <csv_scan.hpp>
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CSV_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need the target attribute to emit AVX2 code without -mavx2;
+// MSVC accepts the intrinsics anywhere.
+#if defined(CSV_SCAN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CSV_SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CSV_SCAN_TARGET_AVX2
+#endif
+
+namespace csv_scan {
+
+namespace {
+
+    inline bool isStructural(char c, char delimiter) {
+        return c == delimiter || c == '"' || c == '\n';
+    }
+
+    const char* findStructuralScalar(const char* p, const char* end, char delimiter) {
+        while (p != end && !isStructural(*p, delimiter)) {
+            ++p;
+        }
+        return p;
+    }
+
+    inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+#ifdef CSV_SCAN_X86
+    inline uint32_t structuralMask16(const char* p, __m128i delimiters, __m128i quotes, __m128i newlines) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, delimiters), _mm_cmpeq_epi8(chunk, quotes)),
+                                    _mm_cmpeq_epi8(chunk, newlines));
+        return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+    }
+
+    const char* findStructuralSse2(const char* p, const char* end, char delimiter) {
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        const __m128i quotes = _mm_set1_epi8('"');
+        const __m128i newlines = _mm_set1_epi8('\n');
+        while (end - p >= 16) {
+            uint32_t mask = structuralMask16(p, delimiters, quotes, newlines);
+            if (mask != 0) {
+                return p + countTrailingZeros(mask);
+            }
+            p += 16;
+        }
+        return findStructuralScalar(p, end, delimiter);
+    }
+
+    void scanStructuralSse2(const char* begin, const char* end, char delimiter, std::vector<uint32_t>& offsets) {
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        const __m128i quotes = _mm_set1_epi8('"');
+        const __m128i newlines = _mm_set1_epi8('\n');
+        const char* p = begin;
+        while (end - p >= 16) {
+            uint32_t mask = structuralMask16(p, delimiters, quotes, newlines);
+            const auto base = static_cast<uint32_t>(p - begin);
+            while (mask != 0) {
+                offsets.push_back(base + countTrailingZeros(mask));
+                mask &= mask - 1; // Clear lowest set bit
+            }
+            p += 16;
+        }
+        for (; p != end; ++p) {
+            if (isStructural(*p, delimiter)) {
+                offsets.push_back(static_cast<uint32_t>(p - begin));
+            }
+        }
+    }
+
+    CSV_SCAN_TARGET_AVX2
+    inline uint32_t structuralMask32(const char* p, __m256i delimiters, __m256i quotes, __m256i newlines) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, delimiters), _mm256_cmpeq_epi8(chunk, quotes)),
+                                       _mm256_cmpeq_epi8(chunk, newlines));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+    }
+
+    CSV_SCAN_TARGET_AVX2
+    const char* findStructuralAvx2(const char* p, const char* end, char delimiter) {
+        const __m256i delimiters = _mm256_set1_epi8(delimiter);
+        const __m256i quotes = _mm256_set1_epi8('"');
+        const __m256i newlines = _mm256_set1_epi8('\n');
+        while (end - p >= 32) {
+            uint32_t mask = structuralMask32(p, delimiters, quotes, newlines);
+            if (mask != 0) {
+                return p + countTrailingZeros(mask);
+            }
+            p += 32;
+        }
+        return findStructuralSse2(p, end, delimiter);
+    }
+
+    CSV_SCAN_TARGET_AVX2
+    void scanStructuralAvx2(const char* begin, const char* end, char delimiter, std::vector<uint32_t>& offsets) {
+        const __m256i delimiters = _mm256_set1_epi8(delimiter);
+        const __m256i quotes = _mm256_set1_epi8('"');
+        const __m256i newlines = _mm256_set1_epi8('\n');
+        const char* p = begin;
+        while (end - p >= 32) {
+            uint32_t mask = structuralMask32(p, delimiters, quotes, newlines);
+            const auto base = static_cast<uint32_t>(p - begin);
+            while (mask != 0) {
+                offsets.push_back(base + countTrailingZeros(mask));
+                mask &= mask - 1;
+            }
+            p += 32;
+        }
+        for (; p != end; ++p) {
+            if (isStructural(*p, delimiter)) {
+                offsets.push_back(static_cast<uint32_t>(p - begin));
+            }
+        }
+    }
+
+    bool cpuHasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+        return false;
+#endif
+    }
+#endif // CSV_SCAN_X86
+
+    void scanStructuralScalar(const char* begin, const char* end, char delimiter, std::vector<uint32_t>& offsets) {
+        for (const char* p = begin; p != end; ++p) {
+            if (isStructural(*p, delimiter)) {
+                offsets.push_back(static_cast<uint32_t>(p - begin));
+            }
+        }
+    }
+
+    Kernel detectBestKernel() {
+#ifdef CSV_SCAN_X86
+        return cpuHasAvx2() ? Kernel::Avx2 : Kernel::Sse2;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    std::atomic<Kernel>& currentKernel() {
+        static std::atomic<Kernel> kernel{detectBestKernel()};
+        return kernel;
+    }
+
+} // namespace
+
+const char* findStructural(const char* begin, const char* end, char delimiter) {
+    switch (currentKernel().load(std::memory_order_relaxed)) {
+#ifdef CSV_SCAN_X86
+        case Kernel::Avx2:
+            return findStructuralAvx2(begin, end, delimiter);
+        case Kernel::Sse2:
+            return findStructuralSse2(begin, end, delimiter);
+#endif
+        default:
+            return findStructuralScalar(begin, end, delimiter);
+    }
+}
+
+size_t scanStructural(std::string_view data, char delimiter, std::vector<uint32_t>& offsets) {
+    const size_t before = offsets.size();
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+    switch (currentKernel().load(std::memory_order_relaxed)) {
+#ifdef CSV_SCAN_X86
+        case Kernel::Avx2:
+            scanStructuralAvx2(begin, end, delimiter, offsets);
+            break;
+        case Kernel::Sse2:
+            scanStructuralSse2(begin, end, delimiter, offsets);
+            break;
+#endif
+        default:
+            scanStructuralScalar(begin, end, delimiter, offsets);
+            break;
+    }
+    return offsets.size() - before;
+}
+
+Kernel activeKernel() {
+    return currentKernel().load(std::memory_order_relaxed);
+}
+
+bool isSupported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+#ifdef CSV_SCAN_X86
+        case Kernel::Sse2:
+            return true;
+        case Kernel::Avx2:
+            return cpuHasAvx2();
+#endif
+        default:
+            return false;
+    }
+}
+
+bool setKernel(Kernel kernel) {
+    if (!isSupported(kernel)) {
+        return false;
+    }
+    currentKernel().store(kernel, std::memory_order_relaxed);
+    return true;
+}
+
+std::string kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Avx2:
+            return "avx2";
+        case Kernel::Sse2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+} // namespace csv_scan
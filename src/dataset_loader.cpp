@@ -1,14 +1,199 @@
 #include <dataset_loader.hpp> // Class declaration
-#include <sstream>      // For std::stringstream, std::stod, std::stol
-#include <stdexcept>    // For std::runtime_error, std::invalid_argument, std::out_of_range
+#include <mmap_csv_reader.hpp> // Zero-copy reader backend
+#include <field_decoder.hpp>   // Non-throwing numeric decoding
+#include <filesystem>   // For std::filesystem::exists (snapshot lookup)
+#include <sstream>      // For std::ostringstream (skip summary)
+#include <stdexcept>    // For std::runtime_error
 #include <iostream>     // For std::cerr (error reporting for skipped rows)
+#include <string_view>
 #include <utility>
+#include <thread>
+#include <exception>
+#include <iterator>
 
-DatasetLoader::DatasetLoader(std::string  csv_filepath)
-    : filepath_(std::move(csv_filepath)) {} // Initializer list is idiomatic for constructors
+DatasetLoader::DatasetLoader(std::string  csv_filepath, CsvBackend backend)
+    : filepath_(std::move(csv_filepath)), backend_(backend) {} // Initializer list is idiomatic for constructors
+
+// Converts one CSV row into a City. Returns the reason the row must be skipped, or
+// SkipReason::None if city_obj was filled in.
+// Row is either CsvRow (owned strings) or CsvRowView (views into a mapped file).
+template <typename Row>
+DatasetLoader::SkipReason DatasetLoader::parseCityRow(const Row& current_csv_row, City& city_obj) {
+    // Check if the row has enough columns to access all required fields
+    if (current_csv_row.size() < EXPECTED_MIN_COLUMNS) {
+        return SkipReason::TooFewColumns;
+    }
+
+    // Requirement: Skip rows with missing population.
+    // Population must be valid, otherwise skip.
+    switch (decodeLong(current_csv_row[COL_POPULATION], city_obj.population)) {
+        case DecodeStatus::Ok:
+            break;
+        case DecodeStatus::Empty:
+            return SkipReason::MissingPopulation;
+        case DecodeStatus::Invalid:
+            return SkipReason::InvalidPopulation;
+        case DecodeStatus::OutOfRange:
+            return SkipReason::PopulationOutOfRange;
+    }
+
+    // If population is valid, proceed to parse other fields.
+    // If other fields are invalid, we will also skip the row for data integrity.
+    const DecodeStatus lat_status = decodeDouble(current_csv_row[DatasetLoader::COL_LAT], city_obj.lat);
+    const DecodeStatus lng_status = decodeDouble(current_csv_row[DatasetLoader::COL_LNG], city_obj.lng);
+    if (lat_status == DecodeStatus::Empty || lng_status == DecodeStatus::Empty) {
+        return SkipReason::MissingCoordinates;
+    }
+    if (lat_status != DecodeStatus::Ok || lng_status != DecodeStatus::Ok) {
+        return SkipReason::InvalidCoordinates;
+    }
+
+    city_obj.name.assign(current_csv_row[DatasetLoader::COL_CITY_ASCII].data(),
+                         current_csv_row[DatasetLoader::COL_CITY_ASCII].size());
+    city_obj.country.assign(current_csv_row[DatasetLoader::COL_COUNTRY].data(),
+                            current_csv_row[DatasetLoader::COL_COUNTRY].size());
+    return SkipReason::None;
+}
 
 std::vector<City> DatasetLoader::loadAndParseCities() {
+    this->last_stats_ = LoadStats{};
+    this->last_load_used_snapshot_ = false;
+
+    CitySnapshot::SourceInfo source;
+    if (this->snapshot_enabled_) {
+        source = CitySnapshot::describeSource(this->filepath_);
+        if (std::optional<std::vector<City>> cached = this->loadFromSnapshot(source)) {
+            this->last_stats_.loaded = cached->size();
+            this->last_load_used_snapshot_ = true;
+            this->country_dictionary_ = CountryDictionary::encode(*cached);
+            std::cout << "Info: Loaded " << cached->size() << " cities from snapshot '" << this->getSnapshotPath() << "'." << std::endl;
+            return std::move(*cached);
+        }
+    }
+
+    std::vector<City> cities = (this->backend_ == CsvBackend::Mmap)
+        ? this->loadWithMmapReader()
+        : this->loadWithStreamReader();
+    this->last_stats_.loaded = cities.size();
+    this->country_dictionary_ = CountryDictionary::encode(cities);
+
+    std::cout << "Info: Successfully parsed " << cities.size() << " cities from '" << this->filepath_ << "'." << std::endl;
+    if (this->last_stats_.totalSkipped() > 0) {
+        std::cout << "Info: " << this->last_stats_.summary() << std::endl;
+    }
+
+    if (this->snapshot_enabled_) {
+        try {
+            CitySnapshot::write(this->getSnapshotPath(), cities, source);
+            std::cout << "Info: Wrote snapshot '" << this->getSnapshotPath() << "'." << std::endl;
+        } catch (const std::exception& e) {
+            // A missing snapshot only costs speed on the next run, so don't fail the load.
+            std::cerr << "Warning: " << e.what() << std::endl;
+        }
+    }
+    return cities;
+}
+
+std::optional<std::vector<City>> DatasetLoader::loadFromSnapshot(const CitySnapshot::SourceInfo& source) const {
+    const std::string snapshot_path = this->getSnapshotPath();
+    std::error_code ec;
+    if (!std::filesystem::exists(snapshot_path, ec)) {
+        return std::nullopt;
+    }
+    try {
+        CitySnapshot snapshot(snapshot_path);
+        if (!snapshot.isFreshFor(source)) {
+            std::cout << "Info: Snapshot '" << snapshot_path << "' is stale; re-parsing the CSV." << std::endl;
+            return std::nullopt;
+        }
+        return snapshot.toCities();
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Ignoring unreadable snapshot: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+void DatasetLoader::setSnapshotEnabled(bool enabled) {
+    this->snapshot_enabled_ = enabled;
+}
+
+bool DatasetLoader::isSnapshotEnabled() const {
+    return this->snapshot_enabled_;
+}
+
+std::string DatasetLoader::getSnapshotPath() const {
+    return this->filepath_ + ".snap";
+}
+
+const CountryDictionary& DatasetLoader::getCountryDictionary() const {
+    return this->country_dictionary_;
+}
+
+bool DatasetLoader::lastLoadUsedSnapshot() const {
+    return this->last_load_used_snapshot_;
+}
+
+const DatasetLoader::LoadStats& DatasetLoader::getLastLoadStats() const {
+    return this->last_stats_;
+}
+
+size_t DatasetLoader::LoadStats::totalSkipped() const {
+    size_t total = 0;
+    for (size_t count : this->skipped) {
+        total += count;
+    }
+    return total;
+}
+
+void DatasetLoader::LoadStats::merge(const LoadStats& other) {
+    this->loaded += other.loaded;
+    for (size_t i = 0; i < this->skipped.size(); ++i) {
+        this->skipped[i] += other.skipped[i];
+    }
+}
+
+std::string DatasetLoader::LoadStats::summary() const {
+    static const char* const reason_names[SKIP_REASON_COUNT] = {
+        "none", "too few columns", "missing population", "invalid population",
+        "population out of range", "missing lat/lng", "invalid lat/lng"
+    };
+    std::ostringstream line;
+    line << "Skipped " << this->totalSkipped() << " rows (";
+    bool first = true;
+    for (size_t i = 1; i < SKIP_REASON_COUNT; ++i) {
+        if (this->skipped[i] == 0) {
+            continue;
+        }
+        line << (first ? "" : ", ") << reason_names[i] << ": " << this->skipped[i];
+        first = false;
+    }
+    line << ").";
+    return line.str();
+}
+
+std::vector<City> DatasetLoader::loadWithStreamReader() {
     std::vector<City> cities;
+    this->readWithStreamReader([&cities](City&& city) { cities.push_back(std::move(city)); });
+    return cities;
+}
+
+size_t DatasetLoader::streamCities(const std::function<void(City&&)>& consume) {
+    this->last_stats_ = LoadStats{};
+    this->last_load_used_snapshot_ = false;
+
+    this->readWithStreamReader([this, &consume](City&& city) {
+        ++this->last_stats_.loaded;
+        consume(std::move(city));
+    });
+
+    std::cout << "Info: Successfully streamed " << this->last_stats_.loaded << " cities from '" << this->filepath_ << "'." << std::endl;
+    if (this->last_stats_.totalSkipped() > 0) {
+        std::cout << "Info: " << this->last_stats_.summary() << std::endl;
+    }
+    return this->last_stats_.loaded;
+}
+
+void DatasetLoader::readWithStreamReader(const std::function<void(City&&)>& consume) {
     // CsvReader constructor throws std::runtime_error if file can't be opened
     CsvReader reader(this->filepath_);
 
@@ -17,91 +202,102 @@ std::vector<City> DatasetLoader::loadAndParseCities() {
     if (!reader.readRow(header_row)) {
         // File is empty or header couldn't be read
         std::cerr << "Warning: CSV file '" << this->filepath_ << "' is empty or header could not be read." << std::endl;
-        return cities; // Return empty vector
+        return;
     }
 
     CsvRow current_csv_row;
-    unsigned int line_number = 1; // Start counting after header
-
     while (reader.readRow(current_csv_row)) {
-        line_number++;
-
-        // Check if the row has enough columns to access all required fields
-        if (current_csv_row.size() < EXPECTED_MIN_COLUMNS) {
-            // std::cerr << "Warning (Line " << line_number << "): Skipping row due to insufficient columns. Expected at least "
-                      // << EXPECTED_MIN_COLUMNS << ", got " << current_csv_row.size() << "." << std::endl;
-            continue;
+        City city_obj;
+        SkipReason reason = parseCityRow(current_csv_row, city_obj);
+        if (reason == SkipReason::None) {
+            consume(std::move(city_obj));
+        } else {
+            this->last_stats_.skipped[static_cast<size_t>(reason)]++;
         }
+    }
+}
 
-        // Requirement: Skip rows with missing population.
-        // The population field is at COL_POPULATION.
-        const std::string& population_str = current_csv_row[COL_POPULATION];
-        if (population_str.empty()) {
-//            std::cerr << "Info (Line " << line_number << "): Skipping row due to missing (empty) population data." << std::endl;
-            continue;
-        }
-
-
-        try {
-            City city_obj;
-            // Population (must be valid, otherwise skip)
-            try {
-                city_obj.population = std::stol(population_str);
-                // Optionally, one could also skip if population is <= 0, if that's considered invalid/missing.
-            } catch (const std::invalid_argument&) {
-//                std::cerr << "Info (Line " << line_number << "): Skipping row due to non-numeric population: '" << population_str << "'." << std::endl;
-                continue; // Skip row as population is not a valid number
-            } catch (const std::out_of_range&) {
-//                std::cerr << "Info (Line " << line_number << "): Skipping row due to out-of-range population: '" << population_str << "'." << std::endl;
-                continue; // Skip row as population number is too large/small for long
-            }
-
-            // If population is valid, proceed to parse other fields.
-            // If other fields are invalid, we will also skip the row for data integrity.
-            city_obj.name = current_csv_row[DatasetLoader::COL_CITY_ASCII];
-            city_obj.country = current_csv_row[DatasetLoader::COL_COUNTRY];
+std::vector<City> DatasetLoader::loadWithMmapReader() {
+    std::vector<City> cities;
+    // MappedFile constructor throws std::runtime_error if file can't be opened or mapped
+    MappedFile file(this->filepath_);
 
-            const std::string& lat_str = current_csv_row[DatasetLoader::COL_LAT];
-            const std::string& lng_str = current_csv_row[DatasetLoader::COL_LNG];
+    // Skip header row
+    CsvViewReader header_reader(file.view());
+    CsvRowView header_row;
+    if (!header_reader.readRow(header_row)) {
+        std::cerr << "Warning: CSV file '" << this->filepath_ << "' is empty or header could not be read." << std::endl;
+        return cities;
+    }
+    const std::string_view body = file.view().substr(header_reader.position());
 
-            if (lat_str.empty() || lng_str.empty()) {
-//                std::cerr << "Info (Line " << line_number << "): Skipping row due to missing latitude or longitude." << std::endl;
-                continue;
-            }
+    // Record-aligned byte ranges, one per worker; a single range when running sequentially.
+    const std::vector<size_t> splits = splitAtRecordBoundaries(body, this->thread_count_);
+    const size_t parts = splits.size() - 1;
 
-            try {
-                city_obj.lat = std::stod(lat_str);
-            } catch (const std::invalid_argument&) {
-                // std::cerr << "Info (Line " << line_number << "): Skipping row due to invalid latitude: '" << lat_str << "'." << std::endl;
-                continue;
-            } catch (const std::out_of_range&) {
-                // std::cerr << "Info (Line " << line_number << "): Skipping row due to out-of-range latitude: '" << lat_str << "'." << std::endl;
-                continue;
-            }
+    std::vector<std::vector<City>> partial_results(parts);
+    std::vector<LoadStats> partial_stats(parts);
+    std::vector<std::exception_ptr> errors(parts);
+    auto parse_range = [&](size_t part) {
+        try {
+            const std::string_view range = body.substr(splits[part], splits[part + 1] - splits[part]);
+            std::vector<City>& out = partial_results[part];
+            // worldcities rows are ~100 bytes; a rough reservation avoids most regrowth.
+            out.reserve(range.size() / 100);
 
-            try {
-                city_obj.lng = std::stod(lng_str);
-            } catch (const std::invalid_argument&) {
-                // std::cerr << "Info (Line " << line_number << "): Skipping row due to invalid longitude: '" << lng_str << "'." << std::endl;
-                continue;
-            } catch (const std::out_of_range&) {
-                // std::cerr << "Info (Line " << line_number << "): Skipping row due to out-of-range longitude: '" << lng_str << "'." << std::endl;
-                continue;
+            CsvViewReader reader(range);
+            CsvRowView current_csv_row;
+            while (reader.readRow(current_csv_row)) {
+                City city_obj;
+                SkipReason reason = parseCityRow(current_csv_row, city_obj);
+                if (reason == SkipReason::None) {
+                    out.push_back(std::move(city_obj));
+                } else {
+                    partial_stats[part].skipped[static_cast<size_t>(reason)]++;
+                }
             }
+        } catch (...) {
+            errors[part] = std::current_exception();
+        }
+    };
 
-            // If all necessary fields are parsed successfully
-            cities.push_back(city_obj);
-
-        } catch (const std::out_of_range& oor_idx) {
-            // This primarily catches potential out_of_range from std::stod/std::stol,
-            // as vector operator[] itself doesn't throw this.
-            // The size check above prevents vector access issues.
-            // std::cerr << "Error (Line " << line_number << "): Skipping row due to unexpected out-of-range issue during parsing. "
-                      // << oor_idx.what() << std::endl;
-            continue;
+    std::vector<std::thread> workers;
+    workers.reserve(parts - 1);
+    for (size_t part = 1; part < parts; ++part) {
+        workers.emplace_back(parse_range, part);
+    }
+    parse_range(0); // The calling thread takes the first range
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
         }
     }
+    for (const auto& stats : partial_stats) {
+        this->last_stats_.merge(stats);
+    }
 
-    std::cout << "Info: Successfully parsed " << cities.size() << " cities from '" << this->filepath_ << "'." << std::endl;
+    // Concatenate in original file order.
+    if (parts == 1) {
+        return std::move(partial_results[0]);
+    }
+    size_t total = 0;
+    for (const auto& part : partial_results) {
+        total += part.size();
+    }
+    cities.reserve(total);
+    for (auto& part : partial_results) {
+        std::move(part.begin(), part.end(), std::back_inserter(cities));
+    }
     return cities;
-}
\ No newline at end of file
+}
+
+void DatasetLoader::setThreadCount(unsigned int thread_count) {
+    this->thread_count_ = thread_count == 0 ? 1 : thread_count;
+}
+
+unsigned int DatasetLoader::getThreadCount() const {
+    return this->thread_count_;
+}
@@ -0,0 +1,341 @@
+//
+// External merge sort: sorted runs spilled to temporary files, merged with a loser tree.
+//
+
+#include <external_sorter.hpp>
+#include <loser_tree.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr char RUN_MAGIC[8] = {'C', 'I', 'T', 'Y', 'R', 'U', 'N', '1'};
+
+// Heap bytes owned by a string (nothing while it fits the small-string buffer).
+size_t heapBytes(const std::string& text) {
+    static const size_t inline_capacity = std::string().capacity();
+    return text.capacity() > inline_capacity ? text.capacity() + 1 : 0;
+}
+
+class RunWriter {
+public:
+    explicit RunWriter(const std::string& path) : path_(path), buffer_(ExternalSorter::MERGE_BUFFER_BYTES) {
+        this->out_.rdbuf()->pubsetbuf(this->buffer_.data(), static_cast<std::streamsize>(this->buffer_.size()));
+        this->out_.open(path, std::ios::binary | std::ios::trunc);
+        if (!this->out_) {
+            throw std::runtime_error("External Sort Error: Cannot create run file: " + path);
+        }
+        this->out_.write(RUN_MAGIC, sizeof(RUN_MAGIC));
+        this->bytes_written_ = sizeof(RUN_MAGIC);
+    }
+
+    void write(const City& city) {
+        if (city.name.size() > std::numeric_limits<std::uint16_t>::max() ||
+            city.country.size() > std::numeric_limits<std::uint16_t>::max()) {
+            throw std::runtime_error("External Sort Error: City name or country longer than 65535 bytes.");
+        }
+        const auto name_length = static_cast<std::uint16_t>(city.name.size());
+        const auto country_length = static_cast<std::uint16_t>(city.country.size());
+        const auto population = static_cast<std::int64_t>(city.population);
+        this->writeValue(name_length);
+        this->writeValue(country_length);
+        this->writeValue(city.lat);
+        this->writeValue(city.lng);
+        this->writeValue(population);
+        this->out_.write(city.name.data(), name_length);
+        this->out_.write(city.country.data(), country_length);
+        this->bytes_written_ += sizeof(name_length) + sizeof(country_length) + sizeof(city.lat) + sizeof(city.lng) +
+                                sizeof(population) + name_length + country_length;
+    }
+
+    void close() {
+        this->out_.close();
+        if (this->out_.fail()) {
+            throw std::runtime_error("External Sort Error: Failed writing run file: " + this->path_);
+        }
+    }
+
+    [[nodiscard]] size_t bytesWritten() const {
+        return this->bytes_written_;
+    }
+
+private:
+    std::string path_;
+    std::vector<char> buffer_;
+    std::ofstream out_;
+    size_t bytes_written_ = 0;
+
+    template <typename T>
+    void writeValue(const T& value) {
+        this->out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+};
+
+class RunReader {
+public:
+    explicit RunReader(const std::string& path) : path_(path), buffer_(ExternalSorter::MERGE_BUFFER_BYTES) {
+        this->in_.rdbuf()->pubsetbuf(this->buffer_.data(), static_cast<std::streamsize>(this->buffer_.size()));
+        this->in_.open(path, std::ios::binary);
+        char magic[sizeof(RUN_MAGIC)];
+        if (!this->in_ || !this->in_.read(magic, sizeof(magic)) || std::memcmp(magic, RUN_MAGIC, sizeof(magic)) != 0) {
+            throw std::runtime_error("External Sort Error: Cannot read run file: " + path);
+        }
+    }
+
+    // Reads the next city; false at the end of the run.
+    bool next(City& city) {
+        std::uint16_t name_length = 0;
+        if (!this->in_.read(reinterpret_cast<char*>(&name_length), sizeof(name_length))) {
+            if (this->in_.gcount() == 0 && this->in_.eof()) {
+                return false;
+            }
+            this->throwTruncated();
+        }
+        std::uint16_t country_length = 0;
+        std::int64_t population = 0;
+        this->readValue(country_length);
+        this->readValue(city.lat);
+        this->readValue(city.lng);
+        this->readValue(population);
+        city.population = static_cast<long>(population);
+        city.name.resize(name_length);
+        city.country.resize(country_length);
+        this->in_.read(city.name.data(), name_length);
+        this->in_.read(city.country.data(), country_length);
+        if (!this->in_) {
+            this->throwTruncated();
+        }
+        city.country_code = 0;
+        return true;
+    }
+
+private:
+    std::string path_;
+    std::vector<char> buffer_;
+    std::ifstream in_;
+
+    template <typename T>
+    void readValue(T& value) {
+        this->in_.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    [[noreturn]] void throwTruncated() const {
+        throw std::runtime_error("External Sort Error: Truncated run file: " + this->path_);
+    }
+};
+
+} // namespace
+
+// k-way merge of run files; the head of every run is kept decoded in heads_.
+class ExternalSorter::RunMerger {
+public:
+    RunMerger(const std::vector<std::string>& paths, const Sorter::Comparator& less) : less_(less) {
+        for (const std::string& path : paths) {
+            this->readers_.push_back(std::make_unique<RunReader>(path));
+            this->heads_.emplace_back();
+            this->live_.push_back(this->readers_.back()->next(this->heads_.back()));
+        }
+        if (!paths.empty()) {
+            this->tree_.emplace(paths.size(), Beats{this});
+        }
+    }
+
+    bool next(City& city) {
+        if (!this->tree_) {
+            return false;
+        }
+        const size_t winner = this->tree_->winner();
+        if (!this->live_[winner]) {
+            return false; // The best source is exhausted, so all are.
+        }
+        city = std::move(this->heads_[winner]);
+        this->live_[winner] = this->readers_[winner]->next(this->heads_[winner]);
+        this->tree_->replay(winner);
+        return true;
+    }
+
+private:
+    struct Beats {
+        const RunMerger* merger;
+        bool operator()(size_t a, size_t b) const { return merger->beats(a, b); }
+    };
+
+    const Sorter::Comparator& less_;
+    std::vector<std::unique_ptr<RunReader>> readers_;
+    std::vector<City> heads_;
+    std::vector<bool> live_;
+    std::optional<LoserTree<Beats>> tree_;
+
+    // Exhausted runs lose; equal heads go to the earlier run (stability).
+    [[nodiscard]] bool beats(size_t a, size_t b) const {
+        if (this->live_[a] != this->live_[b]) {
+            return this->live_[a];
+        }
+        if (!this->live_[a]) {
+            return a < b;
+        }
+        if (this->less_(this->heads_[a], this->heads_[b])) {
+            return true;
+        }
+        if (this->less_(this->heads_[b], this->heads_[a])) {
+            return false;
+        }
+        return a < b;
+    }
+};
+
+ExternalSorter::ExternalSorter(Sorter& sorter, SortKey key, bool reverse_order, size_t memory_budget_bytes,
+                               std::string temp_directory)
+    : ExternalSorter(sorter, CompositeKey{{key, false}}, reverse_order, memory_budget_bytes, std::move(temp_directory)) {
+}
+
+ExternalSorter::ExternalSorter(Sorter& sorter, CompositeKey keys, bool reverse_order, size_t memory_budget_bytes,
+                               std::string temp_directory)
+    : sorter_(sorter),
+      keys_(std::move(keys)),
+      reverse_order_(reverse_order),
+      less_(createCompositeComparator(this->keys_, reverse_order)),
+      memory_budget_(memory_budget_bytes),
+      temp_directory_(std::move(temp_directory)) {
+    if (memory_budget_bytes < MIN_MEMORY_BUDGET) {
+        throw std::invalid_argument("External Sort Error: The memory budget must be at least 1 MiB.");
+    }
+    if (this->temp_directory_.empty()) {
+        this->temp_directory_ = std::filesystem::temp_directory_path().string();
+    }
+    this->chunk_row_capacity_ = memory_budget_bytes / 4 / sizeof(City);
+    this->chunk_string_budget_ = memory_budget_bytes / 4;
+    this->chunk_.reserve(this->chunk_row_capacity_);
+
+    std::random_device random;
+    this->run_prefix_ = "citysort-" + std::to_string(random()) + "-";
+}
+
+ExternalSorter::~ExternalSorter() {
+    this->merger_.reset(); // Close the files before removing them
+    for (const std::string& path : this->temp_files_) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+void ExternalSorter::add(City city) {
+    if (this->finished_) {
+        throw std::runtime_error("External Sort Error: add() called after finish().");
+    }
+    this->chunk_string_bytes_ += heapBytes(city.name) + heapBytes(city.country);
+    this->chunk_.push_back(std::move(city));
+    ++this->stats_.rows;
+    if (this->chunk_.size() >= this->chunk_row_capacity_ || this->chunk_string_bytes_ >= this->chunk_string_budget_) {
+        this->spillChunk();
+    }
+}
+
+const ExternalSorter::Stats& ExternalSorter::finish() {
+    if (this->finished_) {
+        return this->stats_;
+    }
+    this->finished_ = true;
+    this->stats_.max_fan_in = this->maxFanIn();
+
+    if (this->runs_.empty()) {
+        this->sorter_.sortByKeys(this->chunk_, this->keys_, this->reverse_order_);
+        this->in_memory_ = true;
+        return this->stats_;
+    }
+    this->spillChunk();
+    std::vector<City>().swap(this->chunk_); // The merge buffers get the memory back
+
+    const size_t fan_in = this->stats_.max_fan_in;
+    while (this->runs_.size() > fan_in) {
+        std::vector<std::string> merged_runs;
+        for (size_t first = 0; first < this->runs_.size(); first += fan_in) {
+            const std::vector<std::string> group(this->runs_.begin() + static_cast<std::ptrdiff_t>(first),
+                                                 this->runs_.begin() + static_cast<std::ptrdiff_t>(std::min(first + fan_in, this->runs_.size())));
+            if (group.size() == 1) {
+                merged_runs.push_back(group.front());
+                continue;
+            }
+            const std::string path = this->createRunPath();
+            {
+                RunMerger merger(group, this->less_);
+                RunWriter writer(path);
+                City city;
+                while (merger.next(city)) {
+                    writer.write(city);
+                }
+                writer.close();
+                this->stats_.spilled_bytes += writer.bytesWritten();
+            }
+            merged_runs.push_back(path);
+            for (const std::string& run : group) {
+                std::error_code ec;
+                std::filesystem::remove(run, ec);
+            }
+        }
+        this->runs_ = std::move(merged_runs);
+        ++this->stats_.merge_passes;
+    }
+    this->merger_ = std::make_unique<RunMerger>(this->runs_, this->less_);
+    return this->stats_;
+}
+
+bool ExternalSorter::next(City& city) {
+    if (!this->finished_) {
+        throw std::runtime_error("External Sort Error: next() called before finish().");
+    }
+    if (this->in_memory_) {
+        if (this->next_in_memory_row_ >= this->chunk_.size()) {
+            return false;
+        }
+        city = std::move(this->chunk_[this->next_in_memory_row_++]);
+        return true;
+    }
+    return this->merger_->next(city);
+}
+
+const ExternalSorter::Stats& ExternalSorter::getStats() const {
+    return this->stats_;
+}
+
+size_t ExternalSorter::getChunkRowCapacity() const {
+    return this->chunk_row_capacity_;
+}
+
+void ExternalSorter::spillChunk() {
+    if (this->chunk_.empty()) {
+        return;
+    }
+    this->sorter_.sortByKeys(this->chunk_, this->keys_, this->reverse_order_);
+    const std::string path = this->createRunPath();
+    RunWriter writer(path);
+    for (const City& city : this->chunk_) {
+        writer.write(city);
+    }
+    writer.close();
+    this->runs_.push_back(path);
+    this->stats_.spilled_bytes += writer.bytesWritten();
+    ++this->stats_.initial_runs;
+    this->chunk_.clear();
+    this->chunk_string_bytes_ = 0;
+}
+
+std::string ExternalSorter::createRunPath() {
+    std::filesystem::path path = std::filesystem::path(this->temp_directory_) /
+                                 (this->run_prefix_ + std::to_string(this->temp_files_.size()) + ".run");
+    this->temp_files_.push_back(path.string());
+    return this->temp_files_.back();
+}
+
+size_t ExternalSorter::maxFanIn() const {
+    // One read buffer per run, plus one for the writer of an intermediate pass.
+    return std::clamp<size_t>(this->memory_budget_ / MERGE_BUFFER_BYTES - 1, 2, MAX_FAN_IN);
+}
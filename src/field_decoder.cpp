@@ -0,0 +1,95 @@
+//
+// Allocation-free, non-throwing decoding of numeric CSV fields.
+//
+
+#include <field_decoder.hpp>
+
+#include <charconv>
+#include <system_error>
+
+#if !defined(__cpp_lib_to_chars)
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace {
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    // Strips surrounding whitespace and a single leading '+', which std::from_chars rejects.
+    // Returns false if nothing is left.
+    bool trimField(std::string_view& field) {
+        while (!field.empty() && isSpace(field.front())) {
+            field.remove_prefix(1);
+        }
+        while (!field.empty() && isSpace(field.back())) {
+            field.remove_suffix(1);
+        }
+        return !field.empty();
+    }
+
+    void stripPlus(std::string_view& field) {
+        if (field.size() > 1 && field.front() == '+' && field[1] != '-' && field[1] != '+') {
+            field.remove_prefix(1);
+        }
+    }
+
+    DecodeStatus toStatus(std::errc ec, const char* parsed_end, const char* field_end) {
+        if (ec == std::errc::invalid_argument) {
+            return DecodeStatus::Invalid;
+        }
+        if (ec == std::errc::result_out_of_range) {
+            return DecodeStatus::OutOfRange;
+        }
+        return parsed_end == field_end ? DecodeStatus::Ok : DecodeStatus::Invalid;
+    }
+}
+
+DecodeStatus decodeLong(std::string_view field, long& out) {
+    if (!trimField(field)) {
+        return DecodeStatus::Empty;
+    }
+    stripPlus(field);
+    long value = 0;
+    const char* field_end = field.data() + field.size();
+    auto [parsed_end, ec] = std::from_chars(field.data(), field_end, value);
+    DecodeStatus status = toStatus(ec, parsed_end, field_end);
+    if (status == DecodeStatus::Ok) {
+        out = value;
+    }
+    return status;
+}
+
+DecodeStatus decodeDouble(std::string_view field, double& out) {
+    if (!trimField(field)) {
+        return DecodeStatus::Empty;
+    }
+    stripPlus(field);
+#if defined(__cpp_lib_to_chars)
+    double value = 0.0;
+    const char* field_end = field.data() + field.size();
+    auto [parsed_end, ec] = std::from_chars(field.data(), field_end, value, std::chars_format::general);
+    DecodeStatus status = toStatus(ec, parsed_end, field_end);
+#else
+    // Standard libraries without floating-point from_chars: strtod on a bounded copy.
+    char buffer[64];
+    if (field.size() >= sizeof(buffer)) {
+        return DecodeStatus::Invalid;
+    }
+    std::memcpy(buffer, field.data(), field.size());
+    buffer[field.size()] = '\0';
+    char* parsed_end = nullptr;
+    errno = 0;
+    double value = std::strtod(buffer, &parsed_end);
+    DecodeStatus status = parsed_end == buffer ? DecodeStatus::Invalid
+                        : errno == ERANGE ? DecodeStatus::OutOfRange
+                        : parsed_end == buffer + field.size() ? DecodeStatus::Ok
+                        : DecodeStatus::Invalid;
+#endif
+    if (status == DecodeStatus::Ok) {
+        out = value;
+    }
+    return status;
+}
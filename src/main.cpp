@@ -11,73 +11,72 @@
 #include <optional>
 #include <functional>
 #include <unordered_map>
+#include <thread>
+#include <cmath>
+#include <csignal>
+#include <filesystem>
+#include <tuple>
 
 
 #include <cli_parser.hpp>
 #include <dataset_loader.hpp>
+#include <city_table.hpp>
+#include <country_dictionary.hpp>
+#include <csv_parser.hpp>
+#include <csv_scan.hpp>
 #include <city.hpp>
 #include <sorter.hpp>
 #include <sorter_factory.hpp>
+#include <algorithms/std_sorter.hpp>
+#include <algorithms/merge_sorter.hpp>
+#include <algorithms/quick_sorter.hpp>
+#include <algorithms/heap_sorter.hpp>
+#include <algorithms/dary_heap_sorter.hpp>
+#include <algorithms/insertion_sorter.hpp>
+#include <algorithms/tim_sorter.hpp>
+#include <algorithms/parallel_merge_sorter.hpp>
+#include <algorithms/sample_sorter.hpp>
+#include <algorithms/auto_sorter.hpp>
+#include <perf_counters.hpp>
+#include <top_k.hpp>
+#include <external_sorter.hpp>
+#include <sort_key.hpp>
+#include <composite_key.hpp>
+#include <sorting_network.hpp>
+#include <sort_server.hpp>
+#include <permutation_cache.hpp>
 
 const std::string DEFAULT_CSV_PATH = "worldcities.csv"; // Default path to the dataset
-
-// Define a type alias for the function that generates a specific field comparator
-using FieldComparatorGenerator = std::function<Sorter::Comparator(bool)>;
-
-// Static map to hold the registry of key strings to their comparator generators
-static const std::unordered_map<std::string, FieldComparatorGenerator> comparator_registry = {
-    {"name", [](bool reverse_order) -> Sorter::Comparator {
-        return [reverse_order](const City& a, const City& b) {
-            return reverse_order ? (b.name < a.name) : (a.name < b.name);
-        };
-    }},
-    {"country", [](bool reverse_order) -> Sorter::Comparator {
-        return [reverse_order](const City& a, const City& b) {
-            return reverse_order ? (b.country < a.country) : (a.country < b.country);
-        };
-    }},
-    {"population", [](bool reverse_order) -> Sorter::Comparator {
-        return [reverse_order](const City& a, const City& b) {
-            return reverse_order ? (b.population < a.population) : (a.population < b.population);
-        };
-    }},
-    {"lat", [](bool reverse_order) -> Sorter::Comparator {
-        return [reverse_order](const City& a, const City& b) {
-            return reverse_order ? (b.lat < a.lat) : (a.lat < b.lat);
-        };
-    }},
-    {"lng", [](bool reverse_order) -> Sorter::Comparator {
-        return [reverse_order](const City& a, const City& b) {
-            return reverse_order ? (b.lng < a.lng) : (a.lng < b.lng);
-        };
-    }}
-};
+const std::string PERMUTATION_CACHE_PATH = DEFAULT_CSV_PATH + ".perm"; // --cache, next to the dataset
 
 Sorter::Comparator createComparator(const std::string& key, bool reverse_order) {
-    auto it = comparator_registry.find(key);
-    if (it != comparator_registry.end()) {
-        return it->second(reverse_order);
-    } else {
-        throw std::invalid_argument("Error: Unknown sort key specified for comparator: " + key);
-    }
+    return createKeyComparator(parseSortKey(key), reverse_order);
+}
+
+// Quotes a perf-report CSV field that contains commas (composite keys such as "country,-population").
+std::string csvField(const std::string& value) {
+    return value.find(',') == std::string::npos ? value : "\"" + value + "\"";
 }
 
 // --- Helper Function to Print Cities ---
-void printCities(const std::vector<City>& cities, const std::optional<int>& limit_n_opt) {
-    size_t limit = cities.size();
+// row_at(i) returns the City shown at position i, so the same printer serves a sorted
+// vector and an index-mode permutation over the unsorted dataset.
+template <typename RowAt>
+void printCityRows(size_t row_count, RowAt row_at, const std::optional<int>& limit_n_opt) {
+    size_t limit = row_count;
     if (limit_n_opt.has_value() && limit_n_opt.value() > 0) {
-        limit = std::min(cities.size(), static_cast<size_t>(limit_n_opt.value()));
+        limit = std::min(row_count, static_cast<size_t>(limit_n_opt.value()));
     } else if (limit_n_opt.has_value() && limit_n_opt.value() <= 0) {
         // If -n 0 or negative was somehow passed (though CLI parser should prevent <=0)
         return; // Print nothing
     }
 
 
-    if (limit == 0 && !cities.empty()) {
+    if (limit == 0 && row_count != 0) {
         if (limit_n_opt.has_value()) return; // If -n was specified as 0, print nothing
     }
 
-    std::cout << "\n--- Sorted Cities (First " << limit << " of " << cities.size() << " total rows) ---" << std::endl;
+    std::cout << "\n--- Sorted Cities (First " << limit << " of " << row_count << " total rows) ---" << std::endl;
     std::cout << std::left << std::setw(30) << "City Name"
               << std::setw(25) << "Country"
               << std::setw(15) << "Population"
@@ -86,23 +85,69 @@ void printCities(const std::vector<City>& cities, const std::optional<int>& limi
     std::cout << std::string(100, '-') << std::endl;
 
     for (size_t i = 0; i < limit; ++i) {
-        const auto& city = cities[i];
+        const City& city = row_at(i);
         std::cout << std::left << std::setw(30) << city.name.substr(0, 28)
                   << std::setw(25) << city.country.substr(0, 23)
                   << std::right << std::setw(14) << city.population << " "
                   << std::fixed << std::setprecision(6) << std::setw(14) << city.lat << " "
                   << std::fixed << std::setprecision(6) << std::setw(14) << city.lng << std::endl;
     }
-    if (cities.size() > limit && limit > 0) { // only print if some were shown
-        std::cout << "... and " << (cities.size() - limit) << " more rows not shown." << std::endl;
-    } else if (limit == 0 && !cities.empty() && limit_n_opt.has_value()) {
+    if (row_count > limit && limit > 0) { // only print if some were shown
+        std::cout << "... and " << (row_count - limit) << " more rows not shown." << std::endl;
+    } else if (limit == 0 && row_count != 0 && limit_n_opt.has_value()) {
         std::cout << "(Printing 0 rows as requested by -n " << limit_n_opt.value() << ")" << std::endl;
-    } else if (cities.empty()){
+    } else if (row_count == 0){
         std::cout << "(No cities to print)" << std::endl;
     }
     std::cout << std::string(100, '-') << std::endl;
 }
 
+void printCities(const std::vector<City>& cities, const std::optional<int>& limit_n_opt) {
+    printCityRows(cities.size(), [&cities](size_t i) -> const City& { return cities[i]; }, limit_n_opt);
+}
+
+// Index-mode overload: prints `cities` in the order given by `order` without materialising it.
+void printCities(const std::vector<City>& cities, const Sorter::Permutation& order, const std::optional<int>& limit_n_opt) {
+    printCityRows(order.size(), [&cities, &order](size_t i) -> const City& { return cities[order[i]]; }, limit_n_opt);
+}
+
+
+// -a auto: which sorter the last call ran, and the sample it was chosen from.
+void printAutoDecision(const Sorter& sorter) {
+    const auto* auto_sorter = dynamic_cast<const AutoSorter*>(&sorter);
+    if (auto_sorter != nullptr && !auto_sorter->lastDecision().algorithm.empty()) { // nothing ran on a cache hit
+        std::cout << "Auto selection: " << auto_sorter->lastDecision().describe() << std::endl;
+    }
+}
+
+// --cache: a cache over `cities` holding the orders saved by earlier runs, if any.
+std::unique_ptr<PermutationCache> openPermutationCache(const std::vector<City>& cities) {
+    auto cache = std::make_unique<PermutationCache>(cities);
+    try {
+        const size_t loaded = cache->load(PERMUTATION_CACHE_PATH);
+        if (loaded > 0) {
+            std::cout << "Info: Loaded " << loaded << " cached orders from '" << PERMUTATION_CACHE_PATH << "'." << std::endl;
+        }
+    } catch (const std::exception& e) {
+        // A bad cache file only costs a sort, so don't fail the run.
+        std::cerr << "Warning: Ignoring unreadable permutation cache: " << e.what() << std::endl;
+    }
+    return cache;
+}
+
+// Prints the hit/miss statistics and saves new or upgraded orders for the next run.
+void closePermutationCache(const PermutationCache& cache) {
+    std::cout << "Permutation cache: " << cache.describeStats() << "." << std::endl;
+    if (!cache.isModified()) {
+        return;
+    }
+    try {
+        cache.save(PERMUTATION_CACHE_PATH);
+        std::cout << "Info: Wrote permutation cache '" << PERMUTATION_CACHE_PATH << "'." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Could not write permutation cache: " << e.what() << std::endl;
+    }
+}
 
 void run_single_sort(const CliParser& cli_parser) {
     const std::string& algorithm_name = cli_parser.getAlgorithm();
@@ -118,6 +163,8 @@ void run_single_sort(const CliParser& cli_parser) {
 
     // 2. Load Data
     DatasetLoader loader(DEFAULT_CSV_PATH);
+    loader.setThreadCount(static_cast<unsigned int>(cli_parser.getThreadCount()));
+    loader.setSnapshotEnabled(cli_parser.isSnapshotEnabled());
     std::cout << "\nLoading cities from " << DEFAULT_CSV_PATH << "..." << std::endl;
     std::vector<City> all_cities = loader.loadAndParseCities();
     // loadAndParseCities should print the number of cities parsed.
@@ -128,30 +175,141 @@ void run_single_sort(const CliParser& cli_parser) {
 
     // 3. Create Sorter Instance
     std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algorithm_name);
+    sorter->setThreadCount(static_cast<unsigned int>(cli_parser.getThreadCount()));
+
+    // 4. Create Comparator (a single key is just a one-field composite)
+    CompositeKey keys = parseCompositeKey(sort_key);
+    Sorter::Comparator comparator_fn = createCompositeComparator(keys, reverse_order);
+
+    // --cache: orders of keys sorted before (in either direction) come from the cache; a miss
+    // sorts all rows ascending with <algo> and keeps the result. A stable <algo> asks for a
+    // stable order, so ties come out as they would from <algo> itself, descending included.
+    std::unique_ptr<PermutationCache> cache;
+    if (cli_parser.isCacheEnabled()) {
+        cache = openPermutationCache(all_cities);
+    }
+    const auto sort_ascending = [&](const CompositeKey& ascending_keys) {
+        return sorter->sortIndicesByKeys(all_cities, ascending_keys, false);
+    };
+
+    if (limit_rows_opt && static_cast<size_t>(limit_rows_opt.value()) < all_cities.size() && !cli_parser.isFullSortMode()) {
+        // Top-K: only the printed rows are put in order. Ties keep dataset order, so the rows
+        // match a stable full sort. --full-sort disables this to time <algo> on everything.
+        const auto k = static_cast<size_t>(limit_rows_opt.value());
+        std::cout << "\nSelecting the first " << k << " of " << all_cities.size() << " cities by " << sort_key
+                << (cache ? " (from the permutation cache; a miss sorts all rows with " + sorter->getName() + ")..."
+                          : " (partial sort; use --full-sort to run " + sorter->getName() + " on all rows)...")
+                << std::endl;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        // The cached order is stabilized like selectTopK(), so both give the same rows.
+        Sorter::Permutation order = cache ? cache->get(keys, reverse_order, true, sort_ascending, k)
+                                          : selectTopK(all_cities, keys, reverse_order, k);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        long long select_duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        std::cout << "Selection completed in " << select_duration_ms << " ms." << std::endl;
+        if (cache) {
+            printAutoDecision(*sorter);
+            closePermutationCache(*cache);
+        }
+
+        // The prefix must be sorted, and no row left out may come before its last entry.
+        std::cout << "Verifying selection correctness..." << std::endl;
+        std::vector<bool> selected(all_cities.size(), false);
+        for (std::uint32_t row : order) {
+            selected[row] = true;
+        }
+        bool is_correct_selection = order.size() == k && std::is_sorted(order.begin(), order.end(),
+            [&](std::uint32_t a, std::uint32_t b) { return comparator_fn(all_cities[a], all_cities[b]); });
+        for (size_t row = 0; is_correct_selection && row < all_cities.size(); ++row) {
+            is_correct_selection = selected[row] || !comparator_fn(all_cities[row], all_cities[order.back()]);
+        }
 
-    // 4. Create Comparator
-    Sorter::Comparator comparator_fn = createComparator(sort_key, reverse_order);
+        if (!is_correct_selection) {
+            std::cerr << "CRITICAL ERROR: The first " << k << " rows were NOT selected correctly!" << std::endl;
+            assert(is_correct_selection && "Assertion failed: Top-K selection is NOT correct!");
+        } else {
+            std::cout << "Selection verification successful." << std::endl;
+        }
 
-    // For a single run, we sort a copy of all_cities.
+        printCities(all_cities, order, limit_rows_opt);
+        return;
+    }
+
+    if (cli_parser.isIndexSortMode()) {
+        // Index mode: sort row indices against the loaded dataset, which is never copied or modified.
+        if (all_cities.empty()) {
+            std::cout << "\nNo data to sort." << std::endl;
+            return;
+        }
+        std::cout << "\nSorting " << all_cities.size() << " cities by index using " << sorter->getName()
+                << " by " << sort_key << "..." << std::endl;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        Sorter::Permutation order = cache ? cache->get(keys, reverse_order, sorter->isStable(), sort_ascending)
+                                          : sorter->sortIndicesByKeys(all_cities, keys, reverse_order);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        long long sort_duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        std::cout << "Sorting completed in " << sort_duration_ms << " ms." << std::endl;
+        printAutoDecision(*sorter);
+        if (cache) {
+            closePermutationCache(*cache);
+        }
+
+        std::cout << "Verifying sort correctness..." << std::endl;
+        bool is_correctly_sorted = order.size() == all_cities.size() && std::is_sorted(order.begin(), order.end(),
+            [&](std::uint32_t a, std::uint32_t b) { return comparator_fn(all_cities[a], all_cities[b]); });
+
+        if (!is_correctly_sorted) {
+            std::cerr << "CRITICAL ERROR: The data was NOT sorted correctly by " << sorter->getName() << "!" << std::endl;
+            assert(is_correctly_sorted && "Assertion failed: Data is NOT sorted correctly!");
+        } else {
+            std::cout << "Sort verification successful." << std::endl;
+        }
+
+        printCities(all_cities, order, limit_rows_opt);
+        return;
+    }
+
+    // For a single run, we sort a copy of all_cities. With the cache, the rows are instead
+    // moved out of all_cities in sorted order below, so no copy is made.
     // For performance tests, you would loop here for different sizes (1k, 10k, complete)
     // and ensure 'data_to_sort' is a fresh copy of the desired subset for each run.
-    std::vector<City> data_to_sort = all_cities; // Make a copy for sorting
+    std::vector<City> data_to_sort;
+    if (!cache) {
+        data_to_sort = all_cities; // Make a copy for sorting
+    }
 
-    if (data_to_sort.empty()) {
+    if (all_cities.empty()) {
         std::cout << "\nNo data to sort." << std::endl;
     } else {
-        std::cout << "\nSorting " << data_to_sort.size() << " cities using " << sorter->getName()
+        std::cout << "\nSorting " << all_cities.size() << " cities using " << sorter->getName()
                 << " by " << sort_key << "..." << std::endl;
 
         // 5. Perform Sorting and Timing
         auto start_time = std::chrono::high_resolution_clock::now();
-        sorter->sort(data_to_sort, comparator_fn);
+        if (cache) {
+            // all_cities is not read again, so the rows can be moved into their sorted places.
+            const Sorter::Permutation order = cache->get(keys, reverse_order, sorter->isStable(), sort_ascending);
+            data_to_sort.reserve(order.size());
+            for (std::uint32_t row : order) {
+                data_to_sort.push_back(std::move(all_cities[row]));
+            }
+        } else {
+            sorter->sortByKeys(data_to_sort, keys, reverse_order);
+        }
         auto end_time = std::chrono::high_resolution_clock::now();
 
         auto duration_chrono = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
         long long sort_duration_ms = duration_chrono.count();
 
         std::cout << "Sorting completed in " << sort_duration_ms << " ms." << std::endl;
+        printAutoDecision(*sorter);
+        if (cache) {
+            closePermutationCache(*cache);
+        }
 
         // 6. Correctness Guard
         std::cout << "Verifying sort correctness..." << std::endl;
@@ -173,14 +331,1028 @@ void run_single_sort(const CliParser& cli_parser) {
 }
 
 
+// --- External Sort Mode (--external) ---
+// Streams the CSV through an ExternalSorter: chunks within the memory budget are sorted
+// with the selected algorithm and spilled as runs, and the final merge feeds the printer
+// directly, so the full dataset is never held in memory. With -n the merge stops early.
+void run_external_sort(const CliParser& cli_parser) {
+    const std::string& algorithm_name = cli_parser.getAlgorithm();
+    const std::string& sort_key = cli_parser.getKey();
+    bool reverse_order = cli_parser.isReverseOrder();
+    std::optional<int> limit_rows_opt = cli_parser.getLimitRows();
+    const size_t memory_budget_bytes = static_cast<size_t>(cli_parser.getMemoryBudgetMiB()) << 20;
+
+    std::cout << "Selected Algorithm: " << algorithm_name << " (external merge sort, memory budget "
+              << cli_parser.getMemoryBudgetMiB() << " MiB)" << std::endl;
+    std::cout << "Selected Key: " << sort_key << (reverse_order ? " (Descending)" : " (Ascending)") << std::endl;
+    if (limit_rows_opt) {
+        std::cout << "Printing first " << limit_rows_opt.value() << " rows upon completion." << std::endl;
+    }
+
+    std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algorithm_name);
+    sorter->setThreadCount(static_cast<unsigned int>(cli_parser.getThreadCount()));
+    CompositeKey keys = parseCompositeKey(sort_key);
+    Sorter::Comparator comparator_fn = createCompositeComparator(keys, reverse_order);
+    ExternalSorter external_sorter(*sorter, keys, reverse_order, memory_budget_bytes);
+
+    DatasetLoader loader(DEFAULT_CSV_PATH, DatasetLoader::CsvBackend::Stream);
+    std::cout << "\nStreaming cities from " << DEFAULT_CSV_PATH << " in chunks of up to "
+              << external_sorter.getChunkRowCapacity() << " rows..." << std::endl;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    loader.streamCities([&external_sorter](City&& city) { external_sorter.add(std::move(city)); });
+    const ExternalSorter::Stats& stats = external_sorter.finish();
+    auto end_time = std::chrono::high_resolution_clock::now();
+    long long run_duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    if (stats.initial_runs == 0) {
+        std::cout << "All " << stats.rows << " cities fit in the budget and were sorted in memory in "
+                  << run_duration_ms << " ms." << std::endl;
+    } else {
+        std::cout << "Sorted " << stats.rows << " cities into " << stats.initial_runs << " runs in " << run_duration_ms
+                  << " ms (" << stats.merge_passes << " intermediate merge passes, fan-in " << stats.max_fan_in
+                  << ", " << stats.spilled_bytes << " bytes spilled)." << std::endl;
+    }
+    printAutoDecision(*sorter); // the last chunk's choice
+
+    // The printer pulls rows one at a time from the final merge; each is checked against the previous one.
+    City current;
+    City previous;
+    size_t merged_rows = 0;
+    bool is_correctly_sorted = true;
+    printCityRows(stats.rows, [&](size_t) -> const City& {
+        if (merged_rows > 0) {
+            std::swap(previous, current);
+        }
+        if (!external_sorter.next(current)) {
+            throw std::runtime_error("External Sort Error: The merge ended before all rows were returned.");
+        }
+        if (merged_rows > 0 && comparator_fn(current, previous)) {
+            is_correctly_sorted = false;
+        }
+        ++merged_rows;
+        return current;
+    }, limit_rows_opt);
+
+    if (!is_correctly_sorted) {
+        std::cerr << "CRITICAL ERROR: The merged output was NOT sorted correctly by " << sorter->getName() << "!" << std::endl;
+        assert(is_correctly_sorted && "Assertion failed: Merged output is NOT sorted correctly!");
+    } else {
+        std::cout << "Sort verification successful (" << merged_rows << " merged rows checked)." << std::endl;
+    }
+}
+
+
+// --- Sort Server (--serve, --client, --load-test) ---
+
+// The -k/-r/-n/-a of the command line as a server query; -a left out means the server's default.
+SortQuery queryFromCli(const CliParser& cli_parser) {
+    SortQuery query;
+    query.key = cli_parser.getKey();
+    query.reverse_order = cli_parser.isReverseOrder();
+    if (cli_parser.getLimitRows()) {
+        query.limit = static_cast<size_t>(cli_parser.getLimitRows().value());
+    }
+    if (!cli_parser.getAlgorithm().empty()) {
+        query.algorithm = cli_parser.getAlgorithm();
+    }
+    return query;
+}
+
+// Load test mix: top-10, top-100 and full orders over three single keys and a composite one.
+std::vector<SortQuery> loadTestQueries() {
+    std::vector<SortQuery> queries;
+    for (const std::string key : {"population", "name", "lat", "country,-population"}) {
+        SortQuery top_10;
+        top_10.key = key;
+        top_10.reverse_order = key == "population";
+        top_10.limit = 10;
+        SortQuery top_100 = top_10;
+        top_100.reverse_order = !top_10.reverse_order;
+        top_100.limit = 100;
+        SortQuery full;
+        full.key = key;
+        queries.insert(queries.end(), {top_10, top_100, full});
+    }
+    return queries;
+}
+
+void printLoadReport(const LoadReport& report) {
+    std::cout << "Answered " << report.requests << " queries (" << report.errors << " errors) in " << std::fixed
+              << std::setprecision(3) << report.seconds << " s: " << std::setprecision(1) << report.throughput
+              << " queries/s, latency p50 " << std::setprecision(3) << report.p50_ms << " ms, p99 " << report.p99_ms
+              << " ms, max " << report.max_ms << " ms." << std::endl;
+}
+
+// Ctrl-C / SIGTERM stop the running server cleanly (SortServer::stop() only sets an atomic and writes a byte).
+SortServer* running_server = nullptr;
+
+extern "C" void stopRunningServer(int) {
+    if (running_server != nullptr) {
+        running_server->stop();
+    }
+}
+
+// Loads the dataset once and answers queries until a client sends SHUTDOWN or the process is interrupted.
+void run_server(const CliParser& cli_parser) {
+    const auto query_threads = static_cast<unsigned int>(cli_parser.getThreadCount());
+    DatasetLoader loader(DEFAULT_CSV_PATH);
+    loader.setThreadCount(query_threads);
+    loader.setSnapshotEnabled(cli_parser.isSnapshotEnabled());
+    std::cout << "Loading cities from " << DEFAULT_CSV_PATH << "..." << std::endl;
+    const std::vector<City> all_cities = loader.loadAndParseCities();
+
+    SortServer server(all_cities, query_threads);
+    std::unique_ptr<PermutationCache> cache;
+    if (cli_parser.isCacheEnabled()) {
+        cache = openPermutationCache(all_cities);
+        server.setPermutationCache(cache.get());
+    }
+    server.listen(cli_parser.getSocketPath());
+    std::cout << "Serving " << all_cities.size() << " cities on " << cli_parser.getSocketPath() << " (up to "
+              << query_threads << " queries at once). Press Ctrl-C or send SHUTDOWN to stop." << std::endl;
+    running_server = &server;
+    std::signal(SIGINT, stopRunningServer);
+    std::signal(SIGTERM, stopRunningServer);
+    server.serve();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    running_server = nullptr;
+
+    const SortServer::Stats stats = server.getStats();
+    std::cout << "Server stopped after " << stats.connections << " connections, " << stats.queries << " queries and "
+              << stats.errors << " errors." << std::endl;
+    if (cache) {
+        closePermutationCache(*cache);
+    }
+}
+
+// One query to a running server; the reply is verified and printed like a local sort.
+void run_client(const CliParser& cli_parser) {
+    const SortQuery query = queryFromCli(cli_parser);
+    std::cout << "Query: " << formatSortQuery(query) << std::endl;
+
+    SortClient client(cli_parser.getSocketPath());
+    auto start_time = std::chrono::high_resolution_clock::now();
+    const SortReply reply = client.query(query);
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Server sorted " << reply.total_rows << " cities with " << reply.algorithm << " in "
+              << reply.server_us / 1000.0 << " ms (round trip "
+              << std::chrono::duration<double, std::milli>(end_time - start_time).count() << " ms)." << std::endl;
+
+    Sorter::Comparator comparator_fn = createCompositeComparator(parseCompositeKey(query.key), query.reverse_order);
+    if (!std::is_sorted(reply.rows.begin(), reply.rows.end(), comparator_fn)) {
+        std::cerr << "CRITICAL ERROR: The server's rows are NOT sorted by " << query.key << "!" << std::endl;
+    } else {
+        std::cout << "Sort verification successful." << std::endl;
+    }
+    printCities(reply.rows, cli_parser.getLimitRows());
+}
+
+// Bundled load generator: -j connections send --requests queries to a running server.
+void run_load_test(const CliParser& cli_parser) {
+    const std::vector<SortQuery> queries =
+        cli_parser.getKey().empty() ? loadTestQueries() : std::vector<SortQuery>{queryFromCli(cli_parser)};
+    const auto connections = static_cast<unsigned int>(cli_parser.getThreadCount());
+    const auto requests = static_cast<size_t>(cli_parser.getRequestCount());
+    std::cout << "Load test: " << requests << " queries (" << queries.size() << " distinct) over " << connections
+              << " connections to " << cli_parser.getSocketPath() << "..." << std::endl;
+    printLoadReport(runLoadGenerator(cli_parser.getSocketPath(), queries, connections, requests));
+}
+
+
+// --- Loader Benchmark (part of Performance Test Mode) ---
+// Times a full load of the dataset with each CSV backend. Each backend is run a few
+// times and the best time is kept, so page-cache warm-up doesn't skew the first one.
+void runLoaderBenchmark() {
+    struct LoaderVariant {
+        std::string name;
+        DatasetLoader::CsvBackend backend;
+        unsigned int threads;
+    };
+    const unsigned int hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::vector<LoaderVariant> variants = {
+        {"stream", DatasetLoader::CsvBackend::Stream, 1},
+        {"mmap", DatasetLoader::CsvBackend::Mmap, 1},
+        {"mmap-parallel-" + std::to_string(hardware_threads), DatasetLoader::CsvBackend::Mmap, hardware_threads}
+    };
+    const int repetitions = 3;
+
+    std::cout << "# Loader benchmark: Backend,Rows,BestTime(ms)" << std::endl;
+    for (const auto& [backend_name, backend, threads] : variants) {
+        long long best_ms = -1;
+        size_t rows = 0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            DatasetLoader loader(DEFAULT_CSV_PATH, backend);
+            loader.setThreadCount(threads);
+            auto start_time = std::chrono::high_resolution_clock::now();
+            std::vector<City> loaded = loader.loadAndParseCities();
+            auto end_time = std::chrono::high_resolution_clock::now();
+            long long elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            if (best_ms < 0 || elapsed_ms < best_ms) {
+                best_ms = elapsed_ms;
+            }
+            rows = loaded.size();
+        }
+        std::cout << "# Load," << backend_name << "," << rows << "," << best_ms << std::endl;
+    }
+
+    // Snapshot: the first load writes it (if missing or stale), later loads only map it.
+    {
+        DatasetLoader writer(DEFAULT_CSV_PATH);
+        writer.setSnapshotEnabled(true);
+        writer.loadAndParseCities();
+
+        long long best_ms = -1;
+        size_t rows = 0;
+        for (int rep = 0; rep < repetitions; ++rep) {
+            DatasetLoader loader(DEFAULT_CSV_PATH);
+            loader.setSnapshotEnabled(true);
+            auto start_time = std::chrono::high_resolution_clock::now();
+            std::vector<City> loaded = loader.loadAndParseCities();
+            auto end_time = std::chrono::high_resolution_clock::now();
+            long long elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+            if (best_ms < 0 || elapsed_ms < best_ms) {
+                best_ms = elapsed_ms;
+            }
+            rows = loaded.size();
+        }
+        std::cout << "# Load,snapshot," << rows << "," << best_ms << std::endl;
+    }
+}
+
+// --- CSV Scan Microbenchmark (part of Performance Test Mode) ---
+// Builds a large synthetic cities CSV in memory and measures the structural-character
+// scanner throughput (GB/s) for every kernel the CPU supports, then times a full
+// CsvReader pass over the real dataset with the Scalar and Simd line parsers.
+void runCsvScanBenchmark() {
+    const size_t target_bytes = 64u * 1024u * 1024u;
+    std::string synthetic;
+    synthetic.reserve(target_bytes + 256);
+    synthetic += "\"city\",\"city_ascii\",\"lat\",\"lng\",\"country\",\"iso2\",\"iso3\",\"admin_name\",\"capital\",\"population\",\"id\"\n";
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> name_length(4, 14);
+    std::uniform_real_distribution<double> coordinate(-180.0, 180.0);
+    std::uniform_int_distribution<long> population(100, 30000000);
+    for (long id = 1; synthetic.size() < target_bytes; ++id) {
+        std::string name(static_cast<size_t>(name_length(rng)), 'a');
+        for (char& c : name) {
+            c = static_cast<char>(letter(rng));
+        }
+        synthetic += "\"" + name + "\",\"" + name + "\",\"" + std::to_string(coordinate(rng) / 2) + "\",\""
+                   + std::to_string(coordinate(rng)) + "\",\"Country\",\"CC\",\"CCC\",\"Admin\",\"\",\""
+                   + std::to_string(population(rng)) + "\",\"" + std::to_string(id) + "\"\n";
+    }
+
+    const csv_scan::Kernel default_kernel = csv_scan::activeKernel();
+    std::cout << "# CSV scan benchmark: Kernel,Bytes,Structurals,Time(ms),GB/s" << std::endl;
+    std::vector<uint32_t> offsets;
+    offsets.reserve(synthetic.size() / 4);
+    for (csv_scan::Kernel kernel : {csv_scan::Kernel::Scalar, csv_scan::Kernel::Sse2, csv_scan::Kernel::Avx2}) {
+        if (!csv_scan::setKernel(kernel)) {
+            std::cout << "# Scan," << csv_scan::kernelName(kernel) << ",unsupported on this CPU" << std::endl;
+            continue;
+        }
+        double best_seconds = 0.0;
+        for (int rep = 0; rep < 5; ++rep) {
+            offsets.clear();
+            auto start_time = std::chrono::high_resolution_clock::now();
+            csv_scan::scanStructural(synthetic, ',', offsets);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            double seconds = std::chrono::duration<double>(end_time - start_time).count();
+            if (rep == 0 || seconds < best_seconds) {
+                best_seconds = seconds;
+            }
+        }
+        std::cout << "# Scan," << csv_scan::kernelName(kernel) << "," << synthetic.size() << "," << offsets.size()
+                  << "," << std::fixed << std::setprecision(2) << best_seconds * 1000.0 << ","
+                  << (static_cast<double>(synthetic.size()) / best_seconds / 1e9) << std::defaultfloat << std::endl;
+    }
+    csv_scan::setKernel(default_kernel);
+
+    std::cout << "# CsvReader benchmark: ParseBackend,Rows,Time(ms)" << std::endl;
+    for (const auto& [backend_name, backend] : {std::make_pair(std::string("scalar"), CsvReader::ParseBackend::Scalar),
+                                                std::make_pair(std::string("simd"), CsvReader::ParseBackend::Simd)}) {
+        CsvReader reader(DEFAULT_CSV_PATH, ',', backend);
+        CsvRow row;
+        size_t rows = 0;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        while (reader.readRow(row)) {
+            ++rows;
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << "# CsvReader," << backend_name << "," << rows << ","
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count() << std::endl;
+    }
+}
+
+// --- AoS vs SoA Layout Benchmark (part of Performance Test Mode) ---
+// Stable-sorts the full dataset by every key, once as std::vector<City> (AoS) and once
+// as a CityTable (SoA: sort the key column into a permutation, then gather each column).
+void runLayoutBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Layout benchmark: Key,Layout,Size,Time(ms)" << std::endl;
+    const CityTable table = CityTable::fromCities(all_cities);
+    for (const auto& key_name : CliParser::getValidKeys()) {
+        Sorter::Comparator comparator_asc = createComparator(key_name, false);
+
+        std::vector<City> aos = all_cities;
+        auto start_aos = std::chrono::high_resolution_clock::now();
+        std::stable_sort(aos.begin(), aos.end(), comparator_asc);
+        auto end_aos = std::chrono::high_resolution_clock::now();
+
+        CityTable soa = table;
+        auto start_soa = std::chrono::high_resolution_clock::now();
+        soa.sortBy(parseSortKey(key_name), false);
+        auto end_soa = std::chrono::high_resolution_clock::now();
+
+        std::cout << "# Layout," << key_name << ",aos," << aos.size() << ","
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end_aos - start_aos).count() / 1000.0 << std::endl;
+        std::cout << "# Layout," << key_name << ",soa," << soa.size() << ","
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end_soa - start_soa).count() / 1000.0 << std::endl;
+    }
+}
+
+// --- Country Dictionary Report (part of Performance Test Mode) ---
+// Compares the memory of the per-row std::string country column with CityTable's 16-bit
+// codes plus the dictionary, and times a stable country sort with string vs code
+// comparisons. The saving is CityTable's only: City keeps its string and carries the
+// code as well, which costs every City row the padding reported here.
+void runCountryDictionaryReport(const std::vector<City>& all_cities, const CountryDictionary& dictionary) {
+    const size_t small_string_capacity = std::string().capacity();
+    size_t string_column_bytes = all_cities.size() * sizeof(std::string);
+    for (const City& city : all_cities) {
+        if (city.country.capacity() > small_string_capacity) {
+            string_column_bytes += city.country.capacity() + 1;
+        }
+    }
+    const size_t coded_column_bytes = all_cities.size() * sizeof(CountryDictionary::Code) + dictionary.memoryBytes();
+
+    std::cout << "# Country dictionary: " << dictionary.size() << " distinct countries, "
+              << all_cities.size() << " rows" << std::endl;
+    std::cout << "# CityTable country column: " << coded_column_bytes << " bytes (codes+dictionary) vs "
+              << string_column_bytes << " for the City strings" << std::endl;
+    // The fields City had before country_code; the rest of sizeof(City) is the code and its padding.
+    const size_t city_without_code = 2 * sizeof(std::string) + 2 * sizeof(double) + sizeof(long);
+    const size_t code_bytes = sizeof(City) > city_without_code ? sizeof(City) - city_without_code : 0;
+    std::cout << "# City rows: sizeof(City)=" << sizeof(City) << " bytes; country_code grew each row by "
+              << code_bytes << " bytes (" << code_bytes * all_cities.size() << " in total)" << std::endl;
+
+    auto by_string = [](const City& a, const City& b) { return a.country < b.country; };
+    auto by_code = [](const City& a, const City& b) { return a.country_code < b.country_code; };
+
+    std::vector<City> string_sorted = all_cities;
+    auto start_string = std::chrono::high_resolution_clock::now();
+    std::stable_sort(string_sorted.begin(), string_sorted.end(), by_string);
+    auto end_string = std::chrono::high_resolution_clock::now();
+
+    std::vector<City> code_sorted = all_cities;
+    auto start_code = std::chrono::high_resolution_clock::now();
+    std::stable_sort(code_sorted.begin(), code_sorted.end(), by_code);
+    auto end_code = std::chrono::high_resolution_clock::now();
+
+    const double string_ms = std::chrono::duration<double, std::milli>(end_string - start_string).count();
+    const double code_ms = std::chrono::duration<double, std::milli>(end_code - start_code).count();
+    std::cout << "# Country sort: strings=" << string_ms << " ms, codes=" << code_ms << " ms, speedup="
+              << (code_ms > 0.0 ? string_ms / code_ms : 0.0) << "x" << std::endl;
+}
+
+// --- String Key Throughput (part of Performance Test Mode) ---
+// Index-sorts the full dataset by name and country with the comparison sorts and with
+// the multikey sorter, reporting rows per second next to the time.
+void runStringSortBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# String sort throughput: Key,Algorithm,Size,Time(ms),Mrows/s" << std::endl;
+    for (const std::string key_name : {"name", "country"}) {
+        SortKey key = parseSortKey(key_name);
+        for (const std::string algo_name : {"std", "merge", "multikey"}) {
+            std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+            auto start_time = std::chrono::high_resolution_clock::now();
+            Sorter::Permutation order = sorter->sortIndicesByKey(all_cities, key, false);
+            auto end_time = std::chrono::high_resolution_clock::now();
+
+            const double ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            std::cout << "# StringSort," << key_name << "," << algo_name << "," << order.size() << "," << ms << ","
+                      << (ms > 0.0 ? static_cast<double>(order.size()) / ms / 1000.0 : 0.0) << std::endl;
+        }
+    }
+}
+
+// --- Comparator Dispatch Benchmark (part of Performance Test Mode) ---
+// Sorts the same data through the std::function path (sort) and through the statically
+// dispatched key path (sortByKey) and reports the speedup per algorithm. The quadratic
+// sorters run on a 10k prefix to keep the report short.
+void runDispatchBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Comparator dispatch: Algorithm,Key,Size,std::function(ms),static(ms),speedup" << std::endl;
+    for (const std::string algo_name : {"bubble", "insertion", "merge", "quick", "heap", "std"}) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+        const bool quadratic = algo_name == "bubble" || algo_name == "insertion";
+        const size_t size = quadratic ? std::min<size_t>(10000, all_cities.size()) : all_cities.size();
+
+        for (const std::string key_name : {"name", "population", "lat"}) {
+            SortKey key = parseSortKey(key_name);
+
+            std::vector<City> dynamic_data(all_cities.begin(), all_cities.begin() + size);
+            auto start_dynamic = std::chrono::high_resolution_clock::now();
+            sorter->sort(dynamic_data, createKeyComparator(key, false));
+            auto end_dynamic = std::chrono::high_resolution_clock::now();
+
+            std::vector<City> static_data(all_cities.begin(), all_cities.begin() + size);
+            auto start_static = std::chrono::high_resolution_clock::now();
+            sorter->sortByKey(static_data, key, false);
+            auto end_static = std::chrono::high_resolution_clock::now();
+
+            const double dynamic_ms = std::chrono::duration<double, std::milli>(end_dynamic - start_dynamic).count();
+            const double static_ms = std::chrono::duration<double, std::milli>(end_static - start_static).count();
+            std::cout << "# Dispatch," << algo_name << "," << key_name << "," << size << "," << dynamic_ms << ","
+                      << static_ms << "," << (static_ms > 0.0 ? dynamic_ms / static_ms : 0.0) << "x" << std::endl;
+        }
+    }
+}
+
+// --- Input Pattern Benchmark (part of Performance Test Mode) ---
+// Sorts the full dataset by population when it is random, already sorted, reversed and
+// has only a few distinct values, the inputs that defeat naive quicksort pivots.
+void runInputPatternBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Input patterns: Algorithm,Pattern,Size,Time(ms)" << std::endl;
+
+    std::vector<City> sorted = all_cities;
+    StdSorter().sortByKey(sorted, SortKey::Population, false);
+    std::vector<City> reversed(sorted.rbegin(), sorted.rend());
+    std::vector<City> few_unique = all_cities;
+    for (City& city : few_unique) {
+        city.population %= 8;
+    }
+    const std::vector<std::pair<std::string, const std::vector<City>*>> patterns = {
+        {"random", &all_cities}, {"sorted", &sorted}, {"reversed", &reversed}, {"few-unique", &few_unique}};
+
+    for (const std::string algo_name : {"quick", "std", "merge", "heap"}) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+        for (const auto& [pattern_name, pattern] : patterns) {
+            std::vector<City> data = *pattern;
+            auto start_time = std::chrono::high_resolution_clock::now();
+            sorter->sortByKey(data, SortKey::Population, false);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::cout << "# Pattern," << algo_name << "," << pattern_name << "," << data.size() << ","
+                      << std::chrono::duration<double, std::milli>(end_time - start_time).count() << std::endl;
+        }
+    }
+}
+
+// --- Presortedness Benchmark (part of Performance Test Mode) ---
+// Sorts by population from inputs with a controlled amount of disorder: sorted, sorted
+// with 0.1% / 1% / 10% of the rows swapped at random, sorted with 1% random rows
+// appended, and random. Adaptive sorters (tim) should approach a linear scan on the
+// nearly sorted inputs while the others pay full price.
+void runPresortednessBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Presortedness: Algorithm,Pattern,Size,Time(ms)" << std::endl;
+
+    std::vector<City> sorted = all_cities;
+    StdSorter().sortByKey(sorted, SortKey::Population, false);
+    std::mt19937 rng(7);
+    auto with_swaps = [&](double fraction) {
+        std::vector<City> data = sorted;
+        std::uniform_int_distribution<size_t> row(0, data.size() - 1);
+        for (size_t i = 0; i < static_cast<size_t>(static_cast<double>(data.size()) * fraction); ++i) {
+            std::swap(data[row(rng)], data[row(rng)]);
+        }
+        return data;
+    };
+    // The first 99% of the dataset sorted, then the remaining rows in their original order.
+    const size_t sorted_prefix = all_cities.size() - all_cities.size() / 100;
+    std::vector<City> appended(all_cities.begin(), all_cities.begin() + static_cast<std::ptrdiff_t>(sorted_prefix));
+    StdSorter().sortByKey(appended, SortKey::Population, false);
+    appended.insert(appended.end(), all_cities.begin() + static_cast<std::ptrdiff_t>(sorted_prefix), all_cities.end());
+
+    const std::vector<std::pair<std::string, std::vector<City>>> patterns = {
+        {"sorted", sorted},
+        {"swaps-0.1%", with_swaps(0.001)},
+        {"swaps-1%", with_swaps(0.01)},
+        {"swaps-10%", with_swaps(0.1)},
+        {"appended-1%", appended},
+        {"random", all_cities}
+    };
+
+    for (const std::string algo_name : {"tim", "merge", "std", "quick"}) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+        for (const auto& [pattern_name, pattern] : patterns) {
+            std::vector<City> data = pattern;
+            auto start_time = std::chrono::high_resolution_clock::now();
+            sorter->sortByKey(data, SortKey::Population, false);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::cout << "# Presorted," << algo_name << "," << pattern_name << "," << data.size() << ","
+                      << std::chrono::duration<double, std::milli>(end_time - start_time).count() << std::endl;
+        }
+    }
+}
+
+// --- Block Partition Benchmark (part of Performance Test Mode) ---
+// Sorts the full dataset by each numeric key with the branchy Hoare partition and with
+// the block partition, in place and in index mode. Branch misses come from hardware
+// counters where the kernel allows it; otherwise only the times are printed.
+void runBlockPartitionBenchmark(const std::vector<City>& all_cities) {
+    PerfCounters counters;
+    std::cout << "# Block partition: Key,Partition,Mode,Size,Time(ms),Branches,BranchMisses"
+              << (counters.isAvailable() ? "" : " (hardware counters unavailable, timing only)") << std::endl;
+
+    auto report = [&](const std::string& key_name, const char* partition, const char* mode, size_t size,
+                      std::chrono::high_resolution_clock::duration elapsed, const PerfCounters::Sample& sample) {
+        std::cout << "# Partition," << key_name << "," << partition << "," << mode << "," << size << ","
+                  << std::chrono::duration<double, std::milli>(elapsed).count() << ","
+                  << sample.branches << "," << sample.branch_misses << std::endl;
+    };
+
+    auto bench = [&](const std::string& key_name, auto less) {
+        for (bool block : {false, true}) {
+            const char* partition = block ? "block" : "hoare";
+
+            std::vector<City> data = all_cities;
+            counters.start();
+            auto start_time = std::chrono::high_resolution_clock::now();
+            block ? QuickSorter::sortRangeWith<true>(data, less) : QuickSorter::sortRangeWith<false>(data, less);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            report(key_name, partition, "cities", data.size(), end_time - start_time, counters.stop());
+
+            // Index mode: 4-byte elements, where the partition kernel matters most.
+            Sorter::Permutation indices = Sorter::identityPermutation(all_cities.size());
+            auto index_less = [&all_cities, &less](std::uint32_t a, std::uint32_t b) {
+                return less(all_cities[a], all_cities[b]);
+            };
+            counters.start();
+            start_time = std::chrono::high_resolution_clock::now();
+            block ? QuickSorter::sortRangeWith<true>(indices, index_less) : QuickSorter::sortRangeWith<false>(indices, index_less);
+            end_time = std::chrono::high_resolution_clock::now();
+            report(key_name, partition, "index", indices.size(), end_time - start_time, counters.stop());
+        }
+    };
+
+    bench("population", KeyLess<SortKey::Population, false>{});
+    bench("lat", KeyLess<SortKey::Lat, false>{});
+    bench("lng", KeyLess<SortKey::Lng, false>{});
+}
+
+// --- Prefix Key Benchmark (part of Performance Test Mode) ---
+// Sorts by name, and by country with the dictionary codes cleared, once with the algorithm
+// run directly on the rows (KeyLess: a string compare through the heap per comparison) and
+// once through sortByKey(), which sorts (8-byte prefix, row index) records and only reads
+// the strings when two prefixes tie. Cache misses come from hardware counters where allowed.
+void runPrefixKeyBenchmark(const std::vector<City>& all_cities) {
+    PerfCounters counters;
+    std::cout << "# Prefix keys: Key,Algorithm,Mode,Size,Time(ms),CacheReferences,CacheMisses"
+              << (counters.isCacheAvailable() ? "" : " (cache counters unavailable, timing only)") << std::endl;
+
+    std::vector<City> uninterned = all_cities;
+    for (City& city : uninterned) {
+        city.country_code = CountryDictionary::UNASSIGNED;
+    }
+
+    auto measure = [&](const std::string& key_name, const std::string& algo_name, const char* mode, size_t size,
+                       const std::function<void()>& run) {
+        counters.start();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        run();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        const PerfCounters::Sample sample = counters.stop();
+        std::cout << "# Prefix," << key_name << "," << algo_name << "," << mode << "," << size << ","
+                  << std::chrono::duration<double, std::milli>(end_time - start_time).count() << ","
+                  << sample.cache_references << "," << sample.cache_misses << std::endl;
+    };
+
+    auto bench = [&](const std::string& key_name, const std::vector<City>& cities, SortKey key, auto less) {
+        auto index_less = [&cities, &less](std::uint32_t a, std::uint32_t b) { return less(cities[a], cities[b]); };
+        auto for_each_algorithm = [&](const std::string& algo_name, auto sort_range) {
+            std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+
+            std::vector<City> direct_data = cities;
+            measure(key_name, algo_name, "strings", cities.size(), [&] { sort_range(direct_data, less); });
+            std::vector<City> prefix_data = cities;
+            measure(key_name, algo_name, "prefix", cities.size(), [&] { sorter->sortByKey(prefix_data, key, false); });
+
+            Sorter::Permutation indices = Sorter::identityPermutation(cities.size());
+            measure(key_name, algo_name, "strings[index]", cities.size(), [&] { sort_range(indices, index_less); });
+            measure(key_name, algo_name, "prefix[index]", cities.size(), [&] { indices = sorter->sortIndicesByKey(cities, key, false); });
+        };
+        for_each_algorithm("std", [](auto& items, auto& compare) { StdSorter::sortRange(items, compare); });
+        for_each_algorithm("quick", [](auto& items, auto& compare) { QuickSorter::sortRange(items, compare); });
+        for_each_algorithm("merge", [](auto& items, auto& compare) { MergeSorter::sortRange(items, compare); });
+        for_each_algorithm("heap", [](auto& items, auto& compare) { HeapSorter::sortRange(items, compare); });
+        for_each_algorithm("tim", [](auto& items, auto& compare) { TimSorter::sortRange(items, compare); });
+    };
+
+    bench("name", all_cities, SortKey::Name, KeyLess<SortKey::Name, false>{});
+    bench("country", uninterned, SortKey::Country, KeyLess<SortKey::Country, false>{});
+}
+
+// --- Heap Arity Benchmark (part of Performance Test Mode) ---
+// The recursive binary heapsort (heap) against the bottom-up d-ary heapsort at arity 2, 4
+// (heap4) and 8, on Cities and in index mode, so the hole/bottom-up change and the arity
+// can be told apart.
+void runHeapArityBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Heap arity: Key,Variant,Mode,Size,Time(ms)" << std::endl;
+
+    auto bench = [&](const std::string& key_name, auto less) {
+        auto index_less = [&all_cities, &less](std::uint32_t a, std::uint32_t b) {
+            return less(all_cities[a], all_cities[b]);
+        };
+        auto measure = [&](const char* variant, auto sort_range) {
+            std::vector<City> data = all_cities;
+            auto start_time = std::chrono::high_resolution_clock::now();
+            sort_range(data, less);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::cout << "# HeapArity," << key_name << "," << variant << ",cities," << data.size() << ","
+                      << std::chrono::duration<double, std::milli>(end_time - start_time).count() << std::endl;
+
+            Sorter::Permutation indices = Sorter::identityPermutation(all_cities.size());
+            start_time = std::chrono::high_resolution_clock::now();
+            sort_range(indices, index_less);
+            end_time = std::chrono::high_resolution_clock::now();
+            std::cout << "# HeapArity," << key_name << "," << variant << ",index," << indices.size() << ","
+                      << std::chrono::duration<double, std::milli>(end_time - start_time).count() << std::endl;
+        };
+        measure("binary", [](auto& items, auto& compare) { HeapSorter::sortRange(items, compare); });
+        measure("floyd2", [](auto& items, auto& compare) { DaryHeapSorter::sortRangeWithArity<2>(items, compare); });
+        measure("floyd4", [](auto& items, auto& compare) { DaryHeapSorter::sortRangeWithArity<4>(items, compare); });
+        measure("floyd8", [](auto& items, auto& compare) { DaryHeapSorter::sortRangeWithArity<8>(items, compare); });
+    };
+
+    bench("population", KeyLess<SortKey::Population, false>{});
+    bench("name", KeyLess<SortKey::Name, false>{});
+}
+
+// --- Sorting Network Microbenchmark (part of Performance Test Mode) ---
+// Small blocks of packed (population key, row index) records, as the quick/merge/radix
+// base cases see them, sorted by insertion sort and by the scalar and AVX2 networks.
+// Every block size sorts the same number of records in total.
+void runSortingNetworkBenchmark(const std::vector<City>& all_cities) {
+    const bool avx2 = isSmallSortKernelAvailable(SmallSortKernel::Avx2Network);
+    std::cout << "# Sorting network (AVX2 " << (avx2 ? "available" : "not available")
+              << "): Variant,BlockSize,Blocks,Time(ms),ns/record" << std::endl;
+    if (all_cities.empty()) {
+        return;
+    }
+    const std::vector<PackedRow> rows =
+        packCompositeKeys(all_cities, CompositeKey{{SortKey::Population, false}}, false).rows;
+    const size_t total_records = std::size_t{1} << 20;
+
+    for (size_t block_size : {8, 16, 32, 64, 128}) {
+        std::vector<std::vector<PackedRow>> blocks(total_records / block_size);
+        size_t next_row = 0;
+        for (auto& block : blocks) {
+            block.resize(block_size);
+            for (PackedRow& row : block) {
+                row = rows[next_row];
+                next_row = (next_row + 1) % rows.size();
+            }
+        }
+
+        auto measure = [&](const char* variant, auto sort_block) {
+            std::vector<std::vector<PackedRow>> data = blocks;
+            auto start_time = std::chrono::high_resolution_clock::now();
+            for (auto& block : data) {
+                sort_block(block);
+            }
+            auto end_time = std::chrono::high_resolution_clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            std::cout << "# SortingNetwork," << variant << "," << block_size << "," << data.size() << "," << ms << ","
+                      << ms * 1e6 / static_cast<double>(total_records) << std::endl;
+        };
+        measure("insertion", [](std::vector<PackedRow>& block) {
+            PackedRowLess less;
+            InsertionSorter::sortRange(block, less);
+        });
+        measure("network-scalar", [](std::vector<PackedRow>& block) {
+            sortSmallPackedRowsWith(SmallSortKernel::ScalarNetwork, block.data(), block.size());
+        });
+        if (avx2) {
+            measure("network-avx2", [](std::vector<PackedRow>& block) {
+                sortSmallPackedRowsWith(SmallSortKernel::Avx2Network, block.data(), block.size());
+            });
+        }
+    }
+}
+
+// --- Parallel Sort Scaling (part of Performance Test Mode) ---
+// Sorts the full dataset with each parallel sorter at 1, 2, 4, 8 and N (hardware) threads
+// and reports the speedup over its single-threaded run.
+void runParallelSortBenchmark(const std::vector<City>& all_cities) {
+    std::vector<unsigned int> thread_counts = {1, 2, 4, 8};
+    const unsigned int hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (std::find(thread_counts.begin(), thread_counts.end(), hardware_threads) == thread_counts.end()) {
+        thread_counts.push_back(hardware_threads);
+    }
+
+    std::cout << "# Parallel sorts (" << hardware_threads << " hardware threads): Algorithm,Key,Threads,Size,Time(ms),Speedup"
+              << std::endl;
+    ParallelMergeSorter merge_sorter;
+    SampleSorter sample_sorter;
+    for (Sorter* sorter : {static_cast<Sorter*>(&merge_sorter), static_cast<Sorter*>(&sample_sorter)}) {
+        for (const std::string key_name : {"name", "population"}) {
+            SortKey key = parseSortKey(key_name);
+            double single_thread_ms = 0.0;
+            for (unsigned int threads : thread_counts) {
+                sorter->setThreadCount(threads);
+                std::vector<City> data = all_cities;
+                auto start_time = std::chrono::high_resolution_clock::now();
+                sorter->sortByKey(data, key, false);
+                auto end_time = std::chrono::high_resolution_clock::now();
+
+                const double ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+                if (threads == 1) {
+                    single_thread_ms = ms;
+                }
+                std::cout << "# Parallel," << sorter->getName() << "," << key_name << "," << threads << ","
+                          << data.size() << "," << ms << "," << (ms > 0.0 ? single_thread_ms / ms : 0.0) << "x"
+                          << std::endl;
+            }
+        }
+    }
+}
+
+// --- Top-K Selection (part of Performance Test Mode) ---
+// The -n path: selecting the first K rows with a bounded heap and with nth_element,
+// against a full index sort (std) of the whole dataset that prints the same rows.
+void runTopKBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Top-K selection: Key,K,Method,Size,Time(ms)" << std::endl;
+    const std::vector<std::pair<std::string, TopKStrategy>> strategies = {
+        {"heap", TopKStrategy::Heap},
+        {"nth_element", TopKStrategy::NthElement}
+    };
+    StdSorter full_sorter;
+    for (const std::string key_name : {"name", "population"}) {
+        SortKey key = parseSortKey(key_name);
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        Sorter::Permutation full_order = full_sorter.sortIndicesByKey(all_cities, key, false);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << "# TopK," << key_name << "," << full_order.size() << ",full-sort," << all_cities.size() << ","
+                  << std::chrono::duration<double, std::milli>(end_time - start_time).count() << std::endl;
+
+        for (size_t k : {10, 100, 1000}) {
+            for (const auto& [strategy_name, strategy] : strategies) {
+                start_time = std::chrono::high_resolution_clock::now();
+                Sorter::Permutation order = selectTopK(all_cities, key, false, k, strategy);
+                end_time = std::chrono::high_resolution_clock::now();
+                std::cout << "# TopK," << key_name << "," << k << "," << strategy_name << "," << all_cities.size()
+                          << "," << std::chrono::duration<double, std::milli>(end_time - start_time).count()
+                          << std::endl;
+            }
+        }
+    }
+}
+
+// --- External Sort (part of Performance Test Mode) ---
+// Full dataset through ExternalSorter (std for the chunks) at several memory budgets:
+// run generation plus the complete merge.
+void runExternalSortBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# External sort: BudgetMiB,Rows,Runs,MergePasses,SpilledBytes,Time(ms)" << std::endl;
+    StdSorter chunk_sorter;
+    for (size_t budget_mib : {1, 4, 64}) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        ExternalSorter external_sorter(chunk_sorter, SortKey::Population, false, budget_mib << 20);
+        for (const City& city : all_cities) {
+            external_sorter.add(city);
+        }
+        const ExternalSorter::Stats& stats = external_sorter.finish();
+        City city;
+        while (external_sorter.next(city)) {
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << "# External," << budget_mib << "," << stats.rows << "," << stats.initial_runs << ","
+                  << stats.merge_passes << "," << stats.spilled_bytes << ","
+                  << std::chrono::duration<double, std::milli>(end_time - start_time).count() << std::endl;
+    }
+}
+
+// --- Composite Key Benchmark (part of Performance Test Mode) ---
+// Multi-column orders ("largest cities per country") on the full dataset: one stable merge
+// sort per field, last field first, against a single sort() with the fused comparator and
+// sortByKeys(), which packs the leading fields into 64-bit keys where they fit.
+void runCompositeKeyBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Composite keys: Keys,PackedFields,Size,multi-pass merge(ms) / Keys,Algorithm,Size,fused(ms),sortByKeys(ms),speedup" << std::endl;
+    for (const std::string keys_name : {"country,-population", "country,-population,name", "-population,lat", "name,-population"}) {
+        const CompositeKey keys = parseCompositeKey(keys_name);
+
+        std::vector<City> multi_pass_data = all_cities;
+        auto start_multi_pass = std::chrono::high_resolution_clock::now();
+        for (auto field = keys.rbegin(); field != keys.rend(); ++field) {
+            MergeSorter().sortByKey(multi_pass_data, field->key, field->descending);
+        }
+        auto end_multi_pass = std::chrono::high_resolution_clock::now();
+        std::cout << "# CompositeMultiPass," << csvField(keys_name) << "," << packCompositeKeys(all_cities, keys, false).packed_fields
+                  << "," << all_cities.size() << ","
+                  << std::chrono::duration<double, std::milli>(end_multi_pass - start_multi_pass).count() << std::endl;
+
+        for (const std::string algo_name : {"std", "quick", "merge", "heap", "radix", "tim"}) {
+            std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+
+            std::vector<City> fused_data = all_cities;
+            auto start_fused = std::chrono::high_resolution_clock::now();
+            sorter->sort(fused_data, createCompositeComparator(keys, false));
+            auto end_fused = std::chrono::high_resolution_clock::now();
+
+            std::vector<City> keyed_data = all_cities;
+            auto start_keyed = std::chrono::high_resolution_clock::now();
+            sorter->sortByKeys(keyed_data, keys, false);
+            auto end_keyed = std::chrono::high_resolution_clock::now();
+
+            const double fused_ms = std::chrono::duration<double, std::milli>(end_fused - start_fused).count();
+            const double keyed_ms = std::chrono::duration<double, std::milli>(end_keyed - start_keyed).count();
+            std::cout << "# Composite," << csvField(keys_name) << "," << algo_name << "," << all_cities.size() << "," << fused_ms
+                      << "," << keyed_ms << "," << (keyed_ms > 0.0 ? fused_ms / keyed_ms : 0.0) << "x" << std::endl;
+        }
+    }
+}
+
+// --- Sort Server Benchmark (part of Performance Test Mode) ---
+// An in-process SortServer on a temporary socket, driven by the load generator with the
+// loadTestQueries() mix. A cold citysort run pays a full CSV load (timed here once) before
+// its sort; a server query pays the sort and the socket round trip only.
+void runSortServerBenchmark(const std::vector<City>& all_cities) {
+    auto load_start = std::chrono::high_resolution_clock::now();
+    const size_t loaded_rows = DatasetLoader(DEFAULT_CSV_PATH).loadAndParseCities().size();
+    auto load_end = std::chrono::high_resolution_clock::now();
+    std::cout << "# Sort server: cold CSV load of " << loaded_rows << " rows "
+              << std::chrono::duration<double, std::milli>(load_end - load_start).count() << " ms" << std::endl;
+    std::cout << "# Sort server: Connections,Requests,Errors,Throughput(q/s),p50(ms),p99(ms),max(ms)" << std::endl;
+
+    const std::string socket_path =
+        (std::filesystem::temp_directory_path() / ("citysort-bench-" + std::to_string(std::random_device{}()) + ".sock"))
+            .string();
+    try {
+        SortServer server(all_cities, std::max(1u, std::thread::hardware_concurrency()));
+        server.listen(socket_path);
+        std::thread server_thread([&server] { server.serve(); });
+        for (unsigned int connections : {1u, 4u}) {
+            const LoadReport report = runLoadGenerator(socket_path, loadTestQueries(), connections, 240);
+            std::cout << std::fixed << std::setprecision(3) << "# SortServer," << connections << "," << report.requests
+                      << "," << report.errors << "," << report.throughput << "," << report.p50_ms << "," << report.p99_ms << "," << report.max_ms
+                      << std::endl;
+        }
+        server.stop();
+        server_thread.join();
+    } catch (const std::exception& e) {
+        std::cout << "# Sort server benchmark skipped: " << e.what() << std::endl;
+    }
+}
+
+// --- Permutation Cache Benchmark (part of Performance Test Mode) ---
+// Repeated sorts through a PermutationCache (std on a miss), per key: the miss, an
+// ascending and a reversed hit, the first stable descending hit (which stabilizes the
+// entry) and a later one, and a top-10 hit against selectTopK(). Then the time to
+// save all entries to a file and load them back.
+void runPermutationCacheBenchmark(const std::vector<City>& all_cities) {
+    std::cout << "# Permutation cache: Key,Size,miss(ms),hit(ms),reversed hit(ms),first stable reversed(ms),stable reversed(ms),top-10 hit(ms),selectTopK(ms)" << std::endl;
+    const auto elapsed_ms = [](auto&& run) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        run();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    };
+
+    PermutationCache cache(all_cities);
+    StdSorter sorter;
+    const auto sort_ascending = [&](const CompositeKey& keys) { return sorter.sortIndicesByKeys(all_cities, keys, false); };
+    for (const std::string keys_name : {"population", "name", "country,-population"}) {
+        const CompositeKey keys = parseCompositeKey(keys_name);
+        std::cout << "# PermutationCache," << csvField(keys_name) << "," << all_cities.size();
+        for (const auto& [reverse, stable, limit] : {std::tuple<bool, bool, size_t>{false, false, SIZE_MAX},
+                                                     {false, false, SIZE_MAX},
+                                                     {true, false, SIZE_MAX},
+                                                     {true, true, SIZE_MAX},
+                                                     {true, true, SIZE_MAX},
+                                                     {true, true, 10}}) {
+            std::cout << "," << elapsed_ms([&] { cache.get(keys, reverse, stable, sort_ascending, limit); });
+        }
+        std::cout << "," << elapsed_ms([&] { selectTopK(all_cities, keys, true, 10); }) << std::endl;
+    }
+    std::cout << "# Permutation cache: " << cache.describeStats() << std::endl;
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / ("citysort-bench-" + std::to_string(std::random_device{}()) + ".perm"))
+            .string();
+    try {
+        const double save_ms = elapsed_ms([&] { cache.save(path); });
+        const auto file_bytes = std::filesystem::file_size(path);
+        PermutationCache reloaded(all_cities);
+        const double load_ms = elapsed_ms([&] { reloaded.load(path); });
+        std::cout << "# PermutationCacheFile,Entries,Bytes,save(ms),load(ms)," << cache.getStats().entries << ","
+                  << file_bytes << "," << save_ms << "," << load_ms << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "# Permutation cache file benchmark skipped: " << e.what() << std::endl;
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
 // --- Performance Test Mode ---
+// --- Auto Selection Check (part of Performance Test Mode) ---
+// Times -a auto (sampling included) against every fixed sorter on random, sorted,
+// reversed and few-unique inputs, per key and mode, best of three runs each. bubble
+// and insertion are left out: they take minutes on random input and are never the
+// best choice. A case is flagged SLOW when auto is more than AUTO_SLOWDOWN_LIMIT
+// times the best fixed sorter and over a millisecond behind it.
+void runAutoSelectionBenchmark(const std::vector<City>& all_cities) {
+    constexpr double AUTO_SLOWDOWN_LIMIT = 1.5;
+    std::cout << "# Auto selection: Key,Pattern,Mode,Choice,Auto(ms),BestFixed,Best(ms),Ratio" << std::endl;
+
+    std::vector<std::string> fixed_algorithms;
+    for (const std::string& name : CliParser::getValidAlgorithms()) {
+        if (name != "auto" && name != "bubble" && name != "insertion") {
+            fixed_algorithms.push_back(name);
+        }
+    }
+    std::vector<City> few_unique = all_cities;
+    for (City& city : few_unique) {
+        city.population %= 8;
+        city.lat = std::floor(city.lat / 45.0);
+        city.name = city.name.substr(0, 1);
+    }
+
+    auto best_of_three = [](auto run) {
+        double best = 0.0;
+        for (int repeat = 0; repeat < 3; ++repeat) {
+            auto start_time = std::chrono::high_resolution_clock::now();
+            run();
+            auto end_time = std::chrono::high_resolution_clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            best = repeat == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    };
+
+    double worst_ratio = 0.0;
+    std::string worst_case;
+    size_t slow_cases = 0;
+    size_t cases = 0;
+    for (const std::string key_name : {"population", "lat", "name", "country", "country,-population"}) {
+        const CompositeKey keys = parseCompositeKey(key_name);
+        std::vector<City> sorted = all_cities;
+        StdSorter().sortByKeys(sorted, keys, false);
+        const std::vector<City> reversed(sorted.rbegin(), sorted.rend());
+        const std::vector<std::pair<std::string, const std::vector<City>*>> patterns = {
+            {"random", &all_cities}, {"sorted", &sorted}, {"reversed", &reversed}, {"few-unique", &few_unique}};
+
+        for (const auto& [pattern_name, pattern] : patterns) {
+            for (const bool index_mode : {false, true}) {
+                auto time_sorter = [&](Sorter& sorter) {
+                    return best_of_three([&]() {
+                        if (index_mode) {
+                            Sorter::Permutation order = sorter.sortIndicesByKeys(*pattern, keys, false);
+                        } else {
+                            std::vector<City> data = *pattern;
+                            sorter.sortByKeys(data, keys, false);
+                        }
+                    });
+                };
+                std::string best_name;
+                double best_ms = 0.0;
+                for (const std::string& name : fixed_algorithms) {
+                    std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(name);
+                    const double ms = time_sorter(*sorter);
+                    if (best_name.empty() || ms < best_ms) {
+                        best_name = name;
+                        best_ms = ms;
+                    }
+                }
+                AutoSorter auto_sorter;
+                const double auto_ms = time_sorter(auto_sorter);
+                const double ratio = best_ms > 0.0 ? auto_ms / best_ms : 1.0;
+                const bool slow = ratio > AUTO_SLOWDOWN_LIMIT && auto_ms - best_ms > 1.0;
+                const std::string label =
+                    csvField(key_name) + "," + pattern_name + "," + (index_mode ? "index" : "cities");
+                std::cout << "# AutoSelect," << label << "," << auto_sorter.lastDecision().algorithm << "," << auto_ms
+                          << "," << best_name << "," << best_ms << "," << ratio << (slow ? ",SLOW" : "") << std::endl;
+
+                ++cases;
+                slow_cases += slow;
+                if (ratio > worst_ratio) {
+                    worst_ratio = ratio;
+                    worst_case = label;
+                }
+            }
+        }
+    }
+    std::cout << "# Auto selection: " << slow_cases << " of " << cases << " cases slower than " << AUTO_SLOWDOWN_LIMIT
+              << "x the best fixed sorter; worst ratio " << worst_ratio << " (" << worst_case << ")" << std::endl;
+}
+
 void runPerformanceTests() {
     std::cout << "Starting Performance Test Mode..." << std::endl;
+
+    try {
+        runLoaderBenchmark();
+        runCsvScanBenchmark();
+    } catch (const std::exception& e) {
+        std::cerr << "Performance Test Error during loader benchmark: " << e.what() << std::endl;
+        return;
+    }
+
     std::cout << "Algorithm,Key,Size,Time(ms)" << std::endl; // CSV Header for output
 
     // Define algorithms, keys, and sizes to test
-    const std::vector<std::string> algorithms_to_test = {"bubble", "insertion", "merge", "quick", "heap", "std"};
-    const std::vector<std::string> keys_to_test = {"name", "population", "lat"}; // As per Req 6 "three keys"
+    const std::vector<std::string> algorithms_to_test = {"bubble", "insertion", "merge", "quick", "heap", "std", "radix", "multikey", "blockquick", "pmerge", "samplesort", "tim", "heap4", "auto"};
+    const std::vector<std::string> keys_to_test = {"name", "population", "lat", // As per Req 6 "three keys"
+                                                   "country,-population"};     // plus one composite key
     const std::vector<size_t> sizes_to_test = {1000, 10000}; // 1k, 10k
     // "complete" will be handled separately or as the largest size if data is smaller
 
@@ -205,6 +1377,24 @@ void runPerformanceTests() {
     std::shuffle(all_cities.begin(), all_cities.end(), g);
     std::cout << "# Full dataset shuffled for subsetting." << std::endl;
 
+    runCountryDictionaryReport(all_cities, loader.getCountryDictionary());
+    runLayoutBenchmark(all_cities);
+    runStringSortBenchmark(all_cities);
+    runDispatchBenchmark(all_cities);
+    runInputPatternBenchmark(all_cities);
+    runPresortednessBenchmark(all_cities);
+    runBlockPartitionBenchmark(all_cities);
+    runPrefixKeyBenchmark(all_cities);
+    runHeapArityBenchmark(all_cities);
+    runSortingNetworkBenchmark(all_cities);
+    runParallelSortBenchmark(all_cities);
+    runTopKBenchmark(all_cities);
+    runExternalSortBenchmark(all_cities);
+    runCompositeKeyBenchmark(all_cities);
+    runAutoSelectionBenchmark(all_cities);
+    runSortServerBenchmark(all_cities);
+    runPermutationCacheBenchmark(all_cities);
+
 
     for (const auto& algo_name : algorithms_to_test) {
         std::unique_ptr<Sorter> sorter;
@@ -216,7 +1406,8 @@ void runPerformanceTests() {
         }
 
         for (const auto& key_name : keys_to_test) {
-            Sorter::Comparator comparator_asc = createComparator(key_name, false); // Test ascending
+            CompositeKey keys = parseCompositeKey(key_name);
+            Sorter::Comparator comparator_asc = createCompositeComparator(keys, false); // Test ascending
             // Sorter::Comparator comparator_desc = createComparator(key_name, true); // Optionally test descending too
 
             // Test with defined sizes (1k, 10k)
@@ -229,13 +1420,20 @@ void runPerformanceTests() {
 
                 std::vector<City> data_subset(all_cities.begin(), all_cities.begin() + current_size);
 
+                // Index mode first, while data_subset is still unsorted: only row indices move.
+                auto index_start = std::chrono::high_resolution_clock::now();
+                Sorter::Permutation subset_order = sorter->sortIndicesByKeys(data_subset, keys, false);
+                auto index_end = std::chrono::high_resolution_clock::now();
+                auto index_ms = std::chrono::duration_cast<std::chrono::milliseconds>(index_end - index_start).count();
+
                 auto start_time = std::chrono::high_resolution_clock::now();
-                sorter->sort(data_subset, comparator_asc);
+                sorter->sortByKeys(data_subset, keys, false);
                 auto end_time = std::chrono::high_resolution_clock::now();
                 auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
 
                 // Output in CSV format
-                std::cout << algo_name << "," << key_name << "," << current_size << "," << duration_ms << std::endl;
+                std::cout << algo_name << "," << csvField(key_name) << "," << current_size << "," << duration_ms << std::endl;
+                std::cout << algo_name << "[index]," << csvField(key_name) << "," << subset_order.size() << "," << index_ms << std::endl;
 
                 // Correctness check (optional here, but good for sanity during development)
                 // assert(std::is_sorted(data_subset.begin(), data_subset.end(), comparator_asc));
@@ -244,11 +1442,18 @@ void runPerformanceTests() {
             // Test with "complete" dataset
             std::vector<City> data_complete = all_cities; // Fresh copy
             auto start_time_complete = std::chrono::high_resolution_clock::now();
-            sorter->sort(data_complete, comparator_asc);
+            sorter->sortByKeys(data_complete, keys, false);
             auto end_time_complete = std::chrono::high_resolution_clock::now();
             auto duration_ms_complete = std::chrono::duration_cast<std::chrono::milliseconds>(end_time_complete - start_time_complete).count();
 
-            std::cout << algo_name << "," << key_name << "," << all_cities.size() << "," << duration_ms_complete << std::endl;
+            std::cout << algo_name << "," << csvField(key_name) << "," << all_cities.size() << "," << duration_ms_complete << std::endl;
+
+            // "complete" in index mode sorts against all_cities directly, no copy needed.
+            auto index_start_complete = std::chrono::high_resolution_clock::now();
+            Sorter::Permutation complete_order = sorter->sortIndicesByKeys(all_cities, keys, false);
+            auto index_end_complete = std::chrono::high_resolution_clock::now();
+            std::cout << algo_name << "[index]," << csvField(key_name) << "," << complete_order.size() << ","
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(index_end_complete - index_start_complete).count() << std::endl;
             // assert(std::is_sorted(data_complete.begin(), data_complete.end(), comparator_asc));
         }
     }
@@ -265,6 +1470,14 @@ int main(int argc, char* argv[]) {
 
         if (cli_parser.isPerformanceTestMode()) {
             runPerformanceTests(); // New function to handle all performance tests
+        } else if (cli_parser.isServeMode()) {
+            run_server(cli_parser);
+        } else if (cli_parser.isClientMode()) {
+            run_client(cli_parser);
+        } else if (cli_parser.isLoadTestMode()) {
+            run_load_test(cli_parser);
+        } else if (cli_parser.isExternalSortMode()) {
+            run_external_sort(cli_parser);
         } else {
             run_single_sort(cli_parser);
         }
@@ -0,0 +1,146 @@
+//
+// Read-only memory mapping of a whole file, shared by the zero-copy readers.
+//
+
+#include <mapped_file.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("MappedFile Error: Could not open file: " + filename);
+    }
+    this->file_handle_ = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        this->release();
+        throw std::runtime_error("MappedFile Error: Could not determine size of file: " + filename);
+    }
+    this->size_ = static_cast<size_t>(file_size.QuadPart);
+    if (this->size_ == 0) {
+        return; // Nothing to map
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        this->release();
+        throw std::runtime_error("MappedFile Error: Could not map file: " + filename);
+    }
+    this->mapping_handle_ = mapping;
+
+    void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (address == nullptr) {
+        this->release();
+        throw std::runtime_error("MappedFile Error: Could not map file: " + filename);
+    }
+    this->data_ = static_cast<const char*>(address);
+}
+
+void MappedFile::release() noexcept {
+    if (this->data_ != nullptr) {
+        UnmapViewOfFile(this->data_);
+    }
+    if (this->mapping_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(this->mapping_handle_));
+    }
+    if (this->file_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(this->file_handle_));
+    }
+    this->data_ = nullptr;
+    this->size_ = 0;
+    this->mapping_handle_ = nullptr;
+    this->file_handle_ = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      file_handle_(std::exchange(other.file_handle_, nullptr)),
+      mapping_handle_(std::exchange(other.mapping_handle_, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        this->release();
+        this->data_ = std::exchange(other.data_, nullptr);
+        this->size_ = std::exchange(other.size_, 0);
+        this->file_handle_ = std::exchange(other.file_handle_, nullptr);
+        this->mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MappedFile Error: Could not open file: " + filename);
+    }
+
+    struct stat file_info {};
+    if (::fstat(fd, &file_info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedFile Error: Could not determine size of file: " + filename);
+    }
+    this->size_ = static_cast<size_t>(file_info.st_size);
+    if (this->size_ == 0) {
+        ::close(fd);
+        return; // mmap() rejects zero-length mappings
+    }
+
+    void* address = ::mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (address == MAP_FAILED) {
+        this->size_ = 0;
+        throw std::runtime_error("MappedFile Error: Could not map file: " + filename);
+    }
+#ifdef MADV_SEQUENTIAL
+    ::madvise(address, this->size_, MADV_SEQUENTIAL);
+#endif
+    this->data_ = static_cast<const char*>(address);
+}
+
+void MappedFile::release() noexcept {
+    if (this->data_ != nullptr) {
+        ::munmap(const_cast<char*>(this->data_), this->size_);
+    }
+    this->data_ = nullptr;
+    this->size_ = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        this->release();
+        this->data_ = std::exchange(other.data_, nullptr);
+        this->size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    this->release();
+}
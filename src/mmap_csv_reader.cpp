@@ -0,0 +1,221 @@
+//
+// Zero-copy CSV reader over a memory-mapped file, to be used by other classes
+//
+
+#include <mmap_csv_reader.hpp>
+#include <csv_scan.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <utility>
+
+// MappedFile throws std::runtime_error if the file can't be opened or mapped.
+MmapCsvReader::MmapCsvReader(std::string filename, char delimiter)
+    : filename_(std::move(filename)), file_(this->filename_), parser_(this->file_.view(), delimiter) {}
+
+bool MmapCsvReader::isOpen() const {
+    return this->parser_.isOpen();
+}
+
+bool MmapCsvReader::readRow(CsvRowView& row) {
+    return this->parser_.readRow(row);
+}
+
+size_t MmapCsvReader::size() const {
+    return this->file_.size();
+}
+
+CsvViewReader::CsvViewReader(std::string_view data, char delimiter)
+    : data_(data), delimiter_(delimiter) {}
+
+bool CsvViewReader::isOpen() const {
+    return this->isOpen_;
+}
+
+size_t CsvViewReader::position() const {
+    return this->position_;
+}
+
+// True if p sits on a record terminator ("\n" or "\r\n") or at the end of input.
+bool CsvViewReader::isRecordEnd(const char* p, const char* end) const {
+    return p == end || *p == '\n' || (*p == '\r' && (p + 1 == end || p[1] == '\n'));
+}
+
+bool CsvViewReader::readRow(CsvRowView& row) {
+    row.clear();
+
+    if (!this->isOpen_) {
+        return false;
+    }
+
+    const char* const begin = this->data_.data();
+    const char* const end = begin + this->data_.size();
+    const char* cursor = begin + this->position_;
+
+    // Nothing left, or only a trailing newline: no more records.
+    if (cursor == end) {
+        this->isOpen_ = false;
+        return false;
+    }
+
+    this->scratch_.clear();
+    this->scratch_fields_.clear();
+
+    while (true) {
+        if (cursor != end && *cursor == '"') {
+            row.push_back(this->parseQuotedField(cursor + 1, end, cursor, row.size()));
+        } else {
+            const char* field_start = cursor;
+            // A quote in the middle of an unquoted field is literal, so skip past it.
+            cursor = csv_scan::findStructural(cursor, end, this->delimiter_);
+            while (cursor != end && *cursor == '"') {
+                cursor = csv_scan::findStructural(cursor + 1, end, this->delimiter_);
+            }
+            const char* field_end = cursor;
+            // Drop the '\r' of a CRLF terminator
+            if (field_end != field_start && field_end[-1] == '\r' && (cursor == end || *cursor == '\n')) {
+                --field_end;
+            }
+            row.emplace_back(field_start, static_cast<size_t>(field_end - field_start));
+        }
+
+        if (cursor == end) {
+            break;
+        }
+        if (*cursor == this->delimiter_) {
+            ++cursor;
+            continue;
+        }
+        // Record terminator
+        if (*cursor == '\r') {
+            ++cursor;
+        }
+        if (cursor != end && *cursor == '\n') {
+            ++cursor;
+        }
+        break;
+    }
+
+    for (const ScratchField& field : this->scratch_fields_) {
+        row[field.field] = std::string_view(this->scratch_.data() + field.offset, field.length);
+    }
+
+    this->position_ = static_cast<size_t>(cursor - begin);
+    if (cursor == end) {
+        this->isOpen_ = false;
+    }
+    return true;
+}
+
+// Parses a quoted field whose content starts at `content`. On return `cursor` points at
+// the delimiter or record terminator that ends the field (or at end of input). A field
+// with escapes is unescaped into scratch_ and recorded as field `field` of the row; its
+// returned view is a placeholder that readRow() replaces.
+std::string_view CsvViewReader::parseQuotedField(const char* content, const char* end, const char*& cursor, size_t field) {
+    const char* p = content;
+    while (true) {
+        const char* quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(end - p)));
+        if (quote == nullptr) {
+            // Unterminated quoted field: take everything up to the end of input.
+            cursor = end;
+            return {content, static_cast<size_t>(end - content)};
+        }
+        if (quote + 1 != end && quote[1] == '"') {
+            break; // Escaped quote: switch to the unescaping slow path below.
+        }
+        if (quote + 1 == end || quote[1] == this->delimiter_ || this->isRecordEnd(quote + 1, end)) {
+            cursor = quote + 1;
+            return {content, static_cast<size_t>(quote - content)};
+        }
+        p = quote + 1; // Stray quote inside a quoted field is kept literally
+    }
+
+    // Slow path: the field contains "" escapes, so build the unescaped value in scratch_.
+    const size_t field_offset = this->scratch_.size();
+    p = content;
+    while (p != end) {
+        char c = *p;
+        if (c == '"') {
+            if (p + 1 != end && p[1] == '"') {
+                this->scratch_.push_back('"');
+                p += 2;
+                continue;
+            }
+            if (p + 1 == end || p[1] == this->delimiter_ || this->isRecordEnd(p + 1, end)) {
+                ++p;
+                break;
+            }
+        }
+        this->scratch_.push_back(c);
+        ++p;
+    }
+    cursor = p;
+
+    this->scratch_fields_.push_back({field, field_offset, this->scratch_.size() - field_offset});
+    return {};
+}
+
+std::vector<size_t> splitAtRecordBoundaries(std::string_view data, size_t parts) {
+    if (parts == 0) {
+        parts = 1;
+    }
+    const size_t size = data.size();
+    std::vector<size_t> offsets(parts + 1, size);
+    offsets[0] = 0;
+    if (parts == 1 || size == 0) {
+        return offsets;
+    }
+
+    // 1. Raw equal-sized chunks; count the quotes of each chunk in parallel.
+    std::vector<size_t> raw_cuts(parts + 1);
+    for (size_t i = 0; i <= parts; ++i) {
+        raw_cuts[i] = size / parts * i + std::min(i, size % parts);
+    }
+    std::vector<size_t> quote_counts(parts, 0);
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(parts - 1);
+        auto count_quotes = [&](size_t chunk) {
+            size_t count = 0;
+            for (size_t p = raw_cuts[chunk]; p < raw_cuts[chunk + 1]; ++p) {
+                count += (data[p] == '"');
+            }
+            quote_counts[chunk] = count;
+        };
+        for (size_t chunk = 1; chunk < parts; ++chunk) {
+            workers.emplace_back(count_quotes, chunk);
+        }
+        count_quotes(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // 2. Walk each cut forward to the first newline that is outside quotes. The quote
+    //    parity at a raw cut is the parity of all quotes before it.
+    size_t quotes_before = 0;
+    for (size_t i = 1; i < parts; ++i) {
+        quotes_before += quote_counts[i - 1];
+        bool in_quotes = (quotes_before % 2) != 0;
+        size_t p = std::max(raw_cuts[i], offsets[i - 1]);
+        if (p != raw_cuts[i]) {
+            // The previous split already ran past this raw cut; recount parity from it.
+            in_quotes = false;
+        } else if (!in_quotes && p > 0 && data[p - 1] == '\n') {
+            offsets[i] = p; // Raw cut already sits at the start of a record
+            continue;
+        }
+        while (p < size) {
+            char c = data[p++];
+            if (c == '"') {
+                in_quotes = !in_quotes;
+            } else if (c == '\n' && !in_quotes) {
+                break;
+            }
+        }
+        offsets[i] = p;
+    }
+    return offsets;
+}
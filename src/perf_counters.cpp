@@ -0,0 +1,117 @@
+//
+// Hardware branch and cache counters around a code region (Linux perf_event_open).
+//
+
+#include <perf_counters.hpp>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace {
+
+int openCounter(std::uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0; // the group leader starts disabled
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+std::uint64_t readCounter(int fd) {
+    std::uint64_t value = 0;
+    if (read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+        return 0;
+    }
+    return value;
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    this->branches_fd_ = openCounter(PERF_COUNT_HW_BRANCH_INSTRUCTIONS, -1);
+    if (this->branches_fd_ != -1) {
+        this->misses_fd_ = openCounter(PERF_COUNT_HW_BRANCH_MISSES, this->branches_fd_);
+        if (this->misses_fd_ == -1) {
+            close(this->branches_fd_);
+            this->branches_fd_ = -1;
+        }
+    }
+    if (this->branches_fd_ != -1) {
+        // Same group as the branch counters, so all four cover exactly the same interval.
+        this->cache_references_fd_ = openCounter(PERF_COUNT_HW_CACHE_REFERENCES, this->branches_fd_);
+        this->cache_misses_fd_ = openCounter(PERF_COUNT_HW_CACHE_MISSES, this->branches_fd_);
+        if (this->cache_references_fd_ == -1 || this->cache_misses_fd_ == -1) {
+            if (this->cache_references_fd_ != -1) close(this->cache_references_fd_);
+            if (this->cache_misses_fd_ != -1) close(this->cache_misses_fd_);
+            this->cache_references_fd_ = -1;
+            this->cache_misses_fd_ = -1;
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    if (this->cache_misses_fd_ != -1) close(this->cache_misses_fd_);
+    if (this->cache_references_fd_ != -1) close(this->cache_references_fd_);
+    if (this->misses_fd_ != -1) close(this->misses_fd_);
+    if (this->branches_fd_ != -1) close(this->branches_fd_);
+}
+
+bool PerfCounters::isAvailable() const {
+    return this->branches_fd_ != -1;
+}
+
+bool PerfCounters::isCacheAvailable() const {
+    return this->cache_misses_fd_ != -1;
+}
+
+void PerfCounters::start() {
+    if (!this->isAvailable()) {
+        return;
+    }
+    ioctl(this->branches_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(this->branches_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::Sample PerfCounters::stop() {
+    Sample sample;
+    if (!this->isAvailable()) {
+        return sample;
+    }
+    ioctl(this->branches_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    sample.branches = readCounter(this->branches_fd_);
+    sample.branch_misses = readCounter(this->misses_fd_);
+    if (this->isCacheAvailable()) {
+        sample.cache_references = readCounter(this->cache_references_fd_);
+        sample.cache_misses = readCounter(this->cache_misses_fd_);
+    }
+    return sample;
+}
+
+#else // !__linux__
+
+PerfCounters::PerfCounters() = default;
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::isAvailable() const {
+    return false;
+}
+
+bool PerfCounters::isCacheAvailable() const {
+    return false;
+}
+
+void PerfCounters::start() {}
+
+PerfCounters::Sample PerfCounters::stop() {
+    return {};
+}
+
+#endif
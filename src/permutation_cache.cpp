@@ -0,0 +1,309 @@
+//
+// Sorted row orders kept per dataset and key, so repeating a sort costs a copy.
+//
+
+#include <permutation_cache.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+namespace {
+    constexpr char CACHE_MAGIC[8] = {'C', 'I', 'T', 'Y', 'P', 'E', 'R', 'M'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+    struct CacheHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint64_t fingerprint;
+        std::uint64_t row_count;
+        std::uint64_t entry_count;
+    };
+
+    struct EntryHeader {
+        std::uint32_t key_length;
+        std::uint32_t stable;
+    };
+
+    constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashBytes(std::uint64_t& hash, const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+    }
+
+    template <typename T>
+    void hashValue(std::uint64_t& hash, T value) {
+        hashBytes(hash, &value, sizeof(value));
+    }
+
+    // The same order with the first field ascending, and whether the request is its reverse.
+    // A field's direction is (descending XOR reverse_order); flipping every field mirrors the order.
+    CompositeKey ascendingSpelling(const CompositeKey& keys, bool reverse_order, bool& walk_backwards) {
+        walk_backwards = keys.front().descending != reverse_order;
+        CompositeKey ascending = keys;
+        for (KeyField& field : ascending) {
+            field.descending = (field.descending != reverse_order) != walk_backwards;
+        }
+        return ascending;
+    }
+
+    // Sorts every run of equal keys by row index, so ties are in dataset order.
+    Sorter::Permutation stabilize(const Sorter::Permutation& order, const std::vector<City>& cities,
+                                  const CompositeLess& less) {
+        Sorter::Permutation stable = order;
+        size_t begin = 0;
+        while (begin < stable.size()) {
+            size_t end = begin + 1;
+            while (end < stable.size() && !less(cities[stable[begin]], cities[stable[end]])) {
+                ++end;
+            }
+            std::sort(stable.begin() + static_cast<long>(begin), stable.begin() + static_cast<long>(end));
+            begin = end;
+        }
+        return stable;
+    }
+
+    // First `count` rows of `order` read from the end. With `stable`, each run of equal
+    // keys is still read front to back, so ties stay in the ascending order's tie order.
+    Sorter::Permutation walkBackwards(const Sorter::Permutation& order, size_t count, bool stable,
+                                      const std::vector<City>& cities, const CompositeLess& less) {
+        Sorter::Permutation result;
+        result.reserve(count);
+        if (!stable) {
+            for (size_t i = 0; i < count; ++i) {
+                result.push_back(order[order.size() - 1 - i]);
+            }
+            return result;
+        }
+        size_t end = order.size();
+        while (result.size() < count) {
+            size_t begin = end - 1;
+            while (begin > 0 && !less(cities[order[begin - 1]], cities[order[end - 1]])) {
+                --begin;
+            }
+            for (size_t i = begin; i < end && result.size() < count; ++i) {
+                result.push_back(order[i]);
+            }
+            end = begin;
+        }
+        return result;
+    }
+
+    template <typename T>
+    void readExactly(std::ifstream& in, T* data, size_t count, const std::string& path) {
+        in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!in) {
+            throw std::runtime_error("PermutationCache Error: Truncated cache file: " + path);
+        }
+    }
+}
+
+PermutationCache::PermutationCache(const std::vector<City>& cities)
+    : cities_(cities), fingerprint_(fingerprintCities(cities)) {}
+
+std::uint64_t PermutationCache::fingerprintCities(const std::vector<City>& cities) {
+    std::uint64_t hash = FNV_OFFSET;
+    hashValue(hash, static_cast<std::uint64_t>(cities.size()));
+    for (const City& city : cities) {
+        // Lengths first, so "ab"+"c" and "a"+"bc" differ.
+        hashValue(hash, static_cast<std::uint32_t>(city.name.size()));
+        hashBytes(hash, city.name.data(), city.name.size());
+        hashValue(hash, static_cast<std::uint32_t>(city.country.size()));
+        hashBytes(hash, city.country.data(), city.country.size());
+        hashValue(hash, static_cast<std::int64_t>(city.population));
+        hashValue(hash, city.lat);
+        hashValue(hash, city.lng);
+    }
+    return hash;
+}
+
+Sorter::Permutation PermutationCache::get(const CompositeKey& keys, bool reverse_order, bool stable,
+                                          const SortAscending& sort_ascending, size_t limit) {
+    if (keys.empty()) {
+        throw std::invalid_argument("PermutationCache: empty key");
+    }
+    bool walk_backwards = false;
+    const CompositeKey ascending = ascendingSpelling(keys, reverse_order, walk_backwards);
+    const std::string name = compositeKeyName(ascending);
+    const CompositeLess less(ascending, false);
+
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        auto found = this->entries_.find(name);
+        if (found != this->entries_.end()) {
+            entry = found->second;
+            ++this->stats_.hits;
+            this->stats_.reversed_hits += walk_backwards;
+        }
+    }
+
+    if (!entry.order) {
+        Sorter::Permutation sorted = sort_ascending(ascending);
+        if (sorted.size() != this->cities_.size()) {
+            throw std::logic_error("PermutationCache: the sort returned " + std::to_string(sorted.size()) +
+                                   " rows for a dataset of " + std::to_string(this->cities_.size()));
+        }
+        entry.order = std::make_shared<const Sorter::Permutation>(std::move(sorted));
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        ++this->stats_.misses;
+        auto [slot, inserted] = this->entries_.emplace(name, entry);
+        if (inserted) {
+            this->modified_ = true;
+        } else {
+            entry = slot->second; // another thread stored it first
+        }
+    }
+
+    if (stable && !entry.stable) {
+        entry.order = std::make_shared<const Sorter::Permutation>(stabilize(*entry.order, this->cities_, less));
+        entry.stable = true;
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->entries_[name] = entry;
+        ++this->stats_.stabilized;
+        this->modified_ = true;
+    }
+
+    const Sorter::Permutation& order = *entry.order;
+    const size_t count = std::min(limit, order.size());
+    if (walk_backwards) {
+        return walkBackwards(order, count, stable, this->cities_, less);
+    }
+    return Sorter::Permutation(order.begin(), order.begin() + static_cast<long>(count));
+}
+
+size_t PermutationCache::load(const std::string& path) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return 0;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("PermutationCache Error: Could not open file: " + path);
+    }
+
+    CacheHeader header{};
+    readExactly(in, &header, 1, path);
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        throw std::runtime_error("PermutationCache Error: Not a permutation cache: " + path);
+    }
+    if (header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_MARK) {
+        throw std::runtime_error("PermutationCache Error: Unsupported cache version or byte order: " + path);
+    }
+    if (header.fingerprint != this->fingerprint_ || header.row_count != this->cities_.size()) {
+        std::cout << "Info: Permutation cache '" << path << "' is for another dataset; ignoring it." << std::endl;
+        return 0;
+    }
+
+    std::unordered_map<std::string, Entry> loaded;
+    std::vector<char> seen(this->cities_.size());
+    for (std::uint64_t e = 0; e < header.entry_count; ++e) {
+        EntryHeader entry_header{};
+        readExactly(in, &entry_header, 1, path);
+        if (entry_header.key_length == 0 || entry_header.key_length > 64) {
+            throw std::runtime_error("PermutationCache Error: Corrupt entry in cache file: " + path);
+        }
+        std::string name(entry_header.key_length, '\0');
+        readExactly(in, name.data(), name.size(), path);
+        try {
+            const CompositeKey keys = parseCompositeKey(name);
+            if (keys.front().descending || compositeKeyName(keys) != name) {
+                throw std::invalid_argument("not an ascending spelling");
+            }
+        } catch (const std::invalid_argument&) {
+            throw std::runtime_error("PermutationCache Error: Corrupt key '" + name + "' in cache file: " + path);
+        }
+
+        Sorter::Permutation order(this->cities_.size());
+        readExactly(in, order.data(), order.size(), path);
+        // Every row exactly once: the permutation is used to index the dataset.
+        std::fill(seen.begin(), seen.end(), 0);
+        for (std::uint32_t row : order) {
+            if (row >= seen.size() || seen[row]) {
+                throw std::runtime_error("PermutationCache Error: Corrupt permutation for '" + name + "' in: " + path);
+            }
+            seen[row] = 1;
+        }
+        loaded[name] = Entry{std::make_shared<const Sorter::Permutation>(std::move(order)), entry_header.stable != 0};
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (auto& [name, entry] : loaded) {
+        Entry& slot = this->entries_[name];
+        if (!slot.order || (entry.stable && !slot.stable)) {
+            slot = std::move(entry);
+        }
+    }
+    this->stats_.loaded += loaded.size();
+    this->modified_ = false;
+    return loaded.size();
+}
+
+void PermutationCache::save(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.fingerprint = this->fingerprint_;
+    header.row_count = this->cities_.size();
+    header.entry_count = this->entries_.size();
+
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("PermutationCache Error: Could not create file: " + temp_path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& [name, entry] : this->entries_) {
+            const EntryHeader entry_header{static_cast<std::uint32_t>(name.size()), entry.stable ? 1u : 0u};
+            out.write(reinterpret_cast<const char*>(&entry_header), sizeof(entry_header));
+            out.write(name.data(), static_cast<std::streamsize>(name.size()));
+            out.write(reinterpret_cast<const char*>(entry.order->data()),
+                      static_cast<std::streamsize>(entry.order->size() * sizeof(std::uint32_t)));
+        }
+        if (!out) {
+            throw std::runtime_error("PermutationCache Error: Failed while writing: " + temp_path);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        throw std::runtime_error("PermutationCache Error: Could not move cache file into place: " + path);
+    }
+    this->modified_ = false;
+}
+
+bool PermutationCache::isModified() const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    return this->modified_;
+}
+
+PermutationCache::Stats PermutationCache::getStats() const {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    Stats stats = this->stats_;
+    stats.entries = this->entries_.size();
+    return stats;
+}
+
+std::string PermutationCache::describeStats() const {
+    const Stats stats = this->getStats();
+    return std::to_string(stats.hits) + (stats.hits == 1 ? " hit (" : " hits (") + std::to_string(stats.reversed_hits) +
+           " reversed), " + std::to_string(stats.misses) + (stats.misses == 1 ? " miss, " : " misses, ") +
+           std::to_string(stats.stabilized) + " stabilized, " + std::to_string(stats.entries) +
+           (stats.entries == 1 ? " entry (" : " entries (") + std::to_string(stats.loaded) + " loaded)";
+}
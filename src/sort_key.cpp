@@ -0,0 +1,72 @@
+//
+// Sort keys (columns of City) and the comparators that order by them.
+//
+
+#include <sort_key.hpp>
+#include <stdexcept>
+#include <cstring>
+#include <unordered_map>
+
+using KeyComparator = std::function<bool(const City&, const City&)>;
+
+namespace {
+
+const std::unordered_map<std::string, SortKey> key_names = {
+    {"name", SortKey::Name},
+    {"country", SortKey::Country},
+    {"population", SortKey::Population},
+    {"lat", SortKey::Lat},
+    {"lng", SortKey::Lng}
+};
+
+// Comparator for every (key, direction) slot, indexed by keyDispatchIndex().
+const KeyComparator comparator_table[SORT_KEY_COUNT * 2] = {
+    KeyLess<SortKey::Name, false>{},       KeyLess<SortKey::Name, true>{},
+    KeyLess<SortKey::Country, false>{},    KeyLess<SortKey::Country, true>{},
+    KeyLess<SortKey::Population, false>{}, KeyLess<SortKey::Population, true>{},
+    KeyLess<SortKey::Lat, false>{},        KeyLess<SortKey::Lat, true>{},
+    KeyLess<SortKey::Lng, false>{},        KeyLess<SortKey::Lng, true>{}
+};
+
+} // namespace
+
+SortKey parseSortKey(const std::string& key) {
+    auto it = key_names.find(key);
+    if (it == key_names.end()) {
+        throw std::invalid_argument("Error: Unknown sort key specified for comparator: " + key);
+    }
+    return it->second;
+}
+
+std::string sortKeyName(SortKey key) {
+    for (const auto& [name, value] : key_names) {
+        if (value == key) {
+            return name;
+        }
+    }
+    return "unknown";
+}
+
+bool isNumericKey(SortKey key) {
+    return key == SortKey::Population || key == SortKey::Lat || key == SortKey::Lng;
+}
+
+std::uint64_t orderedKeyBits(long value) {
+    // Flipping the sign bit maps INT64_MIN..INT64_MAX onto 0..UINT64_MAX in order.
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) ^ (std::uint64_t{1} << 63);
+}
+
+std::uint64_t orderedKeyBits(double value) {
+    if (value == 0.0) {
+        value = 0.0; // -0.0 compares equal to 0.0, so give both the same key
+    }
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Negative doubles: invert every bit (larger magnitude -> smaller key).
+    // Positive doubles: set the sign bit so they sort above all negatives.
+    return (bits & (std::uint64_t{1} << 63)) ? ~bits : (bits | (std::uint64_t{1} << 63));
+}
+
+KeyComparator createKeyComparator(SortKey key, bool reverse_order) {
+    return comparator_table[keyDispatchIndex(key, reverse_order)];
+}
@@ -0,0 +1,690 @@
+//
+// Long-running sort service: the dataset is loaded once and queried over a Unix domain socket.
+//
+
+#include <sort_server.hpp>
+#include <composite_key.hpp>
+#include <field_decoder.hpp>
+#include <sorter.hpp>
+#include <sorter_factory.hpp>
+#include <top_k.hpp>
+#include <algorithms/auto_sorter.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Splits on single spaces/tabs, dropping empty fields.
+std::vector<std::string_view> splitWords(std::string_view line) {
+    std::vector<std::string_view> words;
+    size_t start = 0;
+    while (start < line.size()) {
+        const size_t end = std::min(line.find_first_of(" \t", start), line.size());
+        if (end > start) {
+            words.push_back(line.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return words;
+}
+
+// Splits a "name=value" field; false if `word` has no '='.
+bool splitField(std::string_view word, std::string_view& name, std::string_view& value) {
+    const size_t equals = word.find('=');
+    if (equals == std::string_view::npos) {
+        return false;
+    }
+    name = word.substr(0, equals);
+    value = word.substr(equals + 1);
+    return true;
+}
+
+// Names may hold anything the CSV allowed; tabs and newlines would break the row format.
+void appendText(std::string& out, const std::string& text) {
+    const size_t start = out.size();
+    out += text;
+    std::replace_if(out.begin() + static_cast<long>(start), out.end(),
+                    [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+}
+
+void appendNumber(std::string& out, long value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    // Shortest representation that parses back to the same double.
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+#else
+    const int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    out.append(buffer, static_cast<size_t>(length));
+#endif
+}
+
+City decodeRow(std::string_view line) {
+    std::string_view fields[5];
+    size_t count = 0;
+    size_t start = 0;
+    while (count < 5) {
+        const size_t end = std::min(line.find('\t', start), line.size());
+        fields[count++] = line.substr(start, end - start);
+        if (end == line.size()) {
+            break;
+        }
+        start = end + 1;
+    }
+    City city;
+    if (count != 5 || decodeLong(fields[2], city.population) != DecodeStatus::Ok ||
+        decodeDouble(fields[3], city.lat) != DecodeStatus::Ok || decodeDouble(fields[4], city.lng) != DecodeStatus::Ok) {
+        throw std::runtime_error("SortClient Error: Malformed row in reply: " + std::string(line));
+    }
+    city.name.assign(fields[0]);
+    city.country.assign(fields[1]);
+    return city;
+}
+
+size_t decodeCount(std::string_view value, const std::string& header) {
+    long parsed = 0;
+    if (decodeLong(value, parsed) != DecodeStatus::Ok || parsed < 0) {
+        throw std::runtime_error("SortClient Error: Malformed reply: " + header);
+    }
+    return static_cast<size_t>(parsed);
+}
+
+#ifndef _WIN32
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL; // A client that hung up must not kill the server with SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+bool sendAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t sent = ::send(fd, data.data(), data.size(), SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+sockaddr_un socketAddress(const std::string& socket_path) {
+    sockaddr_un address{};
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("SortServer Error: Invalid socket path (empty or longer than " +
+                                 std::to_string(sizeof(address.sun_path) - 1) + " bytes): " + socket_path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+    return address;
+}
+
+// A connected socket, or -1.
+int connectSocket(const std::string& socket_path) {
+    const sockaddr_un address = socketAddress(socket_path);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#endif
+
+} // namespace
+
+SortQuery parseSortQuery(const std::string& line) {
+    const std::vector<std::string_view> words = splitWords(line);
+    if (words.empty() || words[0] != "SORT") {
+        throw std::invalid_argument("Expected a SORT request");
+    }
+    SortQuery query;
+    for (size_t i = 1; i < words.size(); ++i) {
+        std::string_view name;
+        std::string_view value;
+        if (!splitField(words[i], name, value)) {
+            throw std::invalid_argument("Expected name=value: " + std::string(words[i]));
+        }
+        if (name == "key") {
+            query.key.assign(value);
+            parseCompositeKey(query.key); // throws std::invalid_argument naming the bad key
+        } else if (name == "order") {
+            if (value != "asc" && value != "desc") {
+                throw std::invalid_argument("order must be asc or desc: " + std::string(value));
+            }
+            query.reverse_order = value == "desc";
+        } else if (name == "limit") {
+            long limit = 0;
+            if (decodeLong(value, limit) != DecodeStatus::Ok || limit <= 0) {
+                throw std::invalid_argument("limit must be a positive integer: " + std::string(value));
+            }
+            query.limit = static_cast<size_t>(limit);
+        } else if (name == "algo") {
+            if (value.empty()) {
+                throw std::invalid_argument("algo must not be empty");
+            }
+            query.algorithm.assign(value);
+        } else {
+            throw std::invalid_argument("Unknown field: " + std::string(name));
+        }
+    }
+    if (query.key.empty()) {
+        throw std::invalid_argument("SORT requires key=<keys>");
+    }
+    return query;
+}
+
+std::string formatSortQuery(const SortQuery& query) {
+    std::string line = "SORT key=" + query.key + " order=" + (query.reverse_order ? "desc" : "asc");
+    if (query.limit) {
+        line += " limit=" + std::to_string(*query.limit);
+    }
+    return line + " algo=" + query.algorithm;
+}
+
+// --- SortServer ---
+
+SortServer::SortServer(const std::vector<City>& cities, unsigned int query_threads)
+    : cities_(cities), query_threads_(std::max(1u, query_threads)) {}
+
+SortServer::~SortServer() {
+    this->stop();
+    this->joinConnections(false);
+    this->closeSockets();
+}
+
+SortServer::Stats SortServer::getStats() const {
+    Stats stats;
+    stats.connections = this->connection_count_.load();
+    stats.queries = this->query_count_.load();
+    stats.errors = this->error_count_.load();
+    return stats;
+}
+
+std::string SortServer::handleRequest(const std::string& line) {
+    std::string request = line;
+    if (!request.empty() && request.back() == '\r') {
+        request.pop_back();
+    }
+    const std::vector<std::string_view> words = splitWords(request);
+    const std::string_view command = words.empty() ? std::string_view() : words[0];
+
+    if (command == "SORT") {
+        return this->runQuery(request);
+    }
+    if (command == "PING") {
+        return "PONG\n";
+    }
+    if (command == "STATS") {
+        const Stats stats = this->getStats();
+        std::string reply = "STATS connections=" + std::to_string(stats.connections) +
+                            " queries=" + std::to_string(stats.queries) + " errors=" + std::to_string(stats.errors);
+        if (this->cache_ != nullptr) {
+            const PermutationCache::Stats cache_stats = this->cache_->getStats();
+            reply += " cache_hits=" + std::to_string(cache_stats.hits) +
+                     " cache_misses=" + std::to_string(cache_stats.misses);
+        }
+        return reply + "\n";
+    }
+    if (command == "QUIT") {
+        return "BYE\n";
+    }
+    if (command == "SHUTDOWN") {
+        this->stop();
+        return "BYE\n";
+    }
+    ++this->error_count_;
+    return "ERR Unknown request: " + std::string(command) + "\n";
+}
+
+std::string SortServer::runQuery(const std::string& line) {
+    {
+        std::unique_lock<std::mutex> lock(this->slots_mutex_);
+        this->slot_freed_.wait(lock, [this] { return this->running_queries_ < this->query_threads_; });
+        ++this->running_queries_;
+    }
+    const auto release_slot = [this] {
+        {
+            std::lock_guard<std::mutex> lock(this->slots_mutex_);
+            --this->running_queries_;
+        }
+        this->slot_freed_.notify_one();
+    };
+
+    std::string reply;
+    try {
+        const SortQuery query = parseSortQuery(line);
+        const CompositeKey keys = parseCompositeKey(query.key);
+
+        auto start_time = std::chrono::steady_clock::now();
+        Sorter::Permutation order;
+        std::string algorithm;
+        if (this->cache_ != nullptr) {
+            std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(query.algorithm);
+            sorter->setThreadCount(1);
+            // Ties as selectTopK() or a stable <algo> would order them.
+            const bool stable = (query.limit && *query.limit < this->cities_.size()) || sorter->isStable();
+            algorithm = "cache";
+            order = this->cache_->get(keys, query.reverse_order, stable, [&](const CompositeKey& ascending_keys) {
+                Sorter::Permutation sorted = sorter->sortIndicesByKeys(this->cities_, ascending_keys, false);
+                algorithm = sorter->getName();
+                if (const auto* auto_sorter = dynamic_cast<const AutoSorter*>(sorter.get())) {
+                    algorithm += ":" + auto_sorter->lastDecision().algorithm;
+                }
+                return sorted;
+            }, query.limit.value_or(SIZE_MAX));
+        } else if (query.limit && *query.limit < this->cities_.size()) {
+            order = selectTopK(this->cities_, keys, query.reverse_order, *query.limit);
+            algorithm = "top-k";
+        } else {
+            std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(query.algorithm);
+            sorter->setThreadCount(1); // queries run side by side; each stays on its thread
+            order = sorter->sortIndicesByKeys(this->cities_, keys, query.reverse_order);
+            algorithm = sorter->getName();
+            if (const auto* auto_sorter = dynamic_cast<const AutoSorter*>(sorter.get())) {
+                algorithm += ":" + auto_sorter->lastDecision().algorithm;
+            }
+        }
+        auto end_time = std::chrono::steady_clock::now();
+
+        const size_t rows = std::min(order.size(), query.limit.value_or(order.size()));
+        reply.reserve(64 + rows * 64);
+        reply += "OK rows=" + std::to_string(rows) + " total=" + std::to_string(this->cities_.size()) +
+                 " algo=" + algorithm + " us=" +
+                 std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count()) +
+                 "\n";
+        for (size_t i = 0; i < rows; ++i) {
+            const City& city = this->cities_[order[i]];
+            appendText(reply, city.name);
+            reply += '\t';
+            appendText(reply, city.country);
+            reply += '\t';
+            appendNumber(reply, city.population);
+            reply += '\t';
+            appendNumber(reply, city.lat);
+            reply += '\t';
+            appendNumber(reply, city.lng);
+            reply += '\n';
+        }
+        ++this->query_count_;
+    } catch (const std::exception& e) {
+        ++this->error_count_;
+        reply.clear();
+        reply = "ERR ";
+        appendText(reply, e.what());
+        reply += '\n';
+    }
+    release_slot();
+    return reply;
+}
+
+void SortServer::setPermutationCache(PermutationCache* cache) {
+    this->cache_ = cache;
+}
+
+void SortServer::joinConnections(bool finished_only) {
+    std::lock_guard<std::mutex> lock(this->connections_mutex_);
+    for (auto it = this->connections_.begin(); it != this->connections_.end();) {
+        if (finished_only && !it->finished.load()) {
+            ++it;
+            continue;
+        }
+        if (it->thread.joinable()) {
+            it->thread.join();
+        }
+        it = this->connections_.erase(it);
+    }
+}
+
+#ifdef _WIN32
+
+void SortServer::listen(const std::string&) {
+    throw std::runtime_error("SortServer Error: Unix domain sockets are not supported on this platform.");
+}
+
+void SortServer::serve() {
+    throw std::runtime_error("SortServer Error: Unix domain sockets are not supported on this platform.");
+}
+
+void SortServer::stop() {
+    this->stopping_ = true;
+}
+
+void SortServer::serveConnection(Connection& connection) {
+    connection.finished = true;
+}
+
+void SortServer::closeSockets() noexcept {}
+
+SortClient::SortClient(const std::string&) {
+    throw std::runtime_error("SortClient Error: Unix domain sockets are not supported on this platform.");
+}
+
+SortClient::~SortClient() = default;
+
+void SortClient::sendLine(const std::string&) {}
+
+void SortClient::readLine(std::string&) {}
+
+#else
+
+void SortServer::listen(const std::string& socket_path) {
+    if (this->listen_fd_ >= 0) {
+        throw std::logic_error("SortServer: listen() called twice");
+    }
+    const sockaddr_un address = socketAddress(socket_path);
+
+    struct stat existing{};
+    if (::lstat(socket_path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            throw std::runtime_error("SortServer Error: " + socket_path + " exists and is not a socket.");
+        }
+        const int live = connectSocket(socket_path);
+        if (live >= 0) {
+            ::close(live);
+            throw std::runtime_error("SortServer Error: A server is already listening on " + socket_path);
+        }
+        ::unlink(socket_path.c_str()); // left behind by a server that did not shut down
+    }
+
+    if (::pipe(this->wake_fds_) != 0) {
+        throw std::runtime_error(std::string("SortServer Error: pipe failed: ") + std::strerror(errno));
+    }
+    this->listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (this->listen_fd_ < 0) {
+        throw std::runtime_error(std::string("SortServer Error: socket failed: ") + std::strerror(errno));
+    }
+    if (::bind(this->listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        const std::string reason = std::strerror(errno);
+        this->closeSockets();
+        throw std::runtime_error("SortServer Error: Could not bind " + socket_path + ": " + reason);
+    }
+    this->socket_path_ = socket_path; // ours to unlink from here on
+    if (::listen(this->listen_fd_, SOMAXCONN) != 0) {
+        const std::string reason = std::strerror(errno);
+        this->closeSockets();
+        throw std::runtime_error("SortServer Error: Could not listen on " + socket_path + ": " + reason);
+    }
+}
+
+void SortServer::serve() {
+    if (this->listen_fd_ < 0) {
+        throw std::logic_error("SortServer: serve() called before listen()");
+    }
+    while (!this->stopping_) {
+        pollfd fds[2] = {{this->listen_fd_, POLLIN, 0}, {this->wake_fds_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("SortServer Error: poll failed: ") + std::strerror(errno));
+        }
+        if (fds[1].revents != 0) {
+            break;
+        }
+        if ((fds[0].revents & POLLIN) == 0) {
+            continue;
+        }
+        const int fd = ::accept(this->listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue; // EINTR, or a client that gave up before we accepted it
+        }
+        this->joinConnections(true); // reap the threads of closed connections
+        std::lock_guard<std::mutex> lock(this->connections_mutex_);
+        Connection& connection = this->connections_.emplace_back();
+        connection.fd = fd;
+        connection.thread = std::thread(&SortServer::serveConnection, this, std::ref(connection));
+        ++this->connection_count_;
+    }
+    this->joinConnections(false);
+}
+
+void SortServer::stop() {
+    if (!this->stopping_.exchange(true) && this->wake_fds_[1] >= 0) {
+        const char wake = 1;
+        [[maybe_unused]] const ssize_t written = ::write(this->wake_fds_[1], &wake, 1);
+    }
+}
+
+void SortServer::serveConnection(Connection& connection) {
+    std::string pending;
+    char buffer[4096];
+    bool open = true;
+    while (open) {
+        // Answer every complete line first: a client may send several requests at once.
+        size_t newline;
+        while (open && (newline = pending.find('\n')) != std::string::npos) {
+            const std::string reply = this->handleRequest(pending.substr(0, newline));
+            pending.erase(0, newline + 1);
+            open = sendAll(connection.fd, reply) && reply.compare(0, 3, "BYE") != 0;
+        }
+        if (!open || this->stopping_) {
+            break;
+        }
+        if (pending.size() > MAX_LINE_BYTES) {
+            ++this->error_count_;
+            sendAll(connection.fd, "ERR Request line longer than " + std::to_string(MAX_LINE_BYTES) + " bytes\n");
+            break;
+        }
+
+        pollfd fds[2] = {{connection.fd, POLLIN, 0}, {this->wake_fds_[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0) {
+            break; // shutting down
+        }
+        const ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break; // closed by the client
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+    }
+    ::close(connection.fd);
+    connection.finished = true;
+}
+
+void SortServer::closeSockets() noexcept {
+    if (this->listen_fd_ >= 0) {
+        ::close(this->listen_fd_);
+        this->listen_fd_ = -1;
+    }
+    for (int& fd : this->wake_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (!this->socket_path_.empty()) {
+        ::unlink(this->socket_path_.c_str());
+        this->socket_path_.clear();
+    }
+}
+
+// --- SortClient ---
+
+SortClient::SortClient(const std::string& socket_path) : fd_(connectSocket(socket_path)) {
+    if (this->fd_ < 0) {
+        throw std::runtime_error("SortClient Error: Could not connect to " + socket_path +
+                                 " (is citysort --serve running?)");
+    }
+}
+
+SortClient::~SortClient() {
+    if (this->fd_ >= 0) {
+        ::close(this->fd_);
+    }
+}
+
+void SortClient::sendLine(const std::string& line) {
+    if (!sendAll(this->fd_, line + "\n")) {
+        throw std::runtime_error(std::string("SortClient Error: send failed: ") + std::strerror(errno));
+    }
+}
+
+void SortClient::readLine(std::string& line) {
+    size_t newline;
+    while ((newline = this->buffer_.find('\n', this->buffer_offset_)) == std::string::npos) {
+        this->buffer_.erase(0, this->buffer_offset_);
+        this->buffer_offset_ = 0;
+        char chunk[64 * 1024];
+        const ssize_t received = ::recv(this->fd_, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            throw std::runtime_error("SortClient Error: The server closed the connection.");
+        }
+        this->buffer_.append(chunk, static_cast<size_t>(received));
+    }
+    line.assign(this->buffer_, this->buffer_offset_, newline - this->buffer_offset_);
+    this->buffer_offset_ = newline + 1;
+}
+
+#endif
+
+SortReply SortClient::query(const SortQuery& query) {
+    this->sendLine(formatSortQuery(query));
+    std::string header;
+    this->readLine(header);
+    if (header.compare(0, 4, "ERR ") == 0) {
+        throw std::runtime_error("SortServer: " + header.substr(4));
+    }
+    const std::vector<std::string_view> words = splitWords(header);
+    if (words.empty() || words[0] != "OK") {
+        throw std::runtime_error("SortClient Error: Unexpected reply: " + header);
+    }
+
+    SortReply reply;
+    size_t rows = 0;
+    for (size_t i = 1; i < words.size(); ++i) {
+        std::string_view name;
+        std::string_view value;
+        if (!splitField(words[i], name, value)) {
+            continue;
+        }
+        if (name == "rows") {
+            rows = decodeCount(value, header);
+        } else if (name == "total") {
+            reply.total_rows = decodeCount(value, header);
+        } else if (name == "algo") {
+            reply.algorithm.assign(value);
+        } else if (name == "us") {
+            reply.server_us = static_cast<long long>(decodeCount(value, header));
+        }
+    }
+
+    reply.rows.reserve(rows);
+    std::string line;
+    for (size_t i = 0; i < rows; ++i) {
+        this->readLine(line);
+        reply.rows.push_back(decodeRow(line));
+    }
+    return reply;
+}
+
+std::string SortClient::request(const std::string& line) {
+    this->sendLine(line);
+    std::string reply;
+    this->readLine(reply);
+    return reply;
+}
+
+// --- Load generator ---
+
+LoadReport runLoadGenerator(const std::string& socket_path, const std::vector<SortQuery>& queries,
+                            unsigned int connections, size_t requests) {
+    if (queries.empty() || connections == 0) {
+        throw std::invalid_argument("runLoadGenerator: needs at least one query and one connection");
+    }
+    std::vector<std::vector<double>> latencies(connections);
+    std::vector<size_t> errors(connections, 0);
+
+    auto run_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (unsigned int c = 0; c < connections; ++c) {
+        const size_t share = requests / connections + (c < requests % connections ? 1 : 0);
+        clients.emplace_back([&, c, share] {
+            size_t sent = 0;
+            try {
+                SortClient client(socket_path);
+                latencies[c].reserve(share);
+                for (; sent < share; ++sent) {
+                    const SortQuery& query = queries[(c + sent) % queries.size()];
+                    auto start = std::chrono::steady_clock::now();
+                    try {
+                        client.query(query);
+                    } catch (const std::runtime_error&) {
+                        ++errors[c];
+                        continue;
+                    }
+                    auto end = std::chrono::steady_clock::now();
+                    latencies[c].push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                }
+            } catch (const std::exception&) {
+                errors[c] += share - sent; // could not connect
+            }
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    auto run_end = std::chrono::steady_clock::now();
+
+    std::vector<double> all;
+    LoadReport report;
+    for (unsigned int c = 0; c < connections; ++c) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        report.errors += errors[c];
+    }
+    std::sort(all.begin(), all.end());
+    report.requests = all.size();
+    report.seconds = std::chrono::duration<double>(run_end - run_start).count();
+    report.throughput = report.seconds > 0.0 ? static_cast<double>(report.requests) / report.seconds : 0.0;
+    if (!all.empty()) {
+        // Nearest-rank percentiles.
+        const auto percentile = [&all](double p) {
+            const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(all.size())));
+            return all[std::max<size_t>(rank, 1) - 1];
+        };
+        report.p50_ms = percentile(0.50);
+        report.p99_ms = percentile(0.99);
+        report.max_ms = all.back();
+    }
+    return report;
+}
@@ -13,7 +13,15 @@
 #include <algorithms/merge_sorter.hpp>
 #include <algorithms/quick_sorter.hpp>
 #include <algorithms/heap_sorter.hpp>
+#include <algorithms/dary_heap_sorter.hpp>
 #include <algorithms/std_sorter.hpp>
+#include <algorithms/radix_sorter.hpp>
+#include <algorithms/multikey_sorter.hpp>
+#include <algorithms/block_quick_sorter.hpp>
+#include <algorithms/parallel_merge_sorter.hpp>
+#include <algorithms/sample_sorter.hpp>
+#include <algorithms/tim_sorter.hpp>
+#include <algorithms/auto_sorter.hpp>
 
 #include <unordered_map>
 #include <functional>
@@ -48,9 +56,33 @@ static const std::unordered_map<std::string, SorterCreator> sorter_registry = {
         return std::make_unique<HeapSorter>();
 //        throw std::runtime_error("SorterFactory: HeapSorter not yet implemented.");
     }},
+    {"heap4", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<DaryHeapSorter>();
+    }},
     {"std", []() -> std::unique_ptr<Sorter> {
         return std::make_unique<StdSorter>();
 //        throw std::runtime_error("SorterFactory: StdSorter not yet implemented.");
+    }},
+    {"radix", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<RadixSorter>();
+    }},
+    {"multikey", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<MultikeySorter>();
+    }},
+    {"blockquick", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<BlockQuickSorter>();
+    }},
+    {"pmerge", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<ParallelMergeSorter>();
+    }},
+    {"samplesort", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<SampleSorter>();
+    }},
+    {"tim", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<TimSorter>();
+    }},
+    {"auto", []() -> std::unique_ptr<Sorter> {
+        return std::make_unique<AutoSorter>();
     }}
 };
 
@@ -0,0 +1,295 @@
+//
+// Sorting networks for small blocks of packed (key, row index) records.
+//
+
+#include "sorting_network.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SORTING_NETWORK_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Padding record: its key is the largest possible, and its index larger than any
+// 32-bit row index, so it sorts after every real record, including key UINT64_MAX.
+constexpr std::uint64_t PAD_KEY = std::numeric_limits<std::uint64_t>::max();
+constexpr std::uint64_t PAD_INDEX = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+// One network block, split into keys and (widened) indices so both fill 64-bit lanes.
+struct NetworkBlock {
+    alignas(32) std::array<std::uint64_t, SORTING_NETWORK_SIZE> keys;
+    alignas(32) std::array<std::uint64_t, SORTING_NETWORK_SIZE> indices;
+};
+
+void loadBlock(NetworkBlock& block, const PackedRow* rows, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        block.keys[i] = rows[i].key;
+        block.indices[i] = rows[i].index;
+    }
+    for (std::size_t i = count; i < SORTING_NETWORK_SIZE; ++i) {
+        block.keys[i] = PAD_KEY;
+        block.indices[i] = PAD_INDEX;
+    }
+}
+
+void storeBlock(const NetworkBlock& block, PackedRow* rows, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        rows[i].key = block.keys[i];
+        rows[i].index = static_cast<std::uint32_t>(block.indices[i]);
+    }
+}
+
+bool rowLess(const PackedRow& a, const PackedRow& b) {
+    return a.key < b.key || (a.key == b.key && a.index < b.index);
+}
+
+void insertionSort(PackedRow* rows, std::size_t count) {
+    for (std::size_t i = 1; i < count; ++i) {
+        const PackedRow row = rows[i];
+        std::size_t j = i;
+        while (j > 0 && rowLess(row, rows[j - 1])) {
+            rows[j] = rows[j - 1];
+            --j;
+        }
+        rows[j] = row;
+    }
+}
+
+// --- Scalar kernel ---
+
+// Orders slots a < b (ascending) or a > b (descending) without branching on the data.
+inline void compareExchange(NetworkBlock& block, std::size_t a, std::size_t b, bool ascending) {
+    const std::uint64_t key_a = block.keys[a];
+    const std::uint64_t key_b = block.keys[b];
+    const std::uint64_t index_a = block.indices[a];
+    const std::uint64_t index_b = block.indices[b];
+    const bool a_greater = key_a > key_b || (key_a == key_b && index_a > index_b);
+    const bool swap = a_greater == ascending;
+    block.keys[a] = swap ? key_b : key_a;
+    block.keys[b] = swap ? key_a : key_b;
+    block.indices[a] = swap ? index_b : index_a;
+    block.indices[b] = swap ? index_a : index_b;
+}
+
+void sortBlockScalar(NetworkBlock& block) {
+    // Bitonic sort: merge runs of `width`, each pass halving the compare distance.
+    for (std::size_t width = 2; width <= SORTING_NETWORK_SIZE; width <<= 1) {
+        for (std::size_t distance = width >> 1; distance > 0; distance >>= 1) {
+            for (std::size_t i = 0; i < SORTING_NETWORK_SIZE; ++i) {
+                const std::size_t partner = i ^ distance;
+                if (partner > i) {
+                    compareExchange(block, i, partner, (i & width) == 0);
+                }
+            }
+        }
+    }
+}
+
+// --- AVX2 kernel ---
+
+#ifdef SORTING_NETWORK_AVX2
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Four records: keys and indices in matching 64-bit lanes.
+struct Lanes {
+    __m256i keys;
+    __m256i indices;
+};
+
+// Lane mask of (a.key, a.index) > (b.key, b.index). AVX2 only compares signed 64-bit
+// lanes, so keys are compared with their sign bit flipped; indices are below 2^63.
+AVX2_TARGET inline __m256i greaterMask(const Lanes& a, const Lanes& b) {
+    const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+    const __m256i key_greater =
+        _mm256_cmpgt_epi64(_mm256_xor_si256(a.keys, sign), _mm256_xor_si256(b.keys, sign));
+    const __m256i key_equal = _mm256_cmpeq_epi64(a.keys, b.keys);
+    const __m256i index_greater = _mm256_cmpgt_epi64(a.indices, b.indices);
+    return _mm256_or_si256(key_greater, _mm256_and_si256(key_equal, index_greater));
+}
+
+// Lane-wise compare-exchange between two registers: a takes the minimums, b the maximums.
+AVX2_TARGET inline void compareExchange(Lanes& a, Lanes& b) {
+    const __m256i swap = greaterMask(a, b);
+    const Lanes low{_mm256_blendv_epi8(a.keys, b.keys, swap), _mm256_blendv_epi8(a.indices, b.indices, swap)};
+    b = {_mm256_blendv_epi8(b.keys, a.keys, swap), _mm256_blendv_epi8(b.indices, a.indices, swap)};
+    a = low;
+}
+
+// Compare-exchange within one register: each lane meets the lane `Partner` maps it to;
+// the lanes selected by the 32-bit blend mask `Upper` keep the maximum.
+template <int Partner, int Upper>
+AVX2_TARGET inline void compareExchangeLanes(Lanes& lanes) {
+    const Lanes partner{_mm256_permute4x64_epi64(lanes.keys, Partner),
+                        _mm256_permute4x64_epi64(lanes.indices, Partner)};
+    const __m256i greater = greaterMask(lanes, partner);
+    const __m256i min_keys = _mm256_blendv_epi8(lanes.keys, partner.keys, greater);
+    const __m256i max_keys = _mm256_blendv_epi8(partner.keys, lanes.keys, greater);
+    const __m256i min_indices = _mm256_blendv_epi8(lanes.indices, partner.indices, greater);
+    const __m256i max_indices = _mm256_blendv_epi8(partner.indices, lanes.indices, greater);
+    lanes.keys = _mm256_blend_epi32(min_keys, max_keys, Upper);
+    lanes.indices = _mm256_blend_epi32(min_indices, max_indices, Upper);
+}
+
+// Sorts a bitonic register: lanes 0/1 against 2/3, then 0 against 1 and 2 against 3.
+AVX2_TARGET inline void finishBitonic(Lanes& lanes) {
+    compareExchangeLanes<0x4E, 0xF0>(lanes);
+    compareExchangeLanes<0xB1, 0xCC>(lanes);
+}
+
+AVX2_TARGET inline Lanes reversed(const Lanes& lanes) {
+    return {_mm256_permute4x64_epi64(lanes.keys, 0x1B), _mm256_permute4x64_epi64(lanes.indices, 0x1B)};
+}
+
+// Rows of the 4 x 4 block become columns.
+AVX2_TARGET inline void transpose(__m256i& r0, __m256i& r1, __m256i& r2, __m256i& r3) {
+    const __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+    const __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+    const __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+    const __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+    r0 = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r1 = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r2 = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r3 = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+// Merges two sorted registers into a sorted pair (a low, b high).
+AVX2_TARGET inline void merge4(Lanes& a, Lanes& b) {
+    b = reversed(b);
+    compareExchange(a, b);
+    finishBitonic(a);
+    finishBitonic(b);
+}
+
+AVX2_TARGET void sortBlockAvx2(NetworkBlock& block) {
+    std::array<Lanes, 4> r;
+    for (std::size_t i = 0; i < r.size(); ++i) {
+        r[i].keys = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.keys.data() + 4 * i));
+        r[i].indices = _mm256_load_si256(reinterpret_cast<const __m256i*>(block.indices.data() + 4 * i));
+    }
+
+    // Sort the four columns at once with a 4-input network across the registers.
+    compareExchange(r[0], r[1]);
+    compareExchange(r[2], r[3]);
+    compareExchange(r[0], r[2]);
+    compareExchange(r[1], r[3]);
+    compareExchange(r[1], r[2]);
+
+    // Each register now holds one sorted column of four.
+    transpose(r[0].keys, r[1].keys, r[2].keys, r[3].keys);
+    transpose(r[0].indices, r[1].indices, r[2].indices, r[3].indices);
+
+    // 4 + 4 -> 8, twice.
+    merge4(r[0], r[1]);
+    merge4(r[2], r[3]);
+
+    // 8 + 8 -> 16: the second run reversed makes the whole block bitonic.
+    Lanes high0 = reversed(r[3]);
+    Lanes high1 = reversed(r[2]);
+    compareExchange(r[0], high0);
+    compareExchange(r[1], high1);
+    compareExchange(r[0], r[1]);
+    compareExchange(high0, high1);
+    finishBitonic(r[0]);
+    finishBitonic(r[1]);
+    finishBitonic(high0);
+    finishBitonic(high1);
+
+    const std::array<Lanes, 4> sorted{r[0], r[1], high0, high1};
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block.keys.data() + 4 * i), sorted[i].keys);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block.indices.data() + 4 * i), sorted[i].indices);
+    }
+}
+
+#undef AVX2_TARGET
+
+#endif // SORTING_NETWORK_AVX2
+
+bool cpuHasAvx2() {
+#ifdef SORTING_NETWORK_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void sortBlock(SmallSortKernel kernel, PackedRow* rows, std::size_t count) {
+    if (kernel == SmallSortKernel::Insertion) {
+        insertionSort(rows, count);
+        return;
+    }
+    NetworkBlock block;
+    loadBlock(block, rows, count);
+#ifdef SORTING_NETWORK_AVX2
+    if (kernel == SmallSortKernel::Avx2Network) {
+        sortBlockAvx2(block);
+    } else {
+        sortBlockScalar(block);
+    }
+#else
+    sortBlockScalar(block);
+#endif
+    storeBlock(block, rows, count);
+}
+
+// Sorts every network-sized block, then merges runs bottom-up through `buffer`.
+void sortRows(SmallSortKernel kernel, PackedRow* rows, std::size_t count, PackedRow* buffer) {
+    for (std::size_t begin = 0; begin < count; begin += SORTING_NETWORK_SIZE) {
+        sortBlock(kernel, rows + begin, std::min(SORTING_NETWORK_SIZE, count - begin));
+    }
+
+    PackedRow* from = rows;
+    PackedRow* to = buffer;
+    for (std::size_t width = SORTING_NETWORK_SIZE; width < count; width *= 2) {
+        for (std::size_t begin = 0; begin < count; begin += 2 * width) {
+            const std::size_t middle = std::min(begin + width, count);
+            const std::size_t end = std::min(begin + 2 * width, count);
+            std::merge(from + begin, from + middle, from + middle, from + end, to + begin, rowLess);
+        }
+        std::swap(from, to);
+    }
+    if (from != rows) {
+        std::copy(from, from + count, rows);
+    }
+}
+
+} // namespace
+
+bool isSmallSortKernelAvailable(SmallSortKernel kernel) {
+    return kernel != SmallSortKernel::Avx2Network || cpuHasAvx2();
+}
+
+SmallSortKernel activeSmallSortKernel() {
+    return cpuHasAvx2() ? SmallSortKernel::Avx2Network : SmallSortKernel::Insertion;
+}
+
+void sortSmallPackedRowsWith(SmallSortKernel kernel, PackedRow* rows, std::size_t count) {
+    if (!isSmallSortKernelAvailable(kernel)) {
+        throw std::invalid_argument("Small-sort kernel is not available on this CPU.");
+    }
+    if (count < 2) {
+        return;
+    }
+    if (count <= SORTING_NETWORK_SIZE) {
+        sortRows(kernel, rows, count, nullptr);
+    } else if (count <= SMALL_SORT_MAX) {
+        std::array<PackedRow, SMALL_SORT_MAX> buffer;
+        sortRows(kernel, rows, count, buffer.data());
+    } else {
+        std::vector<PackedRow> buffer(count);
+        sortRows(kernel, rows, count, buffer.data());
+    }
+}
+
+void sortSmallPackedRows(PackedRow* rows, std::size_t count) {
+    sortSmallPackedRowsWith(activeSmallSortKernel(), rows, count);
+}
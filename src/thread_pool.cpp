@@ -0,0 +1,160 @@
+//
+// Work-stealing thread pool with fork/join task groups.
+//
+
+#include <thread_pool.hpp>
+#include <utility>
+
+namespace {
+
+// Which pool (if any) the current thread works for, and its queue index there.
+thread_local const void* current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int thread_count) {
+    const size_t workers = thread_count > 1 ? thread_count - 1 : 0;
+    // One queue per worker plus one for the external (waiting) thread.
+    for (size_t i = 0; i <= workers; ++i) {
+        this->queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        this->workers_.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->sleep_mutex_);
+        this->stopping_ = true;
+    }
+    this->wake_.notify_all();
+    for (std::thread& worker : this->workers_) {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::threadCount() const {
+    return static_cast<unsigned int>(this->workers_.size() + 1);
+}
+
+size_t ThreadPool::currentQueue() const {
+    if (current_pool == this) {
+        return current_index;
+    }
+    // External threads help out starting from queue 0; their submissions are spread
+    // round-robin in submit().
+    return 0;
+}
+
+void ThreadPool::submit(Task task) {
+    const size_t index = current_pool == this
+        ? current_index
+        : this->next_queue_.fetch_add(1, std::memory_order_relaxed) % this->queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(this->queues_[index]->mutex);
+        this->queues_[index]->tasks.push_back(std::move(task));
+    }
+    this->queued_.fetch_add(1, std::memory_order_release);
+    if (!this->workers_.empty()) {
+        std::lock_guard<std::mutex> lock(this->sleep_mutex_);
+        this->wake_.notify_one();
+    }
+}
+
+bool ThreadPool::popTask(size_t preferred, Task& task) {
+    if (this->queued_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    // Own queue first, newest task (LIFO).
+    {
+        WorkerQueue& own = *this->queues_[preferred];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            this->queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // Steal the oldest task from the others.
+    for (size_t offset = 1; offset < this->queues_.size(); ++offset) {
+        WorkerQueue& victim = *this->queues_[(preferred + offset) % this->queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            this->queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    Task task;
+    if (!this->popTask(this->currentQueue(), task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_index = index;
+    while (true) {
+        Task task;
+        if (this->popTask(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->sleep_mutex_);
+        this->wake_.wait(lock, [this] {
+            return this->stopping_ || this->queued_.load(std::memory_order_acquire) > 0;
+        });
+        if (this->stopping_ && this->queued_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool_(pool) {}
+
+TaskGroup::~TaskGroup() {
+    // Never leave tasks running that reference this group.
+    try {
+        this->wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    this->pending_.fetch_add(1, std::memory_order_relaxed);
+    this->pool_.submit([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(this->error_mutex_);
+            if (!this->error_) {
+                this->error_ = std::current_exception();
+            }
+        }
+        this->pending_.fetch_sub(1, std::memory_order_acq_rel);
+    });
+}
+
+void TaskGroup::wait() {
+    while (this->pending_.load(std::memory_order_acquire) > 0) {
+        if (!this->pool_.runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+    std::lock_guard<std::mutex> lock(this->error_mutex_);
+    if (this->error_) {
+        std::exception_ptr error = this->error_;
+        this->error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
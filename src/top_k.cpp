@@ -0,0 +1,112 @@
+//
+// Selection of the first K rows of a sort order without sorting the whole dataset.
+//
+
+#include <top_k.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+// Strict total order on row indices: the key first, then dataset position, as in a stable sort.
+template <typename Less>
+struct RowLess {
+    const std::vector<City>& cities;
+    Less less;
+
+    bool operator()(std::uint32_t a, std::uint32_t b) const {
+        if (less(cities[a], cities[b])) {
+            return true;
+        }
+        if (less(cities[b], cities[a])) {
+            return false;
+        }
+        return a < b;
+    }
+};
+
+template <typename Less>
+Sorter::Permutation selectWithHeap(const std::vector<City>& cities, std::size_t k, const Less& less) {
+    RowLess<Less> row_less{cities, less};
+    Sorter::Permutation heap = Sorter::identityPermutation(k);
+    std::make_heap(heap.begin(), heap.end(), row_less); // front() is the worst row kept so far
+    for (std::size_t i = k; i < cities.size(); ++i) {
+        const auto row = static_cast<std::uint32_t>(i);
+        if (row_less(row, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), row_less);
+            heap.back() = row;
+            std::push_heap(heap.begin(), heap.end(), row_less);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), row_less);
+    return heap;
+}
+
+template <typename Less>
+Sorter::Permutation selectWithNthElement(const std::vector<City>& cities, std::size_t k, const Less& less) {
+    RowLess<Less> row_less{cities, less};
+    Sorter::Permutation order = Sorter::identityPermutation(cities.size());
+    if (k < order.size()) {
+        std::nth_element(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(), row_less);
+        order.resize(k);
+    }
+    std::sort(order.begin(), order.end(), row_less);
+    return order;
+}
+
+template <typename Less>
+Sorter::Permutation selectWith(const std::vector<City>& cities, std::size_t k, TopKStrategy strategy, const Less& less) {
+    if (strategy == TopKStrategy::Auto) {
+        strategy = k <= cities.size() / TOP_K_HEAP_RATIO ? TopKStrategy::Heap : TopKStrategy::NthElement;
+    }
+    if (strategy == TopKStrategy::Heap) {
+        return selectWithHeap(cities, k, less);
+    }
+    return selectWithNthElement(cities, k, less);
+}
+
+template <SortKey Key, bool Reverse>
+Sorter::Permutation selectBy(const std::vector<City>& cities, std::size_t k, TopKStrategy strategy) {
+    return selectWith(cities, k, strategy, KeyLess<Key, Reverse>{});
+}
+
+using SelectFn = Sorter::Permutation (*)(const std::vector<City>&, std::size_t, TopKStrategy);
+
+// Indexed by keyDispatchIndex().
+constexpr SelectFn select_table[SORT_KEY_COUNT * 2] = {
+    &selectBy<SortKey::Name, false>,       &selectBy<SortKey::Name, true>,
+    &selectBy<SortKey::Country, false>,    &selectBy<SortKey::Country, true>,
+    &selectBy<SortKey::Population, false>, &selectBy<SortKey::Population, true>,
+    &selectBy<SortKey::Lat, false>,        &selectBy<SortKey::Lat, true>,
+    &selectBy<SortKey::Lng, false>,        &selectBy<SortKey::Lng, true>
+};
+
+} // namespace
+
+Sorter::Permutation selectTopK(const std::vector<City>& cities, SortKey key, bool reverse_order, std::size_t k,
+                               TopKStrategy strategy) {
+    if (cities.size() > UINT32_MAX) {
+        throw std::length_error("Top-K Error: Index mode supports at most 2^32 - 1 rows.");
+    }
+    k = std::min(k, cities.size());
+    if (k == 0) {
+        return {};
+    }
+    return select_table[keyDispatchIndex(key, reverse_order)](cities, k, strategy);
+}
+
+Sorter::Permutation selectTopK(const std::vector<City>& cities, const CompositeKey& keys, bool reverse_order,
+                               std::size_t k, TopKStrategy strategy) {
+    if (keys.size() == 1) {
+        return selectTopK(cities, keys.front().key, keys.front().descending != reverse_order, k, strategy);
+    }
+    if (cities.size() > UINT32_MAX) {
+        throw std::length_error("Top-K Error: Index mode supports at most 2^32 - 1 rows.");
+    }
+    k = std::min(k, cities.size());
+    if (k == 0) {
+        return {};
+    }
+    return selectWith(cities, k, strategy, CompositeLess(keys, reverse_order));
+}
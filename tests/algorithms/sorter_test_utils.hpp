@@ -11,6 +11,7 @@
 #include <string>
 #include <algorithm> // For std::sort, std::is_sorted
 #include <functional>
+#include <random>
 
 namespace TestComparators {
     // Using inline for C++17+ to allow definitions in header, or make them static inline for older standards
@@ -43,6 +44,36 @@ namespace TestComparators {
     }
 } // namespace TestComparators
 
+// Value ranges for makeRandomCities(). Every field is drawn uniformly from `distinct_*`
+// values, so small counts give many ties (and few distinct keys).
+struct RandomCityOptions {
+    size_t distinct_names = 100000;        // "City0" ... "City<n-1>"
+    size_t distinct_countries = 40;        // "Country0" ... "Country<n-1>"
+    size_t distinct_populations = 1000000; // min_population ... min_population + n-1
+    size_t distinct_coordinates = 18000;   // Evenly spaced over [-90, 90) and [-180, 180)
+    long min_population = 0;               // Below zero for negative populations
+    size_t max_name_padding = 0;           // Names get 0 ... n extra letters, for varying lengths
+};
+
+// `count` random cities, the same for the same seed and options.
+inline std::vector<City> makeRandomCities(size_t count, unsigned int seed, const RandomCityOptions& options = {}) {
+    std::mt19937 rng(seed);
+    std::vector<City> cities(count);
+    for (City& city : cities) {
+        city.name = "City" + std::to_string(rng() % options.distinct_names);
+        if (options.max_name_padding > 0) {
+            const size_t padding = rng() % (options.max_name_padding + 1);
+            city.name.append(padding, static_cast<char>('a' + rng() % 26));
+        }
+        city.country = "Country" + std::to_string(rng() % options.distinct_countries);
+        city.population = options.min_population + static_cast<long>(rng() % options.distinct_populations);
+        const double coordinates = static_cast<double>(options.distinct_coordinates);
+        city.lat = static_cast<double>(rng() % options.distinct_coordinates) * 180.0 / coordinates - 90.0;
+        city.lng = static_cast<double>(rng() % options.distinct_coordinates) * 360.0 / coordinates - 180.0;
+    }
+    return cities;
+}
+
 struct SorterTestData {
     std::vector<City> cities_empty;
     std::vector<City> cities_one {{"LonelyCity", "Solitude", 10.0, 20.0, 1}};
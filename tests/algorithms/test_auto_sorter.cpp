@@ -0,0 +1,135 @@
+//
+// Tests for the sampling AutoSorter ("-a auto").
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/auto_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"      // Common test utilities
+#include "country_dictionary.hpp"
+#include <random>
+
+namespace {
+
+AutoDecision decision_for(const std::vector<City>& cities, const std::string& spec, bool index_mode,
+                          unsigned int threads = 1) {
+    return AutoSorter::decide(AutoSorter::profileInput(cities, parseCompositeKey(spec), false), index_mode, threads);
+}
+
+} // namespace
+
+class AutoSorterTest : public ::testing::Test {
+protected:
+    AutoSorter sorter_instance;
+    SorterTestData test_data_provider;
+};
+
+TEST_F(AutoSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "auto");
+}
+
+TEST_F(AutoSorterTest, SortsAndRecordsTheDecision) {
+    EXPECT_TRUE(sorter_instance.lastDecision().algorithm.empty());
+
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sortByKey(data, SortKey::Population, true);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byPopulation(true)));
+    EXPECT_EQ(sorter_instance.lastDecision().algorithm, "insertion"); // a handful of rows
+    EXPECT_EQ(sorter_instance.lastDecision().profile.rows, data.size());
+
+    const std::vector<City> cities = makeRandomCities(5000, 1);
+    Sorter::Permutation order = sorter_instance.sortIndicesByKey(cities, SortKey::Name, false);
+    ASSERT_EQ(order.size(), cities.size());
+    for (size_t i = 1; i < order.size(); ++i) {
+        ASSERT_LE(cities[order[i - 1]].name, cities[order[i]].name);
+    }
+    EXPECT_FALSE(sorter_instance.lastDecision().describe().empty());
+
+    data = cities;
+    sorter_instance.sort(data, TestComparators::byName());
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byName()));
+    EXPECT_TRUE(sorter_instance.lastDecision().profile.opaque);
+    EXPECT_EQ(sorter_instance.lastDecision().algorithm, "quick");
+
+    std::vector<City> empty = test_data_provider.cities_empty;
+    sorter_instance.sortByKey(empty, SortKey::Name, false);
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(AutoSorterTest, ProfilesPresortednessAndCardinality) {
+    std::vector<City> cities = makeRandomCities(20000, 2);
+    InputProfile random = AutoSorter::profileInput(cities, parseCompositeKey("population"), false);
+    EXPECT_EQ(random.rows, cities.size());
+    EXPECT_EQ(random.sampled_pairs, AutoSorter::SAMPLE_SIZE);
+    EXPECT_NEAR(random.ascending_pairs, 0.5, 0.1);
+    EXPECT_NEAR(random.inversions, 0.5, 0.1);
+    EXPECT_GT(random.distinct_keys, random.sampled_rows * 9 / 10);
+    EXPECT_TRUE(random.radix_key);
+
+    InputProfile countries = AutoSorter::profileInput(cities, parseCompositeKey("country"), false);
+    EXPECT_LE(countries.distinct_keys, 40u);
+    EXPECT_TRUE(countries.single_string);
+    EXPECT_FALSE(countries.radix_key);
+
+    std::sort(cities.begin(), cities.end(), TestComparators::byPopulation());
+    InputProfile sorted = AutoSorter::profileInput(cities, parseCompositeKey("population"), false);
+    EXPECT_DOUBLE_EQ(sorted.ascending_pairs, 1.0);
+    EXPECT_DOUBLE_EQ(sorted.inversions, 0.0);
+    InputProfile reversed = AutoSorter::profileInput(cities, parseCompositeKey("population"), true);
+    EXPECT_DOUBLE_EQ(reversed.descending_pairs, 1.0);
+    EXPECT_DOUBLE_EQ(reversed.inversions, 1.0);
+}
+
+TEST_F(AutoSorterTest, ChoosesBySizeOrderAndKey) {
+    std::vector<City> cities = makeRandomCities(20000, 3);
+    EXPECT_EQ(decision_for(cities, "population", false).algorithm, "radix");
+    EXPECT_EQ(decision_for(cities, "name", false).algorithm, "blockquick");
+    EXPECT_EQ(decision_for(cities, "name", false, 8).algorithm, "samplesort");
+    EXPECT_EQ(decision_for(cities, "name", false, 8).threads, 8u);
+    EXPECT_EQ(decision_for(cities, "country", false).algorithm, "multikey"); // 40 distinct values
+    EXPECT_EQ(decision_for(cities, "country,-population", false).algorithm, "blockquick");
+
+    CountryDictionary::encode(cities);
+    EXPECT_EQ(decision_for(cities, "country,-population", false).algorithm, "radix");
+
+    std::sort(cities.begin(), cities.end(), TestComparators::byName());
+    EXPECT_EQ(decision_for(cities, "name", true).algorithm, "tim");
+    AutoDecision in_place = decision_for(cities, "name", false, 8);
+    EXPECT_EQ(in_place.algorithm, "quick");
+    EXPECT_EQ(in_place.threads, 1u);
+    EXPECT_EQ(decision_for(cities, "-name", true).algorithm, "tim");
+
+    for (City& city : cities) {
+        city.population %= 5;
+    }
+    std::shuffle(cities.begin(), cities.end(), std::mt19937(9));
+    EXPECT_EQ(decision_for(cities, "population", true).algorithm, "quick");
+    EXPECT_EQ(decision_for(cities, "population", true, 8).threads, 1u);
+
+    const std::vector<City> few(cities.begin(), cities.begin() + static_cast<long>(AutoSorter::SMALL_INPUT));
+    EXPECT_EQ(decision_for(few, "population", false).algorithm, "insertion");
+}
+
+TEST_F(AutoSorterTest, EveryDecisionSortsCorrectly) {
+    std::vector<City> random = makeRandomCities(6000, 4);
+    std::vector<City> sorted = random;
+    std::sort(sorted.begin(), sorted.end(), TestComparators::byPopulation());
+    for (const std::vector<City>* cities : {&random, &sorted}) {
+        for (const std::string spec : {"population", "-lat", "name", "country", "country,-population"}) {
+            for (unsigned int threads : {1u, 4u}) {
+                sorter_instance.setThreadCount(threads);
+                const CompositeKey keys = parseCompositeKey(spec);
+                CompositeLess less(keys, false);
+                std::vector<City> data = *cities;
+                sorter_instance.sortByKeys(data, keys, false);
+                EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), less))
+                    << spec << " via " << sorter_instance.lastDecision().algorithm;
+
+                Sorter::Permutation order = sorter_instance.sortIndicesByKeys(*cities, keys, false);
+                ASSERT_EQ(order.size(), cities->size());
+                EXPECT_TRUE(std::is_sorted(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+                    return less((*cities)[a], (*cities)[b]);
+                })) << spec << " via " << sorter_instance.lastDecision().algorithm;
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+//
+// Tests for the sorter that forces the block partition on every key.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/block_quick_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"              // Common test utilities
+#include <random>
+
+class BlockQuickSorterTest : public ::testing::Test {
+protected:
+    BlockQuickSorter sorter_instance;
+    SorterTestData test_data_provider;
+};
+
+TEST_F(BlockQuickSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "blockquick");
+}
+
+TEST_F(BlockQuickSorterTest, SortsSmallSamples) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    auto comparator = TestComparators::byName(false);
+    sorter_instance.sort(data, comparator);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), comparator));
+    EXPECT_EQ(data.front().name, "Cairo");
+
+    std::vector<City> empty = test_data_provider.cities_empty;
+    sorter_instance.sortByKey(empty, SortKey::Lat, false);
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(BlockQuickSorterTest, SortsLargeInputsByEveryKey) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coordinate(-180.0, 180.0);
+    std::uniform_int_distribution<long> population(0, 100);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::vector<City> data(30000);
+    for (City& city : data) {
+        city.name = {static_cast<char>(letter(rng)), static_cast<char>(letter(rng))};
+        city.country = std::string(1, static_cast<char>(letter(rng)));
+        city.lat = coordinate(rng);
+        city.lng = coordinate(rng);
+        city.population = population(rng);
+    }
+
+    for (SortKey key : {SortKey::Name, SortKey::Country, SortKey::Population, SortKey::Lat, SortKey::Lng}) {
+        for (bool reverse : {false, true}) {
+            auto comparator = createKeyComparator(key, reverse);
+            std::vector<City> sorted = data;
+            sorter_instance.sortByKey(sorted, key, reverse);
+            EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), comparator)) << sortKeyName(key);
+
+            Sorter::Permutation order = sorter_instance.sortIndicesByKey(data, key, reverse);
+            EXPECT_TRUE(std::is_sorted(order.begin(), order.end(),
+                [&](std::uint32_t a, std::uint32_t b) { return comparator(data[a], data[b]); })) << sortKeyName(key);
+        }
+    }
+}
@@ -117,4 +117,21 @@ TEST_F(BubbleSorterTest, SortsDataWithDuplicatesByPopulation_CheckStability) {
 
     EXPECT_EQ(data[2].name, "CityA");
     EXPECT_EQ(data[2].population, 1000L);
-}
\ No newline at end of file
+}
+
+TEST_F(BubbleSorterTest, SortIndicesLeavesDatasetUntouched) {
+    const std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    auto comparator = TestComparators::byPopulation(true);
+    Sorter::Permutation order = sorter_instance.sortIndices(data, comparator);
+
+    ASSERT_EQ(order.size(), data.size());
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end(),
+        [&](std::uint32_t a, std::uint32_t b) { return comparator(data[a], data[b]); }));
+    EXPECT_EQ(data[order[0]].name, "Tokyo");
+    EXPECT_EQ(data[0].name, test_data_provider.cities_sample_unsorted[0].name);
+
+    std::vector<City> sorted = Sorter::applyPermutation(data, order);
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), comparator));
+
+    EXPECT_TRUE(sorter_instance.sortIndices(test_data_provider.cities_empty, comparator).empty());
+}
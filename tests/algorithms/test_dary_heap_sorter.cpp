@@ -0,0 +1,104 @@
+//
+// Tests for the bottom-up d-ary heapsort.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/dary_heap_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"           // Common test utilities
+#include <memory>
+#include <random>
+
+namespace {
+
+// Counts comparisons and checks that only live (not moved-from) elements are compared.
+struct CountingLess {
+    size_t comparisons = 0;
+    bool operator()(const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) {
+        ++comparisons;
+        EXPECT_TRUE(a && b) << "compared a moved-from element";
+        return *a < *b;
+    }
+};
+
+template <size_t Arity>
+void expect_sorts_like_std_sort(const std::vector<int>& keys) {
+    std::vector<int> actual = keys;
+    std::vector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    auto less = [](int a, int b) { return a < b; };
+    DaryHeapSorter::sortRangeWithArity<Arity>(actual, less);
+    EXPECT_EQ(actual, expected) << "arity " << Arity << " n=" << keys.size();
+}
+
+} // namespace
+
+class DaryHeapSorterTest : public ::testing::Test {
+protected:
+    DaryHeapSorter sorter_instance;
+    SorterTestData test_data_provider;
+};
+
+TEST_F(DaryHeapSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "heap4");
+}
+
+TEST_F(DaryHeapSorterTest, SortsSamplesByEveryKey) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sortByKey(data, SortKey::Population, true);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byPopulation(true)));
+    EXPECT_EQ(data[0].name, "Tokyo");
+
+    data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sort(data, TestComparators::byName());
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byName()));
+    EXPECT_EQ(data[0].name, "Cairo");
+
+    const std::vector<City>& cities = test_data_provider.cities_sample_unsorted;
+    Sorter::Permutation order = sorter_instance.sortIndicesByKey(cities, SortKey::Lat, false);
+    ASSERT_EQ(order.size(), cities.size());
+    for (size_t i = 1; i < order.size(); ++i) {
+        EXPECT_LE(cities[order[i - 1]].lat, cities[order[i]].lat);
+    }
+
+    std::vector<City> empty = test_data_provider.cities_empty;
+    sorter_instance.sort(empty, TestComparators::byName());
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(DaryHeapSorterTest, EveryArityMatchesStdSort) {
+    std::mt19937 rng(23);
+    // Sizes around full and partial last sibling groups for each arity.
+    for (size_t n : {0, 1, 2, 3, 4, 5, 8, 9, 17, 64, 65, 1000, 10007}) {
+        std::vector<int> random_keys(n);
+        for (int& key : random_keys) {
+            key = static_cast<int>(rng() % 97); // many duplicates
+        }
+        std::vector<int> ascending = random_keys;
+        std::sort(ascending.begin(), ascending.end());
+        std::vector<int> descending(ascending.rbegin(), ascending.rend());
+
+        for (const std::vector<int>& keys : {random_keys, ascending, descending}) {
+            expect_sorts_like_std_sort<2>(keys);
+            expect_sorts_like_std_sort<3>(keys);
+            expect_sorts_like_std_sort<4>(keys);
+            expect_sorts_like_std_sort<8>(keys);
+        }
+    }
+}
+
+TEST_F(DaryHeapSorterTest, MovesThroughTheHoleWithoutCopies) {
+    // unique_ptr cannot be copied: the sort must only move, and never compare a hole.
+    std::mt19937 rng(5);
+    std::vector<std::unique_ptr<int>> items;
+    for (int i = 0; i < 5000; ++i) {
+        items.push_back(std::make_unique<int>(static_cast<int>(rng() % 1000)));
+    }
+    CountingLess less;
+    DaryHeapSorter::sortRange(items, less);
+    for (size_t i = 1; i < items.size(); ++i) {
+        ASSERT_LE(*items[i - 1], *items[i]);
+    }
+    // Bottom-up sifting: about (ARITY - 1) log_ARITY(n) compares per element, below the
+    // 2 log2(n) of a top-down binary heap.
+    EXPECT_LT(less.comparisons, 2 * items.size() * 13);
+}
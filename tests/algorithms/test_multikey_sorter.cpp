@@ -0,0 +1,91 @@
+//
+// Tests for the multikey quicksort string sorter.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/multikey_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"           // Common test utilities
+#include <random>
+
+class MultikeySorterTest : public ::testing::Test {
+protected:
+    MultikeySorter sorter_instance;
+    SorterTestData test_data_provider;
+};
+
+TEST_F(MultikeySorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "multikey");
+}
+
+TEST_F(MultikeySorterTest, SortsSampleByNameBothDirections) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sortByKey(data, SortKey::Name, false);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byName(false)));
+    EXPECT_EQ(data.front().name, "Cairo");
+
+    sorter_instance.sortByKey(data, SortKey::Name, true);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byName(true)));
+    EXPECT_EQ(data.front().name, "Tokyo");
+}
+
+TEST_F(MultikeySorterTest, OrdersPrefixesAndBytesLikeStdString) {
+    // Shared prefixes, empty strings, a prefix of another name and non-ASCII (UTF-8) bytes.
+    const std::vector<std::string> names = {
+        "San Jose", "San", "", "Santa Ana", "San José", "Sana'a", "santa", "São Paulo", "San Juan", "Sa",
+        "San Jose", "Z", "Ürümqi", "A", "San Jose del Monte", "Sandakan", "Sana", "San Luis", "S", "Saint-Denis"};
+    std::vector<City> data;
+    for (size_t i = 0; i < names.size() * 5; ++i) { // enough rows to get past the insertion cutoff
+        data.push_back({names[i % names.size()], "Country", 0.0, 0.0, static_cast<long>(i)});
+    }
+
+    Sorter::Permutation order = sorter_instance.sortIndicesByKey(data, SortKey::Name, false);
+    ASSERT_EQ(order.size(), data.size());
+    std::vector<std::string> expected;
+    for (const City& city : data) expected.push_back(city.name);
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < order.size(); ++i) {
+        EXPECT_EQ(data[order[i]].name, expected[i]);
+    }
+
+    Sorter::Permutation sorted_order = order;
+    std::sort(sorted_order.begin(), sorted_order.end());
+    EXPECT_EQ(sorted_order, Sorter::identityPermutation(data.size())); // a true permutation
+}
+
+TEST_F(MultikeySorterTest, MatchesComparatorOnRandomCountries) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> letter('a', 'e');
+    std::uniform_int_distribution<int> length(0, 6);
+    std::vector<City> data(3000);
+    for (City& city : data) {
+        city.country.resize(static_cast<size_t>(length(rng)));
+        for (char& c : city.country) c = static_cast<char>(letter(rng));
+        city.name = city.country;
+    }
+
+    for (bool reverse : {false, true}) {
+        std::vector<City> sorted = data;
+        sorter_instance.sortByKey(sorted, SortKey::Country, reverse);
+        EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), TestComparators::byCountry(reverse)));
+        EXPECT_EQ(sorted.size(), data.size());
+    }
+}
+
+TEST_F(MultikeySorterTest, NumericKeysAndComparatorsFallBack) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sortByKey(data, SortKey::Population, true);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byPopulation(true)));
+
+    data = test_data_provider.cities_sample_unsorted;
+    auto comparator = TestComparators::byLatitude();
+    sorter_instance.sort(data, comparator);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), comparator));
+}
+
+TEST_F(MultikeySorterTest, HandlesEmptyAndSingleElement) {
+    EXPECT_TRUE(sorter_instance.sortIndicesByKey(test_data_provider.cities_empty, SortKey::Name, false).empty());
+    std::vector<City> one = test_data_provider.cities_one;
+    sorter_instance.sortByKey(one, SortKey::Country, true);
+    ASSERT_EQ(one.size(), 1);
+    EXPECT_EQ(one[0].name, "LonelyCity");
+}
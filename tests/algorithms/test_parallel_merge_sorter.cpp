@@ -0,0 +1,79 @@
+//
+// Tests for the parallel merge sorter.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/parallel_merge_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"                 // Common test utilities
+#include <algorithm>
+#include <cstdint>
+
+class ParallelMergeSorterTest : public ::testing::Test {
+protected:
+    ParallelMergeSorter sorter_instance;
+    SorterTestData test_data_provider;
+
+    // Few distinct names and populations: many ties for stability checks.
+    static std::vector<City> make_random_cities(size_t count, unsigned int seed) {
+        RandomCityOptions options;
+        options.distinct_names = 36;
+        options.distinct_populations = 301;
+        return makeRandomCities(count, seed, options);
+    }
+};
+
+TEST_F(ParallelMergeSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "pmerge");
+}
+
+TEST_F(ParallelMergeSorterTest, SortsSmallSamples) {
+    std::vector<City> data = test_data_provider.stability_test_data_population;
+    sorter_instance.setThreadCount(4);
+    sorter_instance.sortByKey(data, SortKey::Population, false);
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0].name, "CityB");
+    EXPECT_EQ(data[1].name, "CityC");
+    EXPECT_EQ(data[2].name, "CityA");
+
+    std::vector<City> empty;
+    sorter_instance.sort(empty, TestComparators::byName());
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(ParallelMergeSorterTest, MatchesStableSortForEveryThreadCount) {
+    const std::vector<City> data = make_random_cities(100000, 3);
+    for (bool reverse : {false, true}) {
+        for (SortKey key : {SortKey::Population, SortKey::Name}) {
+            auto comparator = createKeyComparator(key, reverse);
+            Sorter::Permutation expected = Sorter::identityPermutation(data.size());
+            std::stable_sort(expected.begin(), expected.end(),
+                             [&](std::uint32_t a, std::uint32_t b) { return comparator(data[a], data[b]); });
+
+            for (unsigned int threads : {1u, 2u, 3u, 8u}) {
+                sorter_instance.setThreadCount(threads);
+                std::vector<City> actual = data;
+                sorter_instance.sortByKey(actual, key, reverse);
+                EXPECT_EQ(sorter_instance.sortIndicesByKey(data, key, reverse), expected) << "threads=" << threads;
+                ASSERT_EQ(actual.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    const City& source = data[expected[i]];
+                    ASSERT_EQ(actual[i].name, source.name) << "threads=" << threads << " i=" << i;
+                    ASSERT_EQ(actual[i].lat, source.lat) << "threads=" << threads << " i=" << i;
+                    ASSERT_EQ(actual[i].lng, source.lng) << "threads=" << threads << " i=" << i;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(ParallelMergeSorterTest, CoRankSplitsStableMerge) {
+    const std::vector<int> left = {1, 2, 2, 2, 5, 7};
+    const std::vector<int> right = {0, 2, 2, 3, 7, 8, 9};
+    auto less = [](int a, int b) { return a < b; };
+    // Stable merge, left first on ties: 0 1 2L 2L 2L 2R 2R 3 5 7L 7R 8 9
+    const std::vector<size_t> expected_from_left = {0, 0, 1, 2, 3, 4, 4, 4, 4, 5, 6, 6, 6, 6};
+    for (size_t k = 0; k <= left.size() + right.size(); ++k) {
+        EXPECT_EQ(ParallelMergeSorter::coRank(k, left.data(), left.size(), right.data(), right.size(), less),
+                  expected_from_left[k]) << "k=" << k;
+    }
+}
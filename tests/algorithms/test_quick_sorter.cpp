@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 #include "algorithms/quick_sorter.hpp" // Sorter being tested
 #include "sorter_test_utils.hpp"      // Common test utilities
+#include <random>
 
 // Test fixture for QuickSorter
 class QuickSorterTest : public ::testing::Test {
@@ -65,3 +66,92 @@ TEST_F(QuickSorterTest, SortsReverseSortedByName) {
     EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), comparator));
     if (!data.empty()) EXPECT_EQ(data[0].name, "Cairo");
 }
+
+TEST_F(QuickSorterTest, SortIndicesLeavesDatasetUntouched) {
+    const std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    auto comparator = TestComparators::byPopulation(true);
+    Sorter::Permutation order = sorter_instance.sortIndices(data, comparator);
+
+    ASSERT_EQ(order.size(), data.size());
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end(),
+        [&](std::uint32_t a, std::uint32_t b) { return comparator(data[a], data[b]); }));
+    EXPECT_EQ(data[order[0]].name, "Tokyo");
+    EXPECT_EQ(data[0].name, test_data_provider.cities_sample_unsorted[0].name);
+
+    std::vector<City> sorted = Sorter::applyPermutation(data, order);
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), comparator));
+
+    EXPECT_TRUE(sorter_instance.sortIndices(test_data_provider.cities_empty, comparator).empty());
+}
+
+TEST_F(QuickSorterTest, SortsLargeAdversarialPatterns) {
+    // Sorted, reversed, few-unique and organ-pipe inputs: the old last-element pivot
+    // went quadratic (and O(n) deep) on the first two.
+    const size_t n = 20000;
+    std::vector<City> sorted(n), reversed(n), few_unique(n), organ_pipe(n);
+    for (size_t i = 0; i < n; ++i) {
+        sorted[i].population = static_cast<long>(i);
+        reversed[i].population = static_cast<long>(n - i);
+        few_unique[i].population = static_cast<long>((i * 7919) % 5);
+        organ_pipe[i].population = static_cast<long>(i < n / 2 ? i : n - i);
+    }
+
+    for (bool reverse : {false, true}) {
+        auto comparator = TestComparators::byPopulation(reverse);
+        for (std::vector<City> data : {sorted, reversed, few_unique, organ_pipe}) {
+            sorter_instance.sort(data, comparator);
+            EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), comparator));
+            ASSERT_EQ(data.size(), n);
+        }
+    }
+}
+
+TEST_F(QuickSorterTest, MatchesStdSortOnRandomInput) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<long> population(0, 1000);
+    std::vector<City> data(10000);
+    for (City& city : data) {
+        city.population = population(rng);
+    }
+    std::vector<City> expected = data;
+    auto comparator = TestComparators::byPopulation();
+    std::sort(expected.begin(), expected.end(), comparator);
+
+    sorter_instance.sortByKey(data, SortKey::Population, false);
+    ASSERT_EQ(data.size(), expected.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        EXPECT_EQ(data[i].population, expected[i].population);
+    }
+}
+
+TEST_F(QuickSorterTest, BlockPartitionMatchesBranchyPartition) {
+    static_assert(is_numeric_key_compare<KeyLess<SortKey::Lat, true>>::value, "lat uses the block partition");
+    static_assert(!is_numeric_key_compare<KeyLess<SortKey::Name, false>>::value, "name keeps the branchy partition");
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coordinate(-90.0, 90.0);
+    std::uniform_int_distribution<long> population(0, 20); // heavy duplicates
+    std::vector<City> data(20000);
+    for (City& city : data) {
+        city.lat = coordinate(rng);
+        city.population = population(rng);
+    }
+
+    KeyLess<SortKey::Lat, true> by_lat;
+    std::vector<City> branchy = data;
+    std::vector<City> block = data;
+    QuickSorter::sortRangeWith<false>(branchy, by_lat);
+    QuickSorter::sortRangeWith<true>(block, by_lat);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(block[i].lat, branchy[i].lat) << i;
+    }
+
+    KeyLess<SortKey::Population, false> by_population;
+    branchy = data;
+    block = data;
+    QuickSorter::sortRangeWith<false>(branchy, by_population);
+    QuickSorter::sortRangeWith<true>(block, by_population);
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(block[i].population, branchy[i].population) << i;
+    }
+}
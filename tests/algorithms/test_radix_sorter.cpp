@@ -0,0 +1,121 @@
+//
+// Tests for the LSD radix sorter.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/radix_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"        // Common test utilities
+#include <limits>
+#include <random>
+
+class RadixSorterTest : public ::testing::Test {
+protected:
+    RadixSorter sorter_instance;
+    SorterTestData test_data_provider;
+};
+
+TEST_F(RadixSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "radix");
+}
+
+TEST_F(RadixSorterTest, EncodeKeyPreservesOrder) {
+    const std::vector<long> longs = {std::numeric_limits<long>::min(), -5, -1, 0, 1, 7, std::numeric_limits<long>::max()};
+    for (size_t i = 1; i < longs.size(); ++i) {
+        EXPECT_LT(RadixSorter::encodeKey(longs[i - 1]), RadixSorter::encodeKey(longs[i]));
+    }
+    const std::vector<double> doubles = {-std::numeric_limits<double>::infinity(), -90.5, -1e-300, 0.0, 1e-300, 0.25, 179.99,
+                                         std::numeric_limits<double>::infinity()};
+    for (size_t i = 1; i < doubles.size(); ++i) {
+        EXPECT_LT(RadixSorter::encodeKey(doubles[i - 1]), RadixSorter::encodeKey(doubles[i]));
+    }
+    EXPECT_EQ(RadixSorter::encodeKey(-0.0), RadixSorter::encodeKey(0.0));
+}
+
+TEST_F(RadixSorterTest, SortsByPopulationAscendingAndDescending) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sortByKey(data, SortKey::Population, false);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byPopulation(false)));
+    EXPECT_EQ(data.front().name, "New York");
+
+    sorter_instance.sortByKey(data, SortKey::Population, true);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byPopulation(true)));
+    EXPECT_EQ(data.front().name, "Tokyo");
+}
+
+TEST_F(RadixSorterTest, SortsNegativeCoordinates) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    sorter_instance.sortByKey(data, SortKey::Lng, false);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byLongitude(false)));
+    EXPECT_EQ(data.front().name, "New York");
+
+    sorter_instance.sortByKey(data, SortKey::Lat, true);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), TestComparators::byLatitude(true)));
+}
+
+TEST_F(RadixSorterTest, IsStableInBothDirections) {
+    std::vector<City> data = test_data_provider.stability_test_data_population;
+    sorter_instance.sortByKey(data, SortKey::Population, false);
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0].name, "CityB");
+    EXPECT_EQ(data[1].name, "CityC");
+    EXPECT_EQ(data[2].name, "CityA");
+
+    data = test_data_provider.stability_test_data_population;
+    sorter_instance.sortByKey(data, SortKey::Population, true);
+    EXPECT_EQ(data[0].name, "CityA");
+    EXPECT_EQ(data[1].name, "CityB");
+    EXPECT_EQ(data[2].name, "CityC");
+}
+
+TEST_F(RadixSorterTest, MatchesStableSortOnRandomData) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<long> population(-1000, 1000); // narrow range forces many ties
+    std::uniform_real_distribution<double> coordinate(-180.0, 180.0);
+    std::vector<City> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = {"City" + std::to_string(i), "Country", coordinate(rng), coordinate(rng), population(rng)};
+    }
+
+    for (SortKey key : {SortKey::Population, SortKey::Lat, SortKey::Lng}) {
+        for (bool reverse : {false, true}) {
+            std::vector<City> expected = data;
+            std::stable_sort(expected.begin(), expected.end(), createKeyComparator(key, reverse));
+
+            std::vector<City> actual = data;
+            sorter_instance.sortByKey(actual, key, reverse);
+            Sorter::Permutation order = sorter_instance.sortIndicesByKey(data, key, reverse);
+
+            ASSERT_EQ(actual.size(), expected.size());
+            ASSERT_EQ(order.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_EQ(actual[i].name, expected[i].name);
+                EXPECT_EQ(data[order[i]].name, expected[i].name);
+            }
+        }
+    }
+}
+
+TEST_F(RadixSorterTest, FallsBackToComparisonSortForStringKeys) {
+    std::vector<City> data = test_data_provider.stability_test_data_name;
+    sorter_instance.sortByKey(data, SortKey::Name, false);
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0].country, "CountryX"); // stable: CityA/CountryX stays before CityA/CountryZ
+    EXPECT_EQ(data[1].country, "CountryZ");
+    EXPECT_EQ(data[2].name, "CityB");
+
+    data = test_data_provider.cities_sample_unsorted;
+    auto comparator = TestComparators::byName(true);
+    sorter_instance.sort(data, comparator);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), comparator));
+}
+
+TEST_F(RadixSorterTest, HandlesEmptyAndSingleElement) {
+    std::vector<City> empty = test_data_provider.cities_empty;
+    sorter_instance.sortByKey(empty, SortKey::Population, false);
+    EXPECT_TRUE(empty.empty());
+
+    std::vector<City> one = test_data_provider.cities_one;
+    sorter_instance.sortByKey(one, SortKey::Lat, true);
+    ASSERT_EQ(one.size(), 1);
+    EXPECT_EQ(one[0].name, "LonelyCity");
+}
@@ -0,0 +1,89 @@
+//
+// Tests for the parallel sample sorter.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/sample_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"         // Common test utilities
+#include <algorithm>
+#include <tuple>
+
+class SampleSorterTest : public ::testing::Test {
+protected:
+    SampleSorter sorter_instance;
+    SorterTestData test_data_provider;
+
+    // Populations 0 ... max_population; 512 distinct names, as many as three letters a-h give.
+    static std::vector<City> make_random_cities(size_t count, long max_population, unsigned int seed) {
+        RandomCityOptions options;
+        options.distinct_names = 512;
+        options.distinct_populations = static_cast<size_t>(max_population) + 1;
+        return makeRandomCities(count, seed, options);
+    }
+
+    // Not stable: compare key sequences by equivalence, and check the rows are a permutation.
+    static void expect_sorted_like(const std::vector<City>& actual, const std::vector<City>& input,
+                                   const Sorter::Comparator& comparator) {
+        std::vector<City> expected = input;
+        std::sort(expected.begin(), expected.end(), comparator);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_FALSE(comparator(actual[i], expected[i]) || comparator(expected[i], actual[i])) << "i=" << i;
+        }
+        // Same rows as the input, in any order: compare both under a total order over all fields.
+        auto all_fields = [](const City& a, const City& b) {
+            return std::tie(a.name, a.country, a.population, a.lat, a.lng) <
+                   std::tie(b.name, b.country, b.population, b.lat, b.lng);
+        };
+        std::vector<City> rows = actual;
+        std::sort(rows.begin(), rows.end(), all_fields);
+        std::sort(expected.begin(), expected.end(), all_fields);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            ASSERT_FALSE(all_fields(rows[i], expected[i]) || all_fields(expected[i], rows[i])) << "row " << i;
+        }
+    }
+};
+
+TEST_F(SampleSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "samplesort");
+}
+
+TEST_F(SampleSorterTest, SortsSmallSamples) {
+    std::vector<City> data = test_data_provider.cities_sample_unsorted;
+    auto comparator = TestComparators::byName(false);
+    sorter_instance.setThreadCount(4);
+    sorter_instance.sort(data, comparator);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.end(), comparator));
+
+    std::vector<City> empty = test_data_provider.cities_empty;
+    sorter_instance.sortByKey(empty, SortKey::Population, true);
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(SampleSorterTest, MatchesStdSortForEveryThreadCount) {
+    const std::vector<City> data = make_random_cities(60000, 1000000, 5);
+    for (bool reverse : {false, true}) {
+        for (SortKey key : {SortKey::Population, SortKey::Name}) {
+            auto comparator = createKeyComparator(key, reverse);
+            for (unsigned int threads : {1u, 2u, 3u, 8u}) {
+                sorter_instance.setThreadCount(threads);
+                std::vector<City> actual = data;
+                sorter_instance.sortByKey(actual, key, reverse);
+                expect_sorted_like(actual, data, comparator);
+
+                Sorter::Permutation order = sorter_instance.sortIndicesByKey(data, key, reverse);
+                expect_sorted_like(Sorter::applyPermutation(data, order), data, comparator);
+            }
+        }
+    }
+}
+
+TEST_F(SampleSorterTest, HandlesHeavyDuplicates) {
+    sorter_instance.setThreadCount(4);
+    for (long max_population : {0L, 3L}) { // all equal, and only four distinct keys
+        const std::vector<City> data = make_random_cities(50000, max_population, 9);
+        std::vector<City> actual = data;
+        sorter_instance.sortByKey(actual, SortKey::Population, false);
+        expect_sorted_like(actual, data, createKeyComparator(SortKey::Population, false));
+    }
+}
@@ -0,0 +1,136 @@
+//
+// Tests for the TimSort sorter.
+//
+
+#include "gtest/gtest.h"
+#include "algorithms/tim_sorter.hpp" // Sorter being tested
+#include "sorter_test_utils.hpp"      // Common test utilities
+#include <random>
+
+namespace {
+
+// (key, original position) pairs; only the key is compared, so stability is observable.
+using Tagged = std::pair<int, int>;
+
+struct KeyOnlyLess {
+    bool operator()(const Tagged& a, const Tagged& b) const { return a.first < b.first; }
+};
+
+std::vector<Tagged> tag(const std::vector<int>& keys) {
+    std::vector<Tagged> items;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        items.emplace_back(keys[i], static_cast<int>(i));
+    }
+    return items;
+}
+
+void expect_matches_stable_sort(const std::vector<int>& keys, const std::string& pattern) {
+    std::vector<Tagged> actual = tag(keys);
+    std::vector<Tagged> expected = actual;
+    KeyOnlyLess less;
+    std::stable_sort(expected.begin(), expected.end(), less);
+    TimSorter::sortRange(actual, less);
+    EXPECT_EQ(actual, expected) << pattern << " n=" << keys.size();
+}
+
+} // namespace
+
+class TimSorterTest : public ::testing::Test {
+protected:
+    TimSorter sorter_instance;
+    SorterTestData test_data_provider;
+};
+
+TEST_F(TimSorterTest, GetName) {
+    EXPECT_EQ(sorter_instance.getName(), "tim");
+}
+
+TEST_F(TimSorterTest, SortsSmallSamplesStably) {
+    std::vector<City> data = test_data_provider.stability_test_data_population;
+    sorter_instance.sortByKey(data, SortKey::Population, false);
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0].name, "CityB");
+    EXPECT_EQ(data[1].name, "CityC");
+    EXPECT_EQ(data[2].name, "CityA");
+
+    std::vector<City> empty = test_data_provider.cities_empty;
+    sorter_instance.sort(empty, TestComparators::byName());
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(TimSorterTest, MinRunLength) {
+    EXPECT_EQ(TimSorter::minRunLength(0), 0);
+    EXPECT_EQ(TimSorter::minRunLength(31), 31);
+    EXPECT_EQ(TimSorter::minRunLength(32), 16);
+    EXPECT_EQ(TimSorter::minRunLength(33), 17);
+    EXPECT_EQ(TimSorter::minRunLength(64), 16);
+    EXPECT_EQ(TimSorter::minRunLength(65), 17);
+    for (size_t n : {100, 1000, 44661, 1000000}) {
+        EXPECT_GE(TimSorter::minRunLength(n), TimSorter::MIN_MERGE / 2);
+        EXPECT_LE(TimSorter::minRunLength(n), TimSorter::MIN_MERGE);
+    }
+}
+
+TEST_F(TimSorterTest, MatchesStableSortOnPresortedPatterns) {
+    std::mt19937 rng(17);
+    for (size_t n : {0, 1, 2, 31, 32, 33, 100, 1000, 20000}) {
+        std::vector<int> random_keys(n);
+        for (int& key : random_keys) {
+            key = static_cast<int>(rng() % 64); // many ties, long equal runs after sorting
+        }
+        expect_matches_stable_sort(random_keys, "random");
+
+        std::vector<int> sorted = random_keys;
+        std::sort(sorted.begin(), sorted.end());
+        expect_matches_stable_sort(sorted, "sorted");
+
+        std::vector<int> reversed(sorted.rbegin(), sorted.rend());
+        expect_matches_stable_sort(reversed, "reversed");
+
+        std::vector<int> appended = sorted; // sorted rows plus a few unsorted ones at the end
+        for (size_t i = 0; i < n / 50 + 1; ++i) {
+            appended.push_back(static_cast<int>(rng() % 64));
+        }
+        expect_matches_stable_sort(appended, "appended");
+
+        std::vector<int> runs(n); // interleaved ascending and descending runs of varying length
+        for (size_t i = 0; i < n; ++i) {
+            const size_t block = i / (1 + (i % 7) * 40 + 1);
+            runs[i] = static_cast<int>(block % 2 == 0 ? i % 1000 : 1000 - i % 1000);
+        }
+        expect_matches_stable_sort(runs, "runs");
+
+        std::vector<int> organ_pipe(n);
+        for (size_t i = 0; i < n; ++i) {
+            organ_pipe[i] = static_cast<int>(std::min(i, n - i));
+        }
+        expect_matches_stable_sort(organ_pipe, "organ pipe");
+
+        std::vector<int> swapped = sorted; // sorted with a few random swaps
+        for (size_t i = 0; n > 1 && i < n / 100 + 1; ++i) {
+            std::swap(swapped[rng() % n], swapped[rng() % n]);
+        }
+        expect_matches_stable_sort(swapped, "swapped");
+    }
+}
+
+TEST_F(TimSorterTest, SortsCitiesAndIndicesStably) {
+    std::mt19937 rng(3);
+    std::vector<City> data(5000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i].name = std::string(1, static_cast<char>('a' + rng() % 5));
+        data[i].population = static_cast<long>(rng() % 100);
+        data[i].lat = static_cast<double>(i);
+    }
+    for (bool reverse : {false, true}) {
+        std::vector<City> expected = data;
+        std::stable_sort(expected.begin(), expected.end(), createKeyComparator(SortKey::Population, reverse));
+        std::vector<City> actual = data;
+        sorter_instance.sortByKey(actual, SortKey::Population, reverse);
+        Sorter::Permutation order = sorter_instance.sortIndicesByKey(data, SortKey::Population, reverse);
+        for (size_t i = 0; i < data.size(); ++i) {
+            ASSERT_EQ(actual[i].lat, expected[i].lat);
+            ASSERT_EQ(static_cast<double>(order[i]), expected[i].lat);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+//
+// Tests for the binary columnar CitySnapshot and its use by DatasetLoader.
+//
+
+#include "gtest/gtest.h"
+#include "city_snapshot.hpp"
+#include "dataset_loader.hpp"
+#include <chrono>
+#include <cstdio> // For std::remove
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class CitySnapshotTest : public ::testing::Test {
+protected:
+    const std::string csv_path_ = "test_snapshot_source.csv";
+    const std::string snapshot_path_ = "test_snapshot_source.csv.snap";
+
+    void TearDown() override {
+        std::remove(csv_path_.c_str());
+        std::remove(snapshot_path_.c_str());
+    }
+
+    void writeCsv(const std::string& content) {
+        std::ofstream out(csv_path_, std::ios::binary | std::ios::trunc);
+        out << content;
+    }
+
+    static std::vector<City> sampleCities() {
+        return {
+            {"Tokyo", "Japan", 35.6897, 139.6922, 37435191L},
+            {"", "Nowhere", -1.5, 2.25, 0L},
+            {"Seoul", "Korea, South", 37.56, 126.99, 21794000L}
+        };
+    }
+};
+
+TEST_F(CitySnapshotTest, RoundTripsColumns) {
+    const std::vector<City> cities = sampleCities();
+    const CitySnapshot::SourceInfo source{1234u, 5678};
+    CitySnapshot::write(snapshot_path_, cities, source);
+
+    CitySnapshot snapshot(snapshot_path_);
+    ASSERT_EQ(snapshot.size(), cities.size());
+    EXPECT_TRUE(snapshot.isFreshFor(source));
+    EXPECT_FALSE(snapshot.isFreshFor({1234u, 5679}));
+    EXPECT_EQ(snapshot.name(0), "Tokyo");
+    EXPECT_EQ(snapshot.name(1), "");
+    EXPECT_EQ(snapshot.country(2), "Korea, South");
+    EXPECT_DOUBLE_EQ(snapshot.lat(1), -1.5);
+    EXPECT_DOUBLE_EQ(snapshot.lng(2), 126.99);
+    EXPECT_EQ(snapshot.population(0), 37435191L);
+
+    const std::vector<City> restored = snapshot.toCities();
+    ASSERT_EQ(restored.size(), cities.size());
+    for (size_t i = 0; i < cities.size(); ++i) {
+        EXPECT_EQ(restored[i].name, cities[i].name);
+        EXPECT_EQ(restored[i].country, cities[i].country);
+        EXPECT_EQ(restored[i].population, cities[i].population);
+    }
+}
+
+TEST_F(CitySnapshotTest, RejectsFilesThatAreNotSnapshots) {
+    {
+        std::ofstream out(snapshot_path_, std::ios::binary);
+        out << "this is definitely not a snapshot file, but it is long enough to hold a header";
+    }
+    EXPECT_THROW(CitySnapshot snapshot(snapshot_path_), std::runtime_error);
+    EXPECT_THROW(CitySnapshot missing("missing_snapshot.snap"), std::runtime_error);
+}
+
+TEST_F(CitySnapshotTest, RejectsCorruptSectionsAndOffsets) {
+    // Header fields by byte offset: row_count 16, lat_offset 40, name_offsets_offset 64.
+    const auto corrupt = [this](std::streamoff position, const auto& value) {
+        CitySnapshot::write(snapshot_path_, sampleCities(), {1u, 2});
+        std::fstream file(snapshot_path_, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(position);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    const auto name_offsets_offset = [this] {
+        uint64_t offset = 0;
+        std::ifstream file(snapshot_path_, std::ios::binary);
+        file.seekg(64);
+        file.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+        return static_cast<std::streamoff>(offset);
+    };
+
+    corrupt(40, uint64_t{100}); // lat column not 8-byte aligned
+    EXPECT_THROW(CitySnapshot misaligned(snapshot_path_), std::runtime_error);
+    corrupt(40, ~uint64_t{0} - 7); // offset + rows * 8 wraps around
+    EXPECT_THROW(CitySnapshot wrapped(snapshot_path_), std::runtime_error);
+    corrupt(16, uint64_t{1} << 61); // rows * sizeof(double) overflows
+    EXPECT_THROW(CitySnapshot huge(snapshot_path_), std::runtime_error);
+
+    // A middle name offset past the heap (the last one is still valid).
+    CitySnapshot::write(snapshot_path_, sampleCities(), {1u, 2});
+    const std::streamoff names = name_offsets_offset();
+    corrupt(names + 4, uint32_t{0xFFFFFF00u});
+    EXPECT_THROW(CitySnapshot past_heap(snapshot_path_), std::runtime_error);
+    corrupt(names + 8, uint32_t{0}); // offsets going backwards
+    EXPECT_THROW(CitySnapshot decreasing(snapshot_path_), std::runtime_error);
+
+    CitySnapshot::write(snapshot_path_, sampleCities(), {1u, 2});
+    EXPECT_NO_THROW(CitySnapshot intact(snapshot_path_));
+}
+
+TEST_F(CitySnapshotTest, LoaderUsesFreshSnapshotAndRebuildsStaleOne) {
+    writeCsv("city,city_ascii,lat,lng,country,iso2,iso3,admin_name,capital,population,id\n"
+             "Tokyo,Tokyo,35.6897,139.6922,Japan,JP,JPN,Tokyo,primary,37435191,1\n");
+
+    DatasetLoader first(csv_path_);
+    first.setSnapshotEnabled(true);
+    EXPECT_EQ(first.getSnapshotPath(), snapshot_path_);
+    ASSERT_EQ(first.loadAndParseCities().size(), 1u);
+    EXPECT_FALSE(first.lastLoadUsedSnapshot());
+    ASSERT_TRUE(std::filesystem::exists(snapshot_path_));
+
+    DatasetLoader second(csv_path_);
+    second.setSnapshotEnabled(true);
+    std::vector<City> cached = second.loadAndParseCities();
+    EXPECT_TRUE(second.lastLoadUsedSnapshot());
+    ASSERT_EQ(cached.size(), 1u);
+    EXPECT_EQ(cached[0].name, "Tokyo");
+
+    // Changing the CSV (size and mtime) makes the snapshot stale.
+    writeCsv("city,city_ascii,lat,lng,country,iso2,iso3,admin_name,capital,population,id\n"
+             "Tokyo,Tokyo,35.6897,139.6922,Japan,JP,JPN,Tokyo,primary,37435191,1\n"
+             "Delhi,Delhi,28.6139,77.2090,India,IN,IND,Delhi,admin,29399141,2\n");
+    std::filesystem::last_write_time(csv_path_, std::filesystem::last_write_time(csv_path_) + std::chrono::seconds(5));
+
+    DatasetLoader third(csv_path_);
+    third.setSnapshotEnabled(true);
+    EXPECT_EQ(third.loadAndParseCities().size(), 2u);
+    EXPECT_FALSE(third.lastLoadUsedSnapshot());
+
+    DatasetLoader fourth(csv_path_);
+    fourth.setSnapshotEnabled(true);
+    EXPECT_EQ(fourth.loadAndParseCities().size(), 2u);
+    EXPECT_TRUE(fourth.lastLoadUsedSnapshot());
+}
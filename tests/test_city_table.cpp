@@ -0,0 +1,69 @@
+//
+// Tests for the structure-of-arrays CityTable.
+//
+
+#include "gtest/gtest.h"
+#include "city_table.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+class CityTableTest : public ::testing::Test {
+protected:
+    SorterTestData test_data_provider;
+};
+
+TEST_F(CityTableTest, RoundTripsThroughCities) {
+    const std::vector<City>& cities = test_data_provider.cities_sample_unsorted;
+    CityTable table = CityTable::fromCities(cities);
+    ASSERT_EQ(table.size(), cities.size());
+    EXPECT_EQ(table.names()[1], "Delhi");
+    EXPECT_DOUBLE_EQ(table.lats()[2], 40.7128);
+
+    std::vector<City> restored = table.toCities();
+    ASSERT_EQ(restored.size(), cities.size());
+    for (size_t i = 0; i < cities.size(); ++i) {
+        EXPECT_EQ(restored[i].name, cities[i].name);
+        EXPECT_EQ(restored[i].country, cities[i].country);
+        EXPECT_EQ(restored[i].population, cities[i].population);
+    }
+}
+
+TEST_F(CityTableTest, SortByEveryKeyMatchesStableSortOnCities) {
+    const std::vector<std::pair<SortKey, Sorter::Comparator(*)(bool)>> keys = {
+        {SortKey::Name, TestComparators::byName}, {SortKey::Country, TestComparators::byCountry},
+        {SortKey::Population, TestComparators::byPopulation}, {SortKey::Lat, TestComparators::byLatitude},
+        {SortKey::Lng, TestComparators::byLongitude}
+    };
+    for (const auto& [key, make_comparator] : keys) {
+        for (bool reverse : {false, true}) {
+            std::vector<City> expected = test_data_provider.cities_with_duplicates;
+            std::stable_sort(expected.begin(), expected.end(), make_comparator(reverse));
+
+            CityTable table = CityTable::fromCities(test_data_provider.cities_with_duplicates);
+            table.sortBy(key, reverse);
+            std::vector<City> actual = table.toCities();
+            ASSERT_EQ(actual.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_EQ(actual[i].name, expected[i].name) << sortKeyName(key) << (reverse ? " desc" : " asc");
+                EXPECT_EQ(actual[i].country, expected[i].country) << sortKeyName(key) << (reverse ? " desc" : " asc");
+            }
+        }
+    }
+}
+
+TEST_F(CityTableTest, SortPermutationLeavesTableUntouched) {
+    CityTable table = CityTable::fromCities(test_data_provider.cities_sample_unsorted);
+    std::vector<uint32_t> permutation = table.sortPermutation(SortKey::Population, true);
+    ASSERT_EQ(permutation.size(), table.size());
+    EXPECT_EQ(table.names()[permutation[0]], "Tokyo");
+    EXPECT_EQ(table.names()[0], "Tokyo"); // Unchanged original order
+    EXPECT_EQ(table.names()[1], "Delhi");
+}
+
+TEST_F(CityTableTest, RejectsUnknownKeyAndBadPermutation) {
+    CityTable table = CityTable::fromCities(test_data_provider.cities_sample_unsorted);
+    EXPECT_THROW(table.sortBy(parseSortKey("elevation"), false), std::invalid_argument);
+    EXPECT_THROW(table.applyPermutation({0, 1}), std::invalid_argument);
+}
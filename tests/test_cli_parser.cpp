@@ -76,6 +76,21 @@ TEST_F(CliParserTest, NormalMode_InvalidKey) {
     EXPECT_THROW(CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument);
 }
 
+TEST_F(CliParserTest, NormalMode_CompositeKey) {
+    auto argv_vec = create_argv({"./citysort", "-a", "quick", "-k", "country,-population,name"});
+    ASSERT_NO_THROW({
+        CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data());
+        EXPECT_EQ(parser.getKey(), "country,-population,name");
+    });
+}
+
+TEST_F(CliParserTest, NormalMode_InvalidCompositeKey) {
+    for (const char* key : {"country,", "country,unknown_key", "population,-population"}) {
+        auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", key});
+        EXPECT_THROW(CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument) << key;
+    }
+}
+
 TEST_F(CliParserTest, NormalMode_InvalidNValueNotANumber) {
     auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "-n", "not_a_number"});
     EXPECT_THROW(CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument);
@@ -91,11 +106,91 @@ TEST_F(CliParserTest, NormalMode_InvalidNValueNegative) {
     EXPECT_THROW(CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument);
 }
 
+TEST_F(CliParserTest, NormalMode_ThreadCount) {
+    auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name"});
+    CliParser defaults(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_EQ(defaults.getThreadCount(), 1);
+
+    argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "-j", "8"});
+    CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_EQ(parser.getThreadCount(), 8);
+
+    argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "-j", "0"});
+    EXPECT_THROW(CliParser bad(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument);
+
+    argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "-j"});
+    EXPECT_THROW(CliParser missing(static_cast<int>(argv_vec.size()), argv_vec.data()), std::runtime_error);
+}
+
+TEST_F(CliParserTest, NormalMode_SnapshotFlag) {
+    auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name"});
+    CliParser defaults(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_FALSE(defaults.isSnapshotEnabled());
+
+    argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "--snapshot"});
+    CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(parser.isSnapshotEnabled());
+}
+
+TEST_F(CliParserTest, NormalMode_FullSortFlag) {
+    auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "-n", "10"});
+    CliParser defaults(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_FALSE(defaults.isFullSortMode());
+
+    argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "-n", "10", "--full-sort"});
+    CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(parser.isFullSortMode());
+}
+
 TEST_F(CliParserTest, NormalMode_UnrecognizedArgument) {
     auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", "name", "--unknown-flag"});
     EXPECT_THROW(CliParser parser(static_cast<int>(argv_vec.size()), argv_vec.data()), std::runtime_error);
 }
 
+TEST_F(CliParserTest, ServerModes) {
+    auto argv_vec = create_argv({"./citysort", "--serve", "-j", "4"}); // no -a/-k: queries come from clients
+    CliParser server(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(server.isServeMode());
+    EXPECT_FALSE(server.isClientMode());
+    EXPECT_EQ(server.getSocketPath(), "citysort.sock");
+    EXPECT_EQ(server.getThreadCount(), 4);
+
+    argv_vec = create_argv({"./citysort", "--client", "-k", "population", "-n", "5", "--socket", "/tmp/s.sock"});
+    CliParser client(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(client.isClientMode());
+    EXPECT_TRUE(client.getAlgorithm().empty()); // the server's default
+    EXPECT_EQ(client.getSocketPath(), "/tmp/s.sock");
+
+    argv_vec = create_argv({"./citysort", "--client", "-a", "std"}); // a query needs -k
+    EXPECT_THROW(CliParser missing_key(static_cast<int>(argv_vec.size()), argv_vec.data()), std::runtime_error);
+
+    argv_vec = create_argv({"./citysort", "--load-test", "--requests", "200"});
+    CliParser load(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(load.isLoadTestMode());
+    EXPECT_EQ(load.getRequestCount(), 200);
+
+    argv_vec = create_argv({"./citysort", "--load-test", "--requests", "0"});
+    EXPECT_THROW(CliParser zero(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument);
+    argv_vec = create_argv({"./citysort", "--serve", "--socket"});
+    EXPECT_THROW(CliParser no_path(static_cast<int>(argv_vec.size()), argv_vec.data()), std::runtime_error);
+    argv_vec = create_argv({"./citysort", "--serve", "--client", "-k", "name"});
+    EXPECT_THROW(CliParser both(static_cast<int>(argv_vec.size()), argv_vec.data()), std::invalid_argument);
+}
+
+TEST_F(CliParserTest, CacheFlag) {
+    auto argv_vec = create_argv({"./citysort", "-a", "std", "-k", "population"});
+    CliParser plain(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_FALSE(plain.isCacheEnabled());
+
+    argv_vec = create_argv({"./citysort", "-a", "std", "-k", "population", "-I", "--cache"});
+    CliParser cached(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(cached.isCacheEnabled());
+    EXPECT_TRUE(cached.isIndexSortMode());
+
+    argv_vec = create_argv({"./citysort", "--serve", "--cache"});
+    CliParser server(static_cast<int>(argv_vec.size()), argv_vec.data());
+    EXPECT_TRUE(server.isCacheEnabled());
+}
 
 // --- Tests for Performance Flag ---
 
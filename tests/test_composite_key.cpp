@@ -0,0 +1,214 @@
+//
+// Tests for composite sort keys: parsing, the fused comparator and packed keys.
+//
+
+#include "gtest/gtest.h"
+#include "composite_key.hpp"
+#include "country_dictionary.hpp"
+#include "cli_parser.hpp"
+#include "sorter_factory.hpp"
+#include "top_k.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Few distinct values in every column: many ties, and populations and coordinates of both signs.
+std::vector<City> make_random_cities(size_t count, unsigned int seed) {
+    RandomCityOptions options;
+    options.distinct_names = 9;
+    options.distinct_countries = 3;
+    options.distinct_populations = 41;
+    options.min_population = -20;
+    options.distinct_coordinates = 7;
+    return makeRandomCities(count, seed, options);
+}
+
+// Row order of a stable sort with the composite comparator.
+Sorter::Permutation stable_order(const std::vector<City>& cities, const CompositeKey& keys, bool reverse) {
+    Sorter::Permutation order = Sorter::identityPermutation(cities.size());
+    CompositeLess less(keys, reverse);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return less(cities[a], cities[b]); });
+    return order;
+}
+
+// Same length, and position by position the rows are equal under the composite key.
+void expect_equivalent_order(const std::vector<City>& cities, const Sorter::Permutation& expected,
+                             const Sorter::Permutation& actual, const CompositeLess& less, const std::string& label) {
+    ASSERT_EQ(actual.size(), expected.size()) << label;
+    Sorter::Permutation sorted_rows = actual;
+    std::sort(sorted_rows.begin(), sorted_rows.end());
+    ASSERT_EQ(sorted_rows, Sorter::identityPermutation(cities.size())) << label;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const City& want = cities[expected[i]];
+        const City& got = cities[actual[i]];
+        ASSERT_FALSE(less(want, got) || less(got, want)) << label << " at position " << i;
+    }
+}
+
+const std::vector<std::string> composite_specs = {
+    "country,-population", "country,-population,name", "-population,lat", "name,-lng", "lat,lng,population",
+    "-country,population,-lat,lng,name"
+};
+
+} // namespace
+
+TEST(CompositeKeyTest, ParsesFieldsAndDirections) {
+    CompositeKey keys = parseCompositeKey("country,-population,name");
+    ASSERT_EQ(keys.size(), 3u);
+    EXPECT_EQ(keys[0].key, SortKey::Country);
+    EXPECT_FALSE(keys[0].descending);
+    EXPECT_EQ(keys[1].key, SortKey::Population);
+    EXPECT_TRUE(keys[1].descending);
+    EXPECT_EQ(keys[2].key, SortKey::Name);
+    EXPECT_EQ(compositeKeyName(keys), "country,-population,name");
+
+    for (const auto& name : CliParser::getValidKeys()) {
+        CompositeKey single = parseCompositeKey(name);
+        ASSERT_EQ(single.size(), 1u);
+        EXPECT_EQ(compositeKeyName(single), name);
+    }
+}
+
+TEST(CompositeKeyTest, RejectsMalformedLists) {
+    for (const std::string spec : {"", ",", "country,", ",name", "-", "country,-", "elevation", "name,elevation",
+                                   "name,-name", "--name"}) {
+        EXPECT_THROW(parseCompositeKey(spec), std::invalid_argument) << spec;
+    }
+}
+
+TEST(CompositeKeyTest, LaterFieldsOnlyBreakTies) {
+    City big_a{"Big", "Aland", 0.0, 0.0, 900};
+    City small_a{"Small", "Aland", 0.0, 0.0, 10};
+    City big_b{"Big", "Brazil", 0.0, 0.0, 900};
+    CompositeLess less(parseCompositeKey("country,-population"), false);
+    EXPECT_TRUE(less(big_a, small_a));
+    EXPECT_FALSE(less(small_a, big_a));
+    EXPECT_TRUE(less(small_a, big_b));
+    EXPECT_FALSE(less(big_a, big_a));
+
+    CompositeLess reversed(parseCompositeKey("country,-population"), true);
+    EXPECT_TRUE(reversed(big_b, small_a));
+    EXPECT_TRUE(reversed(small_a, big_a));
+}
+
+TEST(CompositeKeyTest, PacksLeadingFieldsThatFit) {
+    std::vector<City> cities = make_random_cities(500, 3);
+    PackedCompositeKeys uninterned = packCompositeKeys(cities, parseCompositeKey("country,-population"), false);
+    EXPECT_EQ(uninterned.packed_fields, 1u) << "an uninterned country is packed as a string prefix";
+    EXPECT_FALSE(uninterned.tail.empty());
+
+    CountryDictionary::encode(cities);
+    PackedCompositeKeys full = packCompositeKeys(cities, parseCompositeKey("country,-population"), false);
+    EXPECT_EQ(full.packed_fields, 2u);
+    EXPECT_TRUE(full.tail.empty());
+    ASSERT_EQ(full.rows.size(), cities.size());
+
+    PackedCompositeKeys partial = packCompositeKeys(cities, parseCompositeKey("country,-population,name"), false);
+    EXPECT_GE(partial.packed_fields, 2u);
+    EXPECT_FALSE(partial.tail.empty());
+
+    PackedCompositeKeys name_first = packCompositeKeys(cities, parseCompositeKey("name,country"), false);
+    EXPECT_EQ(name_first.packed_fields, 1u) << "a string prefix is the last field packed";
+    EXPECT_FALSE(name_first.tail.empty());
+}
+
+TEST(CompositeKeyTest, StringPrefixKeysFollowByteOrder) {
+    EXPECT_EQ(stringPrefixKey(""), 0u);
+    EXPECT_EQ(stringPrefixKey("A"), std::uint64_t{0x41} << 56);
+    EXPECT_LT(stringPrefixKey("Aachen"), stringPrefixKey("Aalborg"));
+    EXPECT_LT(stringPrefixKey("Zurich"), stringPrefixKey("\xC3\x85land")); // UTF-8 bytes sort above ASCII
+    EXPECT_LT(stringPrefixKey("Abc"), stringPrefixKey("Abcd"));
+    EXPECT_EQ(stringPrefixKey("Santa Cruz de Tenerife"), stringPrefixKey("Santa Cruz de la Sierra"));
+}
+
+TEST(CompositeKeyTest, StringKeysSortOnPrefixesWithSharedPrefixes) {
+    // Long shared prefixes force the full string compare on almost every tie.
+    std::vector<City> cities = make_random_cities(1200, 31);
+    for (City& city : cities) {
+        city.name = "San " + city.name + " del Norte";
+        city.country = "Republic of " + city.country;
+    }
+    for (const std::string algo : {"quick", "merge", "heap", "tim", "std", "radix"}) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo);
+        for (SortKey key : {SortKey::Name, SortKey::Country}) {
+            for (bool reverse : {false, true}) {
+                const CompositeKey keys{{key, false}};
+                expect_equivalent_order(cities, stable_order(cities, keys, reverse),
+                                        sorter->sortIndicesByKey(cities, key, reverse), CompositeLess(keys, reverse),
+                                        algo + " " + sortKeyName(key));
+                std::vector<City> sorted = cities;
+                sorter->sortByKey(sorted, key, reverse);
+                EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), createKeyComparator(key, reverse))) << algo;
+            }
+        }
+    }
+}
+
+TEST(CompositeKeyTest, PackedKeysFollowTheCompositeOrder) {
+    std::vector<City> cities = make_random_cities(2000, 5);
+    CountryDictionary::encode(cities);
+    for (const std::string& spec : composite_specs) {
+        const CompositeKey keys = parseCompositeKey(spec);
+        for (bool reverse : {false, true}) {
+            PackedCompositeKeys packed = packCompositeKeys(cities, keys, reverse);
+            if (packed.packed_fields == 0) {
+                continue;
+            }
+            PackedRowTailLess less{cities, packed.tail};
+            std::stable_sort(packed.rows.begin(), packed.rows.end(), less);
+            expect_equivalent_order(cities, stable_order(cities, keys, reverse), packedRowIndices(packed.rows),
+                                    CompositeLess(keys, reverse), spec);
+        }
+    }
+}
+
+TEST(CompositeKeyTest, EverySorterMatchesAStableCompositeSort) {
+    std::vector<City> cities = make_random_cities(1500, 8);
+    CountryDictionary::encode(cities);
+    for (const std::string& algo : CliParser::getValidAlgorithms()) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo);
+        for (const std::string& spec : composite_specs) {
+            const CompositeKey keys = parseCompositeKey(spec);
+            for (bool reverse : {false, true}) {
+                const std::string label = algo + " " + spec + (reverse ? " -r" : "");
+                const Sorter::Permutation expected = stable_order(cities, keys, reverse);
+                const CompositeLess less(keys, reverse);
+
+                expect_equivalent_order(cities, expected, sorter->sortIndicesByKeys(cities, keys, reverse), less,
+                                        label + " [index]");
+
+                std::vector<City> sorted = cities;
+                sorter->sortByKeys(sorted, keys, reverse);
+                ASSERT_EQ(sorted.size(), cities.size()) << label;
+                for (size_t i = 0; i < sorted.size(); ++i) {
+                    const City& want = cities[expected[i]];
+                    ASSERT_FALSE(less(want, sorted[i]) || less(sorted[i], want)) << label << " at position " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(CompositeKeyTest, SingleFieldMatchesSortByKey) {
+    const std::vector<City> cities = make_random_cities(800, 13);
+    std::unique_ptr<Sorter> sorter = SorterFactory::createSorter("merge");
+    EXPECT_EQ(sorter->sortIndicesByKeys(cities, parseCompositeKey("-population"), false),
+              sorter->sortIndicesByKey(cities, SortKey::Population, true));
+    EXPECT_EQ(sorter->sortIndicesByKeys(cities, parseCompositeKey("-population"), true),
+              sorter->sortIndicesByKey(cities, SortKey::Population, false));
+}
+
+TEST(CompositeKeyTest, TopKMatchesStableSortPrefix) {
+    const std::vector<City> cities = make_random_cities(3000, 17);
+    for (TopKStrategy strategy : {TopKStrategy::Heap, TopKStrategy::NthElement}) {
+        for (const std::string& spec : composite_specs) {
+            const CompositeKey keys = parseCompositeKey(spec);
+            Sorter::Permutation expected = stable_order(cities, keys, false);
+            expected.resize(25);
+            EXPECT_EQ(selectTopK(cities, keys, false, 25, strategy), expected) << spec;
+        }
+    }
+}
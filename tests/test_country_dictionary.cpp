@@ -0,0 +1,69 @@
+//
+// Tests for the dictionary-encoded country column.
+//
+
+#include "gtest/gtest.h"
+#include "country_dictionary.hpp"
+#include "city_table.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    std::vector<City> countryCities() {
+        return {
+            {"A", "Japan", 0.0, 0.0, 1L},
+            {"B", "India", 0.0, 0.0, 2L},
+            {"C", "Japan", 0.0, 0.0, 3L},
+            {"D", "Korea, South", 0.0, 0.0, 4L},
+            {"E", "Egypt", 0.0, 0.0, 5L}
+        };
+    }
+}
+
+TEST(CountryDictionaryTest, AssignsCodesInSortedOrder) {
+    std::vector<City> cities = countryCities();
+    CountryDictionary dictionary = CountryDictionary::encode(cities);
+    ASSERT_EQ(dictionary.size(), 4u);
+
+    EXPECT_EQ(dictionary.codeOf("Egypt"), 1);
+    EXPECT_EQ(dictionary.codeOf("India"), 2);
+    EXPECT_EQ(dictionary.codeOf("Japan"), 3);
+    EXPECT_EQ(dictionary.codeOf("Korea, South"), 4);
+    EXPECT_EQ(dictionary.codeOf("Atlantis"), CountryDictionary::UNASSIGNED);
+    EXPECT_EQ(dictionary.nameOf(3), "Japan");
+    EXPECT_THROW((void)dictionary.nameOf(CountryDictionary::UNASSIGNED), std::out_of_range);
+
+    EXPECT_EQ(cities[0].country_code, cities[2].country_code);
+    for (const City& a : cities) {
+        for (const City& b : cities) {
+            EXPECT_EQ(a.country_code < b.country_code, a.country < b.country);
+        }
+    }
+}
+
+TEST(CountryDictionaryTest, CopiesStayUsable) {
+    std::vector<City> cities = countryCities();
+    CountryDictionary copy;
+    {
+        CountryDictionary original = CountryDictionary::build(cities);
+        copy = original;
+    }
+    EXPECT_EQ(copy.codeOf("India"), 2);
+    EXPECT_EQ(cities[0].country_code, CountryDictionary::UNASSIGNED); // build() leaves cities alone
+}
+
+TEST(CountryDictionaryTest, CityTableSortsByCountryCode) {
+    CityTable table = CityTable::fromCities(countryCities());
+    EXPECT_EQ(table.countryDictionary().size(), 4u);
+    table.sortBy(SortKey::Country, false);
+    std::vector<City> sorted = table.toCities();
+    ASSERT_EQ(sorted.size(), 5u);
+    EXPECT_EQ(sorted[0].country, "Egypt");
+    EXPECT_EQ(sorted[1].country, "India");
+    EXPECT_EQ(sorted[2].name, "A"); // Stable among the two Japan rows
+    EXPECT_EQ(sorted[3].name, "C");
+    EXPECT_EQ(sorted[4].country, "Korea, South");
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(),
+                               [](const City& a, const City& b) { return a.country_code < b.country_code; }));
+}
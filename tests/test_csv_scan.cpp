@@ -0,0 +1,97 @@
+//
+// Tests for the vectorized CSV scanning kernels and CsvReader's Simd backend.
+//
+
+#include "gtest/gtest.h"
+#include "csv_scan.hpp"
+#include "csv_parser.hpp"
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio> // For std::remove
+
+namespace {
+    std::vector<uint32_t> referenceOffsets(const std::string& data, char delimiter) {
+        std::vector<uint32_t> offsets;
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (data[i] == delimiter || data[i] == '"' || data[i] == '\n') {
+                offsets.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return offsets;
+    }
+
+    // Restores the auto-detected kernel after each test.
+    class CsvScanTest : public ::testing::Test {
+    protected:
+        csv_scan::Kernel saved_ = csv_scan::activeKernel();
+        void TearDown() override { csv_scan::setKernel(saved_); }
+    };
+}
+
+TEST_F(CsvScanTest, AllSupportedKernelsMatchReference) {
+    std::mt19937 rng(7);
+    const std::string alphabet = "abc,;\"\n 0123";
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+    for (size_t length : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 100u, 1000u}) {
+        std::string data(length, ' ');
+        for (char& c : data) {
+            c = alphabet[pick(rng)];
+        }
+        for (char delimiter : {',', ';'}) {
+            const std::vector<uint32_t> expected = referenceOffsets(data, delimiter);
+            for (csv_scan::Kernel kernel : {csv_scan::Kernel::Scalar, csv_scan::Kernel::Sse2, csv_scan::Kernel::Avx2}) {
+                if (!csv_scan::setKernel(kernel)) {
+                    continue;
+                }
+                std::vector<uint32_t> offsets;
+                EXPECT_EQ(csv_scan::scanStructural(data, delimiter, offsets), expected.size());
+                EXPECT_EQ(offsets, expected) << csv_scan::kernelName(kernel) << " length " << length;
+
+                const char* first = csv_scan::findStructural(data.data(), data.data() + data.size(), delimiter);
+                const size_t expected_first = expected.empty() ? data.size() : expected.front();
+                EXPECT_EQ(static_cast<size_t>(first - data.data()), expected_first) << csv_scan::kernelName(kernel);
+            }
+        }
+    }
+}
+
+TEST_F(CsvScanTest, ScalarKernelIsAlwaysSupported) {
+    EXPECT_TRUE(csv_scan::isSupported(csv_scan::Kernel::Scalar));
+    EXPECT_TRUE(csv_scan::setKernel(csv_scan::Kernel::Scalar));
+    EXPECT_EQ(csv_scan::activeKernel(), csv_scan::Kernel::Scalar);
+    EXPECT_EQ(csv_scan::kernelName(csv_scan::Kernel::Scalar), "scalar");
+}
+
+TEST_F(CsvScanTest, CsvReaderSimdBackendMatchesScalar) {
+    const std::string content =
+        "col1,col2,col3\n"
+        "\"Smith, John\",\"A person, with a comma\",plain\n"
+        "1,\"Hello, \"\"World\"\"!\",\"\"\n"
+        "a\"b,\"x\"y\",z\"\n"
+        ",,\n"
+        "\"a very long quoted field that spans more than thirty-two bytes, with commas\",tail\n"
+        "\n"
+        "last,row";
+    const std::string filename = "test_csv_scan_backend.csv";
+    {
+        std::ofstream outfile(filename, std::ios::binary);
+        outfile << content;
+    }
+
+    CsvReader scalar_reader(filename, ',', CsvReader::ParseBackend::Scalar);
+    CsvReader simd_reader(filename, ',', CsvReader::ParseBackend::Simd);
+    CsvRow scalar_row;
+    CsvRow simd_row;
+    size_t rows = 0;
+    while (scalar_reader.readRow(scalar_row)) {
+        ASSERT_TRUE(simd_reader.readRow(simd_row));
+        EXPECT_EQ(simd_row, scalar_row) << "row " << rows;
+        ++rows;
+    }
+    EXPECT_FALSE(simd_reader.readRow(simd_row));
+    EXPECT_EQ(rows, 8u);
+    std::remove(filename.c_str());
+}
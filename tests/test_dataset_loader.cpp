@@ -127,4 +127,111 @@ TEST_F(DatasetLoaderTest, HandleFileWithOnlyHeader) {
     DatasetLoader loader(filename);
     std::vector<City> cities = loader.loadAndParseCities();
     EXPECT_TRUE(cities.empty());
-}
\ No newline at end of file
+}
+TEST_F(DatasetLoaderTest, StreamAndMmapBackendsAgree) {
+    std::string content =
+        "\"city\",\"city_ascii\",\"lat\",\"lng\",\"country\",\"iso2\",\"iso3\",\"admin_name\",\"capital\",\"population\",\"id\"\n"
+        "\"Tokyo\",\"Tokyo\",\"35.6897\",\"139.6922\",\"Japan\",\"JP\",\"JPN\",\"Tōkyō\",\"primary\",\"37435191\",\"1392685764\"\n"
+        "\"Seoul\",\"Seoul\",\"37.5600\",\"126.9900\",\"Korea, South\",\"KR\",\"KOR\",\"Seoul\",\"primary\",\"21794000\",\"1410836482\"\n"
+        "\"Quote\",\"Say \"\"Hi\"\"\",\"1.0\",\"2.0\",\"X\",\"XX\",\"XXX\",\"\",\"\",\"10\",\"1\"\n"
+        "\"NoPop\",\"NoPop\",\"1.0\",\"2.0\",\"X\",\"XX\",\"XXX\",\"\",\"\",\"\",\"2\"\n";
+    std::string filename = make_temp_file(content);
+
+    std::vector<City> from_stream = DatasetLoader(filename, DatasetLoader::CsvBackend::Stream).loadAndParseCities();
+    std::vector<City> from_mmap = DatasetLoader(filename, DatasetLoader::CsvBackend::Mmap).loadAndParseCities();
+
+    ASSERT_EQ(from_stream.size(), 3);
+    ASSERT_EQ(from_mmap.size(), from_stream.size());
+    for (size_t i = 0; i < from_stream.size(); ++i) {
+        EXPECT_EQ(from_mmap[i].name, from_stream[i].name);
+        EXPECT_EQ(from_mmap[i].country, from_stream[i].country);
+        EXPECT_DOUBLE_EQ(from_mmap[i].lat, from_stream[i].lat);
+        EXPECT_DOUBLE_EQ(from_mmap[i].lng, from_stream[i].lng);
+        EXPECT_EQ(from_mmap[i].population, from_stream[i].population);
+    }
+    EXPECT_EQ(from_mmap[1].country, "Korea, South");
+    EXPECT_EQ(from_mmap[2].name, "Say \"Hi\"");
+}
+
+TEST_F(DatasetLoaderTest, ParallelLoadMatchesSequentialOrderAndSkips) {
+    std::string content = "city,city_ascii,lat,lng,country,iso2,iso3,admin_name,capital,population,id\n";
+    for (int i = 0; i < 500; ++i) {
+        std::string name = "City" + std::to_string(i);
+        std::string population = (i % 7 == 0) ? "" : std::to_string(1000 + i); // Missing population
+        std::string lat = (i % 11 == 0) ? "bad" : "10.5";                        // Invalid latitude
+        content += name + ",\"" + name + "\",\"" + lat + "\",20.25,\"Country\nwith newline\",C,CCC,\"Adm, \"\"x\"\"\",," + population + "," + std::to_string(i) + "\n";
+    }
+    std::string filename = make_temp_file(content);
+
+    DatasetLoader sequential_loader(filename);
+    std::vector<City> sequential = sequential_loader.loadAndParseCities();
+
+    for (unsigned int threads : {2u, 4u, 13u}) {
+        DatasetLoader parallel_loader(filename);
+        parallel_loader.setThreadCount(threads);
+        EXPECT_EQ(parallel_loader.getThreadCount(), threads);
+        std::vector<City> parallel = parallel_loader.loadAndParseCities();
+
+        ASSERT_EQ(parallel.size(), sequential.size());
+        for (size_t i = 0; i < parallel.size(); ++i) {
+            EXPECT_EQ(parallel[i].name, sequential[i].name);
+            EXPECT_EQ(parallel[i].country, "Country\nwith newline");
+            EXPECT_EQ(parallel[i].population, sequential[i].population);
+        }
+    }
+    // Rows divisible by 7 (no population) or by 11 (bad lat) are skipped.
+    size_t expected = 0;
+    for (int i = 0; i < 500; ++i) {
+        expected += (i % 7 != 0 && i % 11 != 0) ? 1 : 0;
+    }
+    EXPECT_EQ(sequential.size(), expected);
+}
+
+TEST_F(DatasetLoaderTest, CountsSkippedRowsPerReason) {
+    std::string content =
+        "city,city_ascii,lat,lng,country,iso2,iso3,admin_name,capital,population,id\n"
+        "Valid,Valid,10.0,20.0,A,AA,AAA,,,1000,1\n"
+        "NoPop,NoPop,10.0,20.0,A,AA,AAA,,,,2\n"
+        "BadPop,BadPop,10.0,20.0,A,AA,AAA,,,abc,3\n"
+        "HugePop,HugePop,10.0,20.0,A,AA,AAA,,,99999999999999999999999,4\n"
+        "NoLat,NoLat,,20.0,A,AA,AAA,,,1000,5\n"
+        "BadLng,BadLng,10.0,xyz,A,AA,AAA,,,1000,6\n"
+        "Short,Short,1.0\n";
+    std::string filename = make_temp_file(content);
+
+    for (auto backend : {DatasetLoader::CsvBackend::Stream, DatasetLoader::CsvBackend::Mmap}) {
+        DatasetLoader loader(filename, backend);
+        std::vector<City> cities = loader.loadAndParseCities();
+        ASSERT_EQ(cities.size(), 1);
+
+        const DatasetLoader::LoadStats& stats = loader.getLastLoadStats();
+        using Reason = DatasetLoader::SkipReason;
+        EXPECT_EQ(stats.loaded, 1u);
+        EXPECT_EQ(stats.totalSkipped(), 6u);
+        EXPECT_EQ(stats.skipped[static_cast<size_t>(Reason::MissingPopulation)], 1u);
+        EXPECT_EQ(stats.skipped[static_cast<size_t>(Reason::InvalidPopulation)], 1u);
+        EXPECT_EQ(stats.skipped[static_cast<size_t>(Reason::PopulationOutOfRange)], 1u);
+        EXPECT_EQ(stats.skipped[static_cast<size_t>(Reason::MissingCoordinates)], 1u);
+        EXPECT_EQ(stats.skipped[static_cast<size_t>(Reason::InvalidCoordinates)], 1u);
+        EXPECT_EQ(stats.skipped[static_cast<size_t>(Reason::TooFewColumns)], 1u);
+        EXPECT_EQ(stats.summary(),
+                  "Skipped 6 rows (too few columns: 1, missing population: 1, invalid population: 1, "
+                  "population out of range: 1, missing lat/lng: 1, invalid lat/lng: 1).");
+    }
+}
+
+TEST_F(DatasetLoaderTest, InternsCountries) {
+    std::string content =
+        "city,city_ascii,lat,lng,country,iso2,iso3,admin_name,capital,population,id\n"
+        "Tokyo,Tokyo,35.6897,139.6922,Japan,JP,JPN,Tokyo,primary,37435191,1\n"
+        "Delhi,Delhi,28.6139,77.2090,India,IN,IND,Delhi,admin,29399141,2\n"
+        "Osaka,Osaka,34.6936,135.5019,Japan,JP,JPN,Osaka,admin,19222665,3\n";
+    std::string filename = make_temp_file(content);
+    DatasetLoader loader(filename);
+    std::vector<City> cities = loader.loadAndParseCities();
+    ASSERT_EQ(cities.size(), 3);
+    EXPECT_EQ(loader.getCountryDictionary().size(), 2u);
+    EXPECT_EQ(cities[0].country_code, loader.getCountryDictionary().codeOf("Japan"));
+    EXPECT_EQ(cities[0].country_code, cities[2].country_code);
+    EXPECT_LT(cities[1].country_code, cities[0].country_code); // India < Japan
+}
@@ -0,0 +1,107 @@
+//
+// Tests for the external merge sorter.
+//
+
+#include "gtest/gtest.h"
+#include "external_sorter.hpp"
+#include "algorithms/merge_sorter.hpp"
+#include "algorithms/quick_sorter.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+
+class ExternalSorterTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir_;
+
+    void SetUp() override {
+        temp_dir_ = std::filesystem::temp_directory_path() /
+                    ("citysort_external_test_" + std::to_string(std::random_device{}()));
+        std::filesystem::create_directories(temp_dir_);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(temp_dir_, ec);
+    }
+
+    // Population ties for stability; names of varying length, some past the small-string buffer.
+    static std::vector<City> make_random_cities(size_t count, unsigned int seed) {
+        RandomCityOptions options;
+        options.distinct_countries = 50;
+        options.distinct_populations = 501;
+        options.max_name_padding = 19;
+        return makeRandomCities(count, seed, options);
+    }
+
+    size_t files_in_temp_dir() const {
+        return static_cast<size_t>(std::distance(std::filesystem::directory_iterator(temp_dir_),
+                                                 std::filesystem::directory_iterator()));
+    }
+};
+
+TEST_F(ExternalSorterTest, MatchesStableSortAcrossRunsAndMergePasses) {
+    // At 1 MiB a chunk holds ~2.7k cities and 15 runs are merged at once: 60k cities
+    // need 22 runs, so an intermediate merge pass is needed as well.
+    const std::vector<City> data = make_random_cities(60000, 2);
+    MergeSorter chunk_sorter;
+    for (bool reverse : {false, true}) {
+        std::vector<City> expected = data;
+        std::stable_sort(expected.begin(), expected.end(), createKeyComparator(SortKey::Population, reverse));
+
+        ExternalSorter sorter(chunk_sorter, SortKey::Population, reverse, ExternalSorter::MIN_MEMORY_BUDGET, temp_dir_.string());
+        for (const City& city : data) {
+            sorter.add(city);
+        }
+        const ExternalSorter::Stats& stats = sorter.finish();
+        EXPECT_EQ(stats.rows, data.size());
+        EXPECT_GT(stats.initial_runs, stats.max_fan_in);
+        EXPECT_EQ(stats.merge_passes, 1);
+
+        City city;
+        for (const City& want : expected) {
+            ASSERT_TRUE(sorter.next(city));
+            ASSERT_EQ(city.lat, want.lat);
+            ASSERT_EQ(city.name, want.name);
+            ASSERT_EQ(city.country, want.country);
+            ASSERT_EQ(city.population, want.population);
+            ASSERT_EQ(city.lng, want.lng);
+        }
+        EXPECT_FALSE(sorter.next(city));
+    }
+    EXPECT_EQ(files_in_temp_dir(), 0); // run files removed by the destructor
+}
+
+TEST_F(ExternalSorterTest, SortsSmallInputsInMemory) {
+    const std::vector<City> data = make_random_cities(500, 3);
+    QuickSorter chunk_sorter;
+    ExternalSorter sorter(chunk_sorter, SortKey::Name, false, ExternalSorter::MIN_MEMORY_BUDGET, temp_dir_.string());
+    for (const City& city : data) {
+        sorter.add(city);
+    }
+    EXPECT_EQ(sorter.finish().initial_runs, 0);
+    EXPECT_EQ(files_in_temp_dir(), 0);
+
+    std::vector<City> output;
+    City city;
+    while (sorter.next(city)) {
+        output.push_back(city);
+    }
+    ASSERT_EQ(output.size(), data.size());
+    EXPECT_TRUE(std::is_sorted(output.begin(), output.end(), createKeyComparator(SortKey::Name, false)));
+}
+
+TEST_F(ExternalSorterTest, EnforcesBudgetAndCallOrder) {
+    QuickSorter chunk_sorter;
+    EXPECT_THROW(ExternalSorter(chunk_sorter, SortKey::Lat, false, ExternalSorter::MIN_MEMORY_BUDGET - 1), std::invalid_argument);
+
+    ExternalSorter sorter(chunk_sorter, SortKey::Lat, false, ExternalSorter::MIN_MEMORY_BUDGET, temp_dir_.string());
+    EXPECT_LE(sorter.getChunkRowCapacity() * sizeof(City), ExternalSorter::MIN_MEMORY_BUDGET / 4);
+    City city;
+    EXPECT_THROW(sorter.next(city), std::runtime_error);
+    sorter.finish();
+    EXPECT_FALSE(sorter.next(city));
+    EXPECT_THROW(sorter.add(city), std::runtime_error);
+}
@@ -0,0 +1,50 @@
+//
+// Tests for the non-throwing numeric field decoders.
+//
+
+#include "gtest/gtest.h"
+#include "field_decoder.hpp"
+#include <limits>
+#include <string>
+
+TEST(FieldDecoderTest, DecodesLongs) {
+    long value = 0;
+    EXPECT_EQ(decodeLong("37435191", value), DecodeStatus::Ok);
+    EXPECT_EQ(value, 37435191L);
+    EXPECT_EQ(decodeLong("  -42 ", value), DecodeStatus::Ok);
+    EXPECT_EQ(value, -42L);
+    EXPECT_EQ(decodeLong("+7", value), DecodeStatus::Ok);
+    EXPECT_EQ(value, 7L);
+}
+
+TEST(FieldDecoderTest, RejectsBadLongsWithoutTouchingOutput) {
+    long value = 123;
+    EXPECT_EQ(decodeLong("", value), DecodeStatus::Empty);
+    EXPECT_EQ(decodeLong("   ", value), DecodeStatus::Empty);
+    EXPECT_EQ(decodeLong("NOT_A_NUMBER", value), DecodeStatus::Invalid);
+    EXPECT_EQ(decodeLong("12abc", value), DecodeStatus::Invalid);
+    EXPECT_EQ(decodeLong("1.5", value), DecodeStatus::Invalid);
+    EXPECT_EQ(decodeLong("99999999999999999999999", value), DecodeStatus::OutOfRange);
+    EXPECT_EQ(value, 123L);
+}
+
+TEST(FieldDecoderTest, DecodesDoubles) {
+    double value = 0.0;
+    EXPECT_EQ(decodeDouble("35.6897", value), DecodeStatus::Ok);
+    EXPECT_DOUBLE_EQ(value, 35.6897);
+    EXPECT_EQ(decodeDouble("-139.6922", value), DecodeStatus::Ok);
+    EXPECT_DOUBLE_EQ(value, -139.6922);
+    EXPECT_EQ(decodeDouble("1e2", value), DecodeStatus::Ok);
+    EXPECT_DOUBLE_EQ(value, 100.0);
+    EXPECT_EQ(decodeDouble(" 12 ", value), DecodeStatus::Ok);
+    EXPECT_DOUBLE_EQ(value, 12.0);
+}
+
+TEST(FieldDecoderTest, RejectsBadDoubles) {
+    double value = 1.0;
+    EXPECT_EQ(decodeDouble("", value), DecodeStatus::Empty);
+    EXPECT_EQ(decodeDouble("NOT_LAT", value), DecodeStatus::Invalid);
+    EXPECT_EQ(decodeDouble("1.2.3", value), DecodeStatus::Invalid);
+    EXPECT_EQ(decodeDouble("1e999", value), DecodeStatus::OutOfRange);
+    EXPECT_DOUBLE_EQ(value, 1.0);
+}
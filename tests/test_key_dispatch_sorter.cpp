@@ -0,0 +1,66 @@
+//
+// Tests that the statically dispatched key path agrees with the std::function path.
+//
+
+#include "gtest/gtest.h"
+#include "sorter_factory.hpp"
+#include "sorter.hpp"
+#include "sort_key.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <memory>
+
+namespace {
+
+// Few distinct values per column, so both paths must agree on many ties.
+std::vector<City> make_dispatch_test_cities(size_t count) {
+    RandomCityOptions options;
+    options.distinct_names = 64;
+    options.distinct_countries = 4;
+    options.distinct_populations = 51;
+    return makeRandomCities(count, 1234, options);
+}
+
+} // namespace
+
+TEST(KeyDispatchSorterTest, KeyLessMatchesRuntimeComparator) {
+    const std::vector<City> cities = make_dispatch_test_cities(40);
+    for (const City& a : cities) {
+        for (const City& b : cities) {
+            EXPECT_EQ((KeyLess<SortKey::Name, false>{}(a, b)), createKeyComparator(SortKey::Name, false)(a, b));
+            EXPECT_EQ((KeyLess<SortKey::Country, true>{}(a, b)), createKeyComparator(SortKey::Country, true)(a, b));
+            EXPECT_EQ((KeyLess<SortKey::Population, true>{}(a, b)), createKeyComparator(SortKey::Population, true)(a, b));
+            EXPECT_EQ((KeyLess<SortKey::Lat, false>{}(a, b)), createKeyComparator(SortKey::Lat, false)(a, b));
+            EXPECT_EQ((KeyLess<SortKey::Lng, true>{}(a, b)), createKeyComparator(SortKey::Lng, true)(a, b));
+        }
+    }
+}
+
+TEST(KeyDispatchSorterTest, SortByKeyMatchesComparatorPathForEveryKeyAndDirection) {
+    const std::vector<City> cities = make_dispatch_test_cities(300);
+    for (const std::string algo_name : {"bubble", "insertion", "merge", "quick", "heap", "std"}) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(algo_name);
+        for (SortKey key : {SortKey::Name, SortKey::Country, SortKey::Population, SortKey::Lat, SortKey::Lng}) {
+            for (bool reverse : {false, true}) {
+                auto comparator = createKeyComparator(key, reverse);
+
+                std::vector<City> by_function = cities;
+                sorter->sort(by_function, comparator);
+                std::vector<City> by_key = cities;
+                sorter->sortByKey(by_key, key, reverse);
+                Sorter::Permutation order = sorter->sortIndicesByKey(cities, key, reverse);
+
+                // Same key sequence. Ties may be ordered differently by unstable sorters, since
+                // the key path can pick a different partition kernel (see QuickSorter).
+                ASSERT_EQ(by_key.size(), by_function.size());
+                ASSERT_EQ(order.size(), by_function.size());
+                for (size_t i = 0; i < by_key.size(); ++i) {
+                    EXPECT_FALSE(comparator(by_key[i], by_function[i]) || comparator(by_function[i], by_key[i]))
+                        << algo_name << " " << sortKeyName(key) << " at " << i;
+                }
+                EXPECT_TRUE(std::is_sorted(by_key.begin(), by_key.end(), comparator));
+                EXPECT_TRUE(std::is_sorted(order.begin(), order.end(),
+                    [&](std::uint32_t a, std::uint32_t b) { return comparator(cities[a], cities[b]); }));
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+//
+// Tests for the loser tree used by the external merge.
+//
+
+#include "gtest/gtest.h"
+#include "loser_tree.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Merges sorted (key, tag) runs, ties by run index, and returns the output sequence.
+std::vector<std::pair<int, int>> merge_runs(const std::vector<std::vector<std::pair<int, int>>>& runs) {
+    std::vector<size_t> position(runs.size(), 0);
+    auto head = [&](size_t run) {
+        return position[run] < runs[run].size() ? runs[run][position[run]].first : std::numeric_limits<int>::max();
+    };
+    auto beats = [&](size_t a, size_t b) {
+        const bool a_live = position[a] < runs[a].size();
+        const bool b_live = position[b] < runs[b].size();
+        if (a_live != b_live) {
+            return a_live;
+        }
+        return head(a) != head(b) ? head(a) < head(b) : a < b;
+    };
+    LoserTree<decltype(beats)> tree(runs.size(), beats);
+    std::vector<std::pair<int, int>> output;
+    while (position[tree.winner()] < runs[tree.winner()].size()) {
+        const size_t winner = tree.winner();
+        output.push_back(runs[winner][position[winner]++]);
+        tree.replay(winner);
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(LoserTreeTest, MergesLikeAStableSort) {
+    std::mt19937 rng(8);
+    for (size_t run_count : {1, 2, 3, 7, 16, 33}) {
+        std::vector<std::vector<std::pair<int, int>>> runs(run_count);
+        std::vector<std::pair<int, int>> all;
+        int tag = 0;
+        for (auto& run : runs) {
+            const size_t length = rng() % 50; // some runs empty
+            for (size_t i = 0; i < length; ++i) {
+                run.emplace_back(static_cast<int>(rng() % 20), tag++);
+            }
+            std::stable_sort(run.begin(), run.end(), [](auto a, auto b) { return a.first < b.first; });
+            all.insert(all.end(), run.begin(), run.end());
+        }
+        std::stable_sort(all.begin(), all.end(), [](auto a, auto b) { return a.first < b.first; });
+        EXPECT_EQ(merge_runs(runs), all) << "runs=" << run_count;
+    }
+}
+
+TEST(LoserTreeTest, RejectsZeroSources) {
+    auto beats = [](size_t a, size_t b) { return a < b; };
+    EXPECT_THROW(LoserTree<decltype(beats)>(0, beats), std::invalid_argument);
+}
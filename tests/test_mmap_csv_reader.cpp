@@ -0,0 +1,231 @@
+//
+// Tests for the zero-copy MmapCsvReader.
+//
+
+#include "gtest/gtest.h"
+#include "mmap_csv_reader.hpp"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio> // For std::remove
+
+namespace {
+    std::string create_temp_mmap_csv_file(const std::string& content) {
+        static int counter_mmap = 0;
+        std::string filename = "test_mmap_csv_" + std::to_string(counter_mmap++) + ".csv";
+        std::ofstream outfile(filename, std::ios::binary);
+        if (!outfile) {
+            throw std::runtime_error("Failed to create temp file: " + filename);
+        }
+        outfile << content;
+        outfile.close();
+        return filename;
+    }
+}
+
+class MmapCsvReaderTest : public ::testing::Test {
+protected:
+    std::vector<std::string> temp_files_;
+
+    void TearDown() override {
+        for (const auto& file : temp_files_) {
+            std::remove(file.c_str());
+        }
+        temp_files_.clear();
+    }
+
+    std::string make_temp_file(const std::string& content) {
+        std::string filename = create_temp_mmap_csv_file(content);
+        temp_files_.push_back(filename);
+        return filename;
+    }
+};
+
+TEST_F(MmapCsvReaderTest, OpenNonExistentFile) {
+    EXPECT_THROW(MmapCsvReader reader("non_existent_file.csv"), std::runtime_error);
+}
+
+TEST_F(MmapCsvReaderTest, ReadSimpleCsv) {
+    std::string filename = make_temp_file("col1,col2,col3\nval1,val2,val3\n1,2,3");
+    MmapCsvReader reader(filename);
+    ASSERT_TRUE(reader.isOpen());
+
+    CsvRowView row;
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 3);
+    EXPECT_EQ(row[0], "col1");
+    EXPECT_EQ(row[2], "col3");
+
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 3);
+    EXPECT_EQ(row[1], "val2");
+
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 3);
+    EXPECT_EQ(row[0], "1");
+    EXPECT_EQ(row[2], "3");
+
+    EXPECT_FALSE(reader.readRow(row)); // EOF
+    EXPECT_FALSE(reader.isOpen());
+}
+
+TEST_F(MmapCsvReaderTest, ReadCsvWithQuotesAndEscapes) {
+    std::string filename = make_temp_file(
+        "name,description\n"
+        "\"Smith, John\",\"A person, with a comma\"\n"
+        "1,\"Hello, \"\"World\"\"!\"\n"
+        "\"\"\"a\"\"\",\"b\"\"\"\n");
+    MmapCsvReader reader(filename);
+
+    CsvRowView row;
+    ASSERT_TRUE(reader.readRow(row)); // Header
+
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[0], "Smith, John");
+    EXPECT_EQ(row[1], "A person, with a comma");
+
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[0], "1");
+    EXPECT_EQ(row[1], "Hello, \"World\"!");
+
+    // Two unescaped fields in the same row must both stay valid.
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[0], "\"a\"");
+    EXPECT_EQ(row[1], "b\"");
+}
+
+TEST_F(MmapCsvReaderTest, EscapedFieldsSurviveScratchGrowth) {
+    // Each escaped field is longer than all before it, so the scratch buffer keeps growing
+    // while earlier fields of the row are already parsed.
+    std::string record;
+    std::vector<std::string> expected;
+    for (size_t length = 1; length <= 4096; length *= 4) {
+        const std::string text(length, 'x');
+        record += (record.empty() ? "" : ",") + ("\"" + text + "\"\"\"");
+        expected.push_back(text + "\"");
+        record += ",plain";
+        expected.push_back("plain");
+    }
+    const std::string data = record + "\n" + record;
+    CsvViewReader reader(data);
+
+    CsvRowView row;
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(reader.readRow(row));
+        ASSERT_EQ(row.size(), expected.size());
+        for (size_t field = 0; field < expected.size(); ++field) {
+            EXPECT_EQ(row[field], expected[field]) << "field " << field;
+        }
+    }
+    EXPECT_FALSE(reader.readRow(row));
+}
+
+TEST_F(MmapCsvReaderTest, QuotedFieldWithEmbeddedNewline) {
+    std::string filename = make_temp_file("a,b\n\"Line with\nnewline char\",2\n3,4\n");
+    MmapCsvReader reader(filename);
+
+    CsvRowView row;
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[0], "Line with\nnewline char");
+    EXPECT_EQ(row[1], "2");
+
+    ASSERT_TRUE(reader.readRow(row));
+    EXPECT_EQ(row[0], "3");
+    EXPECT_FALSE(reader.readRow(row));
+}
+
+TEST_F(MmapCsvReaderTest, HandlesCrLfLineEndings) {
+    std::string filename = make_temp_file("a,\"b\"\r\n1,2\r\n");
+    MmapCsvReader reader(filename);
+
+    CsvRowView row;
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[1], "b");
+
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[1], "2");
+    EXPECT_FALSE(reader.readRow(row));
+}
+
+TEST_F(MmapCsvReaderTest, ReadEmptyFile) {
+    std::string filename = make_temp_file("");
+    MmapCsvReader reader(filename);
+    CsvRowView row;
+    EXPECT_FALSE(reader.readRow(row));
+    EXPECT_FALSE(reader.isOpen());
+}
+
+TEST_F(MmapCsvReaderTest, ReadFileWithEmptyLines) {
+    std::string filename = make_temp_file("a,b\n\n1,2\n");
+    MmapCsvReader reader(filename);
+
+    CsvRowView row;
+    ASSERT_TRUE(reader.readRow(row));
+    EXPECT_EQ(row[0], "a");
+
+    ASSERT_TRUE(reader.readRow(row)); // Empty line yields a single empty field, like CsvReader
+    ASSERT_EQ(row.size(), 1);
+    EXPECT_TRUE(row[0].empty());
+
+    ASSERT_TRUE(reader.readRow(row));
+    EXPECT_EQ(row[0], "1");
+    EXPECT_FALSE(reader.readRow(row));
+}
+
+TEST_F(MmapCsvReaderTest, DifferentDelimiter) {
+    std::string filename = make_temp_file("val1;val2\nval3;val4");
+    MmapCsvReader reader(filename, ';');
+
+    CsvRowView row;
+    ASSERT_TRUE(reader.readRow(row));
+    ASSERT_EQ(row.size(), 2);
+    EXPECT_EQ(row[0], "val1");
+    EXPECT_EQ(row[1], "val2");
+}
+
+TEST(SplitAtRecordBoundariesTest, SplitsOnlyBetweenRecords) {
+    std::string data;
+    for (int i = 0; i < 200; ++i) {
+        data += "\"row " + std::to_string(i) + "\",\"multi\nline \"\"field\"\"\",x\n";
+    }
+
+    for (size_t parts : {1u, 2u, 3u, 7u, 16u}) {
+        std::vector<size_t> splits = splitAtRecordBoundaries(data, parts);
+        ASSERT_EQ(splits.size(), parts + 1);
+        EXPECT_EQ(splits.front(), 0u);
+        EXPECT_EQ(splits.back(), data.size());
+
+        size_t rows = 0;
+        for (size_t i = 0; i < parts; ++i) {
+            ASSERT_LE(splits[i], splits[i + 1]);
+            CsvViewReader reader(std::string_view(data).substr(splits[i], splits[i + 1] - splits[i]));
+            CsvRowView row;
+            while (reader.readRow(row)) {
+                ASSERT_EQ(row.size(), 3u);
+                EXPECT_EQ(row[0], "row " + std::to_string(rows));
+                EXPECT_EQ(row[1], "multi\nline \"field\"");
+                ++rows;
+            }
+        }
+        EXPECT_EQ(rows, 200u);
+    }
+}
+
+TEST(SplitAtRecordBoundariesTest, HandlesTinyInputs) {
+    std::vector<size_t> splits = splitAtRecordBoundaries("", 4);
+    ASSERT_EQ(splits.size(), 5u);
+    for (size_t offset : splits) {
+        EXPECT_EQ(offset, 0u);
+    }
+
+    splits = splitAtRecordBoundaries("a,b\n", 8);
+    EXPECT_EQ(splits.front(), 0u);
+    EXPECT_EQ(splits.back(), 4u);
+}
@@ -0,0 +1,250 @@
+//
+// Tests for the permutation cache.
+//
+
+#include "gtest/gtest.h"
+#include "permutation_cache.hpp"
+#include "sorter_factory.hpp"
+#include "algorithms/merge_sorter.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Few distinct values in every column: many ties.
+std::vector<City> make_cities(size_t count, unsigned int seed) {
+    RandomCityOptions options;
+    options.distinct_names = 6;
+    options.distinct_countries = 4;
+    options.distinct_populations = 40;
+    options.distinct_coordinates = 1000;
+    return makeRandomCities(count, seed, options);
+}
+
+// An unstable sort that leaves ties in reverse row order, so stabilizing has work to do.
+struct CountingSort {
+    const std::vector<City>& cities;
+    size_t calls = 0;
+
+    Sorter::Permutation operator()(const CompositeKey& keys) {
+        ++calls;
+        Sorter::Permutation order = Sorter::identityPermutation(cities.size());
+        std::reverse(order.begin(), order.end());
+        std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return CompositeLess(keys, false)(cities[a], cities[b]);
+        });
+        return order;
+    }
+};
+
+Sorter::Permutation stable_order(const std::vector<City>& cities, const CompositeKey& keys, bool reverse) {
+    Sorter::Permutation order = Sorter::identityPermutation(cities.size());
+    const CompositeLess less(keys, reverse);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return less(cities[a], cities[b]); });
+    return order;
+}
+
+bool is_sorted_by(const std::vector<City>& cities, const Sorter::Permutation& order, const CompositeKey& keys,
+                  bool reverse) {
+    const CompositeLess less(keys, reverse);
+    return std::is_sorted(order.begin(), order.end(),
+                          [&](std::uint32_t a, std::uint32_t b) { return less(cities[a], cities[b]); });
+}
+
+std::string temp_cache_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() /
+            ("citysort-test-" + name + "-" + std::to_string(std::random_device{}()) + ".perm"))
+        .string();
+}
+
+} // namespace
+
+TEST(PermutationCacheTest, SortsOnceAndSharesMirroredKeys) {
+    const std::vector<City> cities = make_cities(600, 1);
+    PermutationCache cache(cities);
+    CountingSort sort{cities};
+    const auto sort_fn = [&sort](const CompositeKey& keys) { return sort(keys); };
+
+    const CompositeKey population = parseCompositeKey("population");
+    const Sorter::Permutation ascending = cache.get(population, false, false, sort_fn);
+    EXPECT_EQ(ascending.size(), cities.size());
+    EXPECT_TRUE(is_sorted_by(cities, ascending, population, false));
+    EXPECT_EQ(cache.get(population, false, false, sort_fn), ascending);
+
+    // "-r population" and "-population" are the same order, read from the end.
+    Sorter::Permutation reversed = ascending;
+    std::reverse(reversed.begin(), reversed.end());
+    EXPECT_EQ(cache.get(population, true, false, sort_fn), reversed);
+    EXPECT_EQ(cache.get(parseCompositeKey("-population"), false, false, sort_fn), reversed);
+    EXPECT_EQ(cache.get(parseCompositeKey("-population"), true, false, sort_fn), ascending);
+    EXPECT_EQ(sort.calls, 1u);
+
+    // Per-field directions mirror too: "country,-population" -r is "-country,population".
+    const CompositeKey mixed = parseCompositeKey("-country,population");
+    const Sorter::Permutation mixed_order = cache.get(mixed, false, false, sort_fn);
+    EXPECT_TRUE(is_sorted_by(cities, mixed_order, mixed, false));
+    EXPECT_EQ(cache.get(parseCompositeKey("country,-population"), true, false, sort_fn), mixed_order);
+    EXPECT_EQ(sort.calls, 2u);
+
+    const PermutationCache::Stats stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.hits, 5u);
+    EXPECT_EQ(stats.reversed_hits, 3u);
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_TRUE(cache.isModified());
+    EXPECT_EQ(cache.describeStats(), "5 hits (3 reversed), 2 misses, 0 stabilized, 2 entries (0 loaded)");
+}
+
+TEST(PermutationCacheTest, StableRequestsMatchAStableSort) {
+    const std::vector<City> cities = make_cities(900, 2);
+    PermutationCache cache(cities);
+    CountingSort sort{cities};
+    const auto sort_fn = [&sort](const CompositeKey& keys) { return sort(keys); };
+
+    for (const std::string key : {"name", "-population", "country,-name"}) {
+        const CompositeKey keys = parseCompositeKey(key);
+        for (bool reverse : {false, true}) {
+            EXPECT_EQ(cache.get(keys, reverse, true, sort_fn), stable_order(cities, keys, reverse)) << key;
+            for (size_t limit : {size_t{0}, size_t{1}, size_t{37}, cities.size() + 5}) {
+                Sorter::Permutation expected = stable_order(cities, keys, reverse);
+                expected.resize(std::min(limit, expected.size()));
+                EXPECT_EQ(cache.get(keys, reverse, true, sort_fn, limit), expected) << key << " " << limit;
+            }
+        }
+    }
+    EXPECT_EQ(sort.calls, 3u);
+    EXPECT_EQ(cache.getStats().stabilized, 3u); // once per entry
+
+    // Ties of the unstable order come out reversed until an entry is stabilized.
+    PermutationCache fresh(cities);
+    const CompositeKey name = parseCompositeKey("name");
+    EXPECT_NE(fresh.get(name, false, false, sort_fn), stable_order(cities, name, false));
+}
+
+TEST(PermutationCacheTest, StableSortersGetTheirOwnTieOrder) {
+    const std::vector<City> cities = make_cities(700, 6);
+    MergeSorter merge;
+    ASSERT_TRUE(merge.isStable());
+    PermutationCache cache(cities);
+    const auto sort_fn = [&](const CompositeKey& keys) { return merge.sortIndicesByKeys(cities, keys, false); };
+
+    for (const std::string key : {"population", "-name", "country,-population"}) {
+        const CompositeKey keys = parseCompositeKey(key);
+        for (bool reverse : {false, true}) {
+            const Sorter::Permutation uncached = merge.sortIndicesByKeys(cities, keys, reverse);
+            EXPECT_EQ(cache.get(keys, reverse, merge.isStable(), sort_fn), uncached) << key << " reverse=" << reverse;
+            EXPECT_EQ(cache.get(keys, !reverse, merge.isStable(), sort_fn),
+                      merge.sortIndicesByKeys(cities, keys, !reverse)) << key << " mirrored";
+        }
+    }
+}
+
+// The cache trusts isStable(): every sorter claiming it must match std::stable_sort.
+TEST(PermutationCacheTest, SortersClaimingStabilityAreStable) {
+    const std::vector<City> cities = make_cities(300, 7);
+    size_t stable_sorters = 0;
+    for (const std::string name : {"bubble", "insertion", "merge", "quick", "heap", "std", "radix", "multikey",
+                                   "blockquick", "pmerge", "samplesort", "tim", "heap4", "auto"}) {
+        std::unique_ptr<Sorter> sorter = SorterFactory::createSorter(name);
+        if (!sorter->isStable()) {
+            continue;
+        }
+        ++stable_sorters;
+        for (const std::string key : {"population", "name", "-lat", "country,-population"}) {
+            const CompositeKey keys = parseCompositeKey(key);
+            for (bool reverse : {false, true}) {
+                const Sorter::Permutation expected = stable_order(cities, keys, reverse);
+                EXPECT_EQ(sorter->sortIndicesByKeys(cities, keys, reverse), expected) << name << " " << key;
+                std::vector<City> rows = cities;
+                sorter->sortByKeys(rows, keys, reverse);
+                for (size_t i = 0; i < rows.size(); ++i) {
+                    ASSERT_EQ(rows[i].lat, cities[expected[i]].lat) << name << " " << key << " row " << i;
+                    ASSERT_EQ(rows[i].lng, cities[expected[i]].lng) << name << " " << key << " row " << i;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(stable_sorters, 6u); // bubble, insertion, merge, radix, pmerge, tim
+}
+
+TEST(PermutationCacheTest, SavesAndLoadsEntries) {
+    const std::vector<City> cities = make_cities(400, 3);
+    const std::string path = temp_cache_path("roundtrip");
+    CountingSort sort{cities};
+    const auto sort_fn = [&sort](const CompositeKey& keys) { return sort(keys); };
+
+    PermutationCache writer(cities);
+    EXPECT_EQ(writer.load(path), 0u); // no file yet
+    const Sorter::Permutation by_name = writer.get(parseCompositeKey("name"), true, true, sort_fn);
+    const Sorter::Permutation by_lat = writer.get(parseCompositeKey("lat,-country"), false, false, sort_fn);
+    writer.save(path);
+    EXPECT_FALSE(writer.isModified());
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    PermutationCache reader(cities);
+    EXPECT_EQ(reader.load(path), 2u);
+    EXPECT_FALSE(reader.isModified());
+    EXPECT_EQ(reader.get(parseCompositeKey("name"), true, true, sort_fn), by_name);
+    EXPECT_EQ(reader.get(parseCompositeKey("lat,-country"), false, false, sort_fn), by_lat);
+    EXPECT_EQ(sort.calls, 2u); // only the writer sorted
+    EXPECT_EQ(reader.getStats().stabilized, 0u); // the stable flag was saved
+    EXPECT_EQ(reader.getStats().loaded, 2u);
+
+    // A file for other data is ignored, not an error.
+    std::vector<City> changed = cities;
+    changed[123].population += 1;
+    PermutationCache other(changed);
+    EXPECT_NE(other.fingerprint(), reader.fingerprint());
+    EXPECT_EQ(other.load(path), 0u);
+    EXPECT_EQ(other.getStats().entries, 0u);
+
+    std::filesystem::remove(path);
+}
+
+TEST(PermutationCacheTest, RejectsCorruptFiles) {
+    const std::vector<City> cities = make_cities(200, 4);
+    const std::string path = temp_cache_path("corrupt");
+    CountingSort sort{cities};
+    const auto sort_fn = [&sort](const CompositeKey& keys) { return sort(keys); };
+    {
+        PermutationCache writer(cities);
+        writer.get(parseCompositeKey("population"), false, false, sort_fn);
+        writer.save(path);
+    }
+    const auto size = std::filesystem::file_size(path);
+
+    // A repeated row in the permutation: the last index is overwritten with the first.
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        std::uint32_t first = 0;
+        file.seekg(static_cast<std::streamoff>(size - cities.size() * sizeof(std::uint32_t)));
+        file.read(reinterpret_cast<char*>(&first), sizeof(first));
+        file.seekp(static_cast<std::streamoff>(size - sizeof(std::uint32_t)));
+        file.write(reinterpret_cast<const char*>(&first), sizeof(first));
+    }
+    PermutationCache duplicate(cities);
+    EXPECT_THROW(duplicate.load(path), std::runtime_error);
+
+    std::filesystem::resize_file(path, size - 10);
+    PermutationCache truncated(cities);
+    EXPECT_THROW(truncated.load(path), std::runtime_error);
+
+    { std::ofstream(path, std::ios::trunc) << "not a cache file at all, just some text"; }
+    PermutationCache text(cities);
+    EXPECT_THROW(text.load(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+TEST(PermutationCacheTest, RejectsASortOfTheWrongSize) {
+    const std::vector<City> cities = make_cities(50, 5);
+    PermutationCache cache(cities);
+    const auto short_sort = [](const CompositeKey&) { return Sorter::Permutation{0, 1, 2}; };
+    EXPECT_THROW(cache.get(parseCompositeKey("name"), false, false, short_sort), std::logic_error);
+    EXPECT_THROW(cache.get(CompositeKey{}, false, false, short_sort), std::invalid_argument);
+    EXPECT_EQ(cache.getStats().entries, 0u);
+}
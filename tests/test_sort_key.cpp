@@ -0,0 +1,36 @@
+//
+// Tests for sort key parsing and key comparators.
+//
+
+#include "gtest/gtest.h"
+#include "sort_key.hpp"
+#include "cli_parser.hpp"
+#include <stdexcept>
+
+TEST(SortKeyTest, ParsesEveryValidCliKey) {
+    for (const auto& name : CliParser::getValidKeys()) {
+        EXPECT_EQ(sortKeyName(parseSortKey(name)), name);
+    }
+    EXPECT_THROW(parseSortKey("elevation"), std::invalid_argument);
+}
+
+TEST(SortKeyTest, NumericKeys) {
+    EXPECT_TRUE(isNumericKey(SortKey::Population));
+    EXPECT_TRUE(isNumericKey(SortKey::Lat));
+    EXPECT_TRUE(isNumericKey(SortKey::Lng));
+    EXPECT_FALSE(isNumericKey(SortKey::Name));
+    EXPECT_FALSE(isNumericKey(SortKey::Country));
+}
+
+TEST(SortKeyTest, ComparatorsHonourDirection) {
+    City small{"Alpha", "Aland", -10.0, -20.0, 5};
+    City large{"Beta", "Brazil", 10.0, 20.0, 50};
+    for (SortKey key : {SortKey::Name, SortKey::Country, SortKey::Population, SortKey::Lat, SortKey::Lng}) {
+        auto ascending = createKeyComparator(key, false);
+        auto descending = createKeyComparator(key, true);
+        EXPECT_TRUE(ascending(small, large)) << sortKeyName(key);
+        EXPECT_FALSE(ascending(large, small)) << sortKeyName(key);
+        EXPECT_TRUE(descending(large, small)) << sortKeyName(key);
+        EXPECT_FALSE(ascending(small, small)) << sortKeyName(key);
+    }
+}
@@ -0,0 +1,244 @@
+//
+// Tests for the sort server, its client and the load generator.
+//
+
+#include "gtest/gtest.h"
+#include "sort_server.hpp"
+#include "composite_key.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::vector<City> make_cities(size_t count, unsigned int seed) {
+    RandomCityOptions options;
+    options.distinct_names = 1000;
+    options.distinct_countries = 20;
+    options.distinct_populations = 100000;
+    options.distinct_coordinates = 17987; // prime: coordinates that are not short decimals
+    return makeRandomCities(count, seed, options);
+}
+
+std::string temp_socket_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("citysort-test-" + name + "-" +
+                                                      std::to_string(std::random_device{}()) + ".sock"))
+        .string();
+}
+
+bool same_city(const City& a, const City& b) {
+    return a.name == b.name && a.country == b.country && a.population == b.population && a.lat == b.lat &&
+           a.lng == b.lng;
+}
+
+// Runs serve() on its own thread for the lifetime of the fixture object.
+struct RunningServer {
+    SortServer server;
+    std::thread thread;
+
+    RunningServer(const std::vector<City>& cities, const std::string& socket_path, unsigned int threads)
+        : server(cities, threads) {
+        server.listen(socket_path);
+        thread = std::thread([this] { server.serve(); });
+    }
+    ~RunningServer() {
+        server.stop();
+        thread.join();
+    }
+};
+
+} // namespace
+
+TEST(SortServerTest, ParsesAndFormatsQueries) {
+    SortQuery query = parseSortQuery("SORT key=country,-population order=desc limit=25 algo=radix");
+    EXPECT_EQ(query.key, "country,-population");
+    EXPECT_TRUE(query.reverse_order);
+    ASSERT_TRUE(query.limit.has_value());
+    EXPECT_EQ(*query.limit, 25u);
+    EXPECT_EQ(query.algorithm, "radix");
+    EXPECT_EQ(formatSortQuery(query), "SORT key=country,-population order=desc limit=25 algo=radix");
+
+    SortQuery defaults = parseSortQuery("SORT  key=name");
+    EXPECT_FALSE(defaults.reverse_order);
+    EXPECT_FALSE(defaults.limit.has_value());
+    EXPECT_EQ(defaults.algorithm, "auto");
+    EXPECT_EQ(parseSortQuery(formatSortQuery(defaults)).key, "name");
+
+    for (const std::string bad : {"", "PING", "SORT", "SORT order=asc", "SORT key=height", "SORT key=name order=up",
+                                  "SORT key=name limit=0", "SORT key=name limit=x", "SORT key=name algo=",
+                                  "SORT key=name colour=red", "SORT key=name desc"}) {
+        EXPECT_THROW(parseSortQuery(bad), std::invalid_argument) << bad;
+    }
+}
+
+TEST(SortServerTest, HandlesRequestsWithoutASocket) {
+    const std::vector<City> cities = make_cities(500, 1);
+    SortServer server(cities, 2);
+
+    EXPECT_EQ(server.handleRequest("PING"), "PONG\n");
+    EXPECT_EQ(server.handleRequest("QUIT"), "BYE\n");
+    EXPECT_EQ(server.handleRequest("FETCH everything").compare(0, 4, "ERR "), 0);
+    EXPECT_EQ(server.handleRequest("SORT key=name algo=nonsense").compare(0, 4, "ERR "), 0);
+
+    const std::string reply = server.handleRequest("SORT key=population order=desc limit=3\r");
+    ASSERT_EQ(reply.compare(0, 20, "OK rows=3 total=500 "), 0) << reply;
+    EXPECT_NE(reply.find(" algo=top-k "), std::string::npos);
+    EXPECT_EQ(std::count(reply.begin(), reply.end(), '\n'), 4);
+
+    const std::string full = server.handleRequest("SORT key=lat algo=auto");
+    EXPECT_NE(full.find(" algo=auto:"), std::string::npos) << full.substr(0, full.find('\n'));
+    EXPECT_EQ(std::count(full.begin(), full.end(), '\n'), 501);
+
+    const SortServer::Stats stats = server.getStats();
+    EXPECT_EQ(stats.queries, 2u);
+    EXPECT_EQ(stats.errors, 2u);
+    EXPECT_EQ(server.handleRequest("STATS"), "STATS connections=0 queries=2 errors=2\n");
+}
+
+TEST(SortServerTest, AnswersRepeatedQueriesFromThePermutationCache) {
+    const std::vector<City> cities = make_cities(800, 7);
+    PermutationCache cache(cities);
+    SortServer server(cities, 2);
+    server.setPermutationCache(&cache);
+
+    const std::string first = server.handleRequest("SORT key=population algo=merge");
+    EXPECT_NE(first.find(" algo=merge "), std::string::npos) << first.substr(0, first.find('\n'));
+    const std::string mirrored = server.handleRequest("SORT key=-population order=desc algo=merge");
+    EXPECT_NE(mirrored.find(" algo=cache "), std::string::npos);
+    // Without the OK line (its us= differs), the mirrored query returns the same rows.
+    EXPECT_EQ(first.substr(first.find('\n')), mirrored.substr(mirrored.find('\n')));
+
+    // A limited query gets the stable order selectTopK() would return.
+    const std::string top = server.handleRequest("SORT key=population order=desc limit=30");
+    ASSERT_EQ(top.compare(0, 21, "OK rows=30 total=800 "), 0) << top;
+    EXPECT_NE(top.find(" algo=cache "), std::string::npos);
+    const std::string uncached = SortServer(cities, 1).handleRequest("SORT key=population order=desc limit=30");
+    EXPECT_EQ(top.substr(top.find('\n')), uncached.substr(uncached.find('\n')));
+
+    EXPECT_EQ(server.handleRequest("STATS"), "STATS connections=0 queries=3 errors=0 cache_hits=2 cache_misses=1\n");
+}
+
+TEST(SortServerTest, AnswersQueriesOverTheSocket) {
+    std::vector<City> cities = make_cities(3000, 2);
+    cities[7].name = "Tab\tand\nnewline";
+    const std::string socket_path = temp_socket_path("answers");
+    RunningServer running(cities, socket_path, 2);
+    SortClient client(socket_path);
+
+    EXPECT_EQ(client.request("PING"), "PONG");
+    for (const std::string key : {"population", "name", "-lat,country", "country,-population"}) {
+        for (bool reverse : {false, true}) {
+            for (std::optional<size_t> limit : {std::optional<size_t>(), std::optional<size_t>(40)}) {
+                SortQuery query;
+                query.key = key;
+                query.reverse_order = reverse;
+                query.limit = limit;
+                query.algorithm = "merge"; // stable, so the rows are fully determined
+                const SortReply reply = client.query(query);
+
+                std::vector<City> expected = cities;
+                std::stable_sort(expected.begin(), expected.end(), CompositeLess(parseCompositeKey(key), reverse));
+                expected.resize(limit.value_or(expected.size()));
+                EXPECT_EQ(reply.total_rows, cities.size());
+                EXPECT_EQ(reply.algorithm, limit ? "top-k" : "merge");
+                ASSERT_EQ(reply.rows.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); ++i) {
+                    if (expected[i].name == cities[7].name) {
+                        expected[i].name = "Tab and newline";
+                    }
+                    ASSERT_TRUE(same_city(reply.rows[i], expected[i])) << key << " row " << i;
+                }
+            }
+        }
+    }
+
+    SortQuery bad;
+    bad.key = "name";
+    bad.algorithm = "nonsense";
+    EXPECT_THROW(client.query(bad), std::runtime_error);
+    EXPECT_EQ(client.request("PING"), "PONG"); // still usable after an error
+    EXPECT_EQ(client.request("QUIT"), "BYE");
+    EXPECT_THROW(client.request("PING"), std::runtime_error);
+}
+
+TEST(SortServerTest, LoadGeneratorRunsConcurrentClients) {
+    const std::vector<City> cities = make_cities(2000, 3);
+    const std::string socket_path = temp_socket_path("load");
+    RunningServer running(cities, socket_path, 2);
+
+    std::vector<SortQuery> queries(2);
+    queries[0].key = "population";
+    queries[0].limit = 5;
+    queries[1].key = "name";
+    queries[1].reverse_order = true;
+    const LoadReport report = runLoadGenerator(socket_path, queries, 4, 50);
+    EXPECT_EQ(report.requests, 50u);
+    EXPECT_EQ(report.errors, 0u);
+    EXPECT_GT(report.throughput, 0.0);
+    EXPECT_LE(report.p50_ms, report.p99_ms);
+    EXPECT_LE(report.p99_ms, report.max_ms);
+    EXPECT_EQ(running.server.getStats().queries, 50u);
+    EXPECT_EQ(running.server.getStats().connections, 4u);
+
+    const LoadReport unreachable = runLoadGenerator(socket_path + ".missing", queries, 2, 10);
+    EXPECT_EQ(unreachable.requests, 0u);
+    EXPECT_EQ(unreachable.errors, 10u);
+    EXPECT_THROW(runLoadGenerator(socket_path, {}, 1, 1), std::invalid_argument);
+}
+
+TEST(SortServerTest, ShutdownRequestStopsTheServer) {
+    const std::vector<City> cities = make_cities(100, 4);
+    const std::string socket_path = temp_socket_path("shutdown");
+    SortServer server(cities, 1);
+    server.listen(socket_path);
+
+    SortServer second(cities, 1);
+    EXPECT_THROW(second.listen(socket_path), std::runtime_error); // in use by a live server
+
+    std::thread serving([&server] { server.serve(); });
+    SortClient idle(socket_path); // open, but never sends: must not keep the server up
+    SortClient client(socket_path);
+    EXPECT_EQ(client.request("SHUTDOWN"), "BYE");
+    serving.join();
+    EXPECT_THROW(idle.request("PING"), std::runtime_error);
+}
+
+TEST(SortServerTest, ReplacesAStaleSocketFile) {
+    const std::vector<City> cities = make_cities(100, 5);
+    const std::string socket_path = temp_socket_path("stale");
+    {
+        SortServer stopped(cities, 1);
+        stopped.listen(socket_path);
+    }
+    EXPECT_FALSE(std::filesystem::exists(socket_path)); // removed by the destructor
+
+    // What a killed server leaves behind: a socket file nobody listens on.
+    const int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(::bind(stale, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    ::close(stale);
+    ASSERT_TRUE(std::filesystem::exists(socket_path));
+
+    RunningServer restarted(cities, socket_path, 1);
+    EXPECT_EQ(SortClient(socket_path).request("PING"), "PONG");
+}
+
+TEST(SortServerTest, RefusesAPathThatIsNotASocket) {
+    const std::string file_path = temp_socket_path("file");
+    { std::ofstream(file_path) << "data"; }
+    const std::vector<City> cities = make_cities(10, 6);
+    SortServer server(cities, 1);
+    EXPECT_THROW(server.listen(file_path), std::runtime_error);
+    EXPECT_TRUE(std::filesystem::exists(file_path)); // left alone
+    std::filesystem::remove(file_path);
+}
@@ -0,0 +1,124 @@
+//
+// Tests for the sorting-network kernels and the sorters that use them as a base case.
+//
+
+#include "gtest/gtest.h"
+#include "sorting_network.hpp"
+#include "sorter.hpp"
+#include "sorter_factory.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+std::vector<SmallSortKernel> available_kernels() {
+    std::vector<SmallSortKernel> kernels;
+    for (SmallSortKernel kernel :
+         {SmallSortKernel::Insertion, SmallSortKernel::ScalarNetwork, SmallSortKernel::Avx2Network}) {
+        if (isSmallSortKernelAvailable(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+// Keys from a small set (many ties), including the extremes of the key range.
+std::vector<PackedRow> make_rows(size_t count, std::mt19937& rng) {
+    const std::vector<std::uint64_t> pool = {0, 1, 2, 0x7FFFFFFFFFFFFFFFull, 0x8000000000000000ull, 12345678901234ull,
+                                             std::numeric_limits<std::uint64_t>::max() - 1,
+                                             std::numeric_limits<std::uint64_t>::max()};
+    std::vector<PackedRow> rows(count);
+    for (size_t i = 0; i < count; ++i) {
+        rows[i].key = pool[rng() % pool.size()];
+        rows[i].index = static_cast<std::uint32_t>(i);
+    }
+    std::shuffle(rows.begin(), rows.end(), rng); // indices out of order too
+    return rows;
+}
+
+bool row_less(const PackedRow& a, const PackedRow& b) {
+    return a.key < b.key || (a.key == b.key && a.index < b.index);
+}
+
+bool same_rows(const std::vector<PackedRow>& a, const std::vector<PackedRow>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const PackedRow& x, const PackedRow& y) {
+        return x.key == y.key && x.index == y.index;
+    });
+}
+
+} // namespace
+
+TEST(SortingNetworkTest, PortableKernelsAreAlwaysAvailable) {
+    EXPECT_TRUE(isSmallSortKernelAvailable(SmallSortKernel::Insertion));
+    EXPECT_TRUE(isSmallSortKernelAvailable(SmallSortKernel::ScalarNetwork));
+    EXPECT_TRUE(isSmallSortKernelAvailable(activeSmallSortKernel()));
+    if (!isSmallSortKernelAvailable(SmallSortKernel::Avx2Network)) {
+        PackedRow row{1, 0};
+        EXPECT_THROW(sortSmallPackedRowsWith(SmallSortKernel::Avx2Network, &row, 1), std::invalid_argument);
+    }
+}
+
+TEST(SortingNetworkTest, EveryKernelSortsByKeyThenIndex) {
+    std::mt19937 rng(22);
+    for (SmallSortKernel kernel : available_kernels()) {
+        for (size_t count = 0; count <= SMALL_SORT_MAX + 40; ++count) {
+            for (int round = 0; round < 4; ++round) {
+                std::vector<PackedRow> rows = make_rows(count, rng);
+                std::vector<PackedRow> expected = rows;
+                std::sort(expected.begin(), expected.end(), row_less);
+                sortSmallPackedRowsWith(kernel, rows.data(), rows.size());
+                ASSERT_TRUE(same_rows(rows, expected)) << "kernel " << static_cast<int>(kernel) << " n=" << count;
+            }
+        }
+    }
+}
+
+TEST(SortingNetworkTest, SortsOnlyTheGivenRange) {
+    std::mt19937 rng(7);
+    std::vector<PackedRow> rows = make_rows(40, rng);
+    const std::vector<PackedRow> original = rows;
+    sortSmallPackedRows(rows.data() + 10, 20);
+    EXPECT_TRUE(std::is_sorted(rows.begin() + 10, rows.begin() + 30, row_less));
+    EXPECT_TRUE(std::equal(rows.begin(), rows.begin() + 10, original.begin(),
+                           [](const PackedRow& a, const PackedRow& b) { return a.index == b.index; }));
+    EXPECT_TRUE(std::equal(rows.begin() + 30, rows.end(), original.begin() + 30,
+                           [](const PackedRow& a, const PackedRow& b) { return a.index == b.index; }));
+}
+
+TEST(SortingNetworkTest, NetworkBaseCasesKeepNumericSortsStable) {
+    // Few distinct values: the leaves are full of ties.
+    std::mt19937 rng(3);
+    std::vector<City> cities(3000);
+    for (City& city : cities) {
+        city.population = static_cast<long>(rng() % 13) - 6;
+        city.lat = static_cast<double>(rng() % 9) * 0.5;
+    }
+    for (SortKey key : {SortKey::Population, SortKey::Lat}) {
+        for (bool reverse : {false, true}) {
+            Sorter::Permutation expected = Sorter::identityPermutation(cities.size());
+            auto less = createKeyComparator(key, reverse);
+            std::stable_sort(expected.begin(), expected.end(),
+                             [&](std::uint32_t a, std::uint32_t b) { return less(cities[a], cities[b]); });
+            for (size_t size : {size_t{5}, size_t{100}, cities.size()}) {
+                std::vector<City> subset(cities.begin(), cities.begin() + static_cast<long>(size));
+                Sorter::Permutation subset_expected;
+                for (std::uint32_t row : expected) {
+                    if (row < size) {
+                        subset_expected.push_back(row);
+                    }
+                }
+                for (const std::string algo : {"merge", "radix"}) {
+                    EXPECT_EQ(SorterFactory::createSorter(algo)->sortIndicesByKey(subset, key, reverse), subset_expected)
+                        << algo << " " << sortKeyName(key) << " n=" << size;
+                }
+                for (const std::string algo : {"quick", "blockquick"}) {
+                    std::vector<City> sorted = subset;
+                    SorterFactory::createSorter(algo)->sortByKey(sorted, key, reverse);
+                    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), less)) << algo << " n=" << size;
+                }
+            }
+        }
+    }
+}
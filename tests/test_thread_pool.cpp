@@ -0,0 +1,57 @@
+//
+// Tests for the work-stealing thread pool and task groups.
+//
+
+#include "gtest/gtest.h"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+
+// Naive recursive fork/join sum over [begin, end): exercises nested TaskGroups.
+long long parallel_range_sum(ThreadPool& pool, long long begin, long long end) {
+    if (end - begin <= 64) {
+        long long sum = 0;
+        for (long long i = begin; i < end; ++i) sum += i;
+        return sum;
+    }
+    const long long mid = begin + (end - begin) / 2;
+    long long left = 0;
+    TaskGroup group(pool);
+    group.run([&] { left = parallel_range_sum(pool, begin, mid); });
+    long long right = parallel_range_sum(pool, mid, end);
+    group.wait();
+    return left + right;
+}
+
+} // namespace
+
+TEST(ThreadPoolTest, RunsEveryTaskOfAGroup) {
+    for (unsigned int threads : {1u, 2u, 4u}) {
+        ThreadPool pool(threads);
+        EXPECT_EQ(pool.threadCount(), threads);
+        std::atomic<int> counter{0};
+        TaskGroup group(pool);
+        for (int i = 0; i < 1000; ++i) {
+            group.run([&counter] { counter.fetch_add(1); });
+        }
+        group.wait();
+        EXPECT_EQ(counter.load(), 1000);
+    }
+}
+
+TEST(ThreadPoolTest, NestedForkJoinDoesNotDeadlock) {
+    for (unsigned int threads : {1u, 3u, 8u}) {
+        ThreadPool pool(threads);
+        EXPECT_EQ(parallel_range_sum(pool, 0, 100000), 100000LL * 99999 / 2);
+    }
+}
+
+TEST(ThreadPoolTest, WaitRethrowsTaskException) {
+    ThreadPool pool(2);
+    TaskGroup group(pool);
+    group.run([] { throw std::runtime_error("task failed"); });
+    group.run([] {});
+    EXPECT_THROW(group.wait(), std::runtime_error);
+}
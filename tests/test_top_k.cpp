@@ -0,0 +1,51 @@
+//
+// Tests for top-K row selection.
+//
+
+#include "gtest/gtest.h"
+#include "top_k.hpp"
+#include "algorithms/sorter_test_utils.hpp"
+#include <algorithm>
+
+namespace {
+
+// Few distinct names and populations: many ties.
+std::vector<City> make_tied_cities(size_t count, unsigned int seed) {
+    RandomCityOptions options;
+    options.distinct_names = 25;
+    options.distinct_populations = 51;
+    return makeRandomCities(count, seed, options);
+}
+
+// The first k rows of a stable full sort.
+Sorter::Permutation stable_prefix(const std::vector<City>& cities, SortKey key, bool reverse, size_t k) {
+    Sorter::Permutation order = Sorter::identityPermutation(cities.size());
+    auto comparator = createKeyComparator(key, reverse);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return comparator(cities[a], cities[b]); });
+    order.resize(std::min(k, order.size()));
+    return order;
+}
+
+} // namespace
+
+TEST(TopKTest, MatchesStableSortPrefixForEveryStrategy) {
+    const std::vector<City> cities = make_tied_cities(5000, 21);
+    for (TopKStrategy strategy : {TopKStrategy::Auto, TopKStrategy::Heap, TopKStrategy::NthElement}) {
+        for (SortKey key : {SortKey::Population, SortKey::Name}) {
+            for (bool reverse : {false, true}) {
+                for (size_t k : {1, 20, 312, 4999, 5000}) {
+                    EXPECT_EQ(selectTopK(cities, key, reverse, k, strategy), stable_prefix(cities, key, reverse, k))
+                        << "k=" << k << " reverse=" << reverse;
+                }
+            }
+        }
+    }
+}
+
+TEST(TopKTest, ClampsKToDatasetSize) {
+    const std::vector<City> cities = make_tied_cities(10, 4);
+    EXPECT_EQ(selectTopK(cities, SortKey::Name, false, 100).size(), 10);
+    EXPECT_TRUE(selectTopK(cities, SortKey::Name, false, 0).empty());
+    EXPECT_TRUE(selectTopK({}, SortKey::Lat, true, 5).empty());
+}